@@ -0,0 +1,255 @@
+/**
+ * Benchmarks for the read paths of RobotStateInformer. A writer thread feeds synthetic joint states and a world to
+ * pelvis transform at 1 kHz while 1, 4 and 16 reader threads query the state. ROS master is not required, the
+ * subscribers of RobotStateInformer simply fail to register.
+ *
+ * rosrun tough_common tough_common_benchmarks --benchmark_repetitions=5
+ */
+#include <benchmark/benchmark.h>
+#include <ros/master.h>
+#include <tough_common/robot_state.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+const size_t NUM_JOINTS = 40;
+const int QUERY_JOINT = 17;
+const size_t NUM_POINTS = 1000;
+const std::string PELVIS_FRAME = "pelvis";
+const std::string WORLD_FRAME = "world";
+
+std::string jointName(const size_t index)
+{
+  return "joint_" + std::to_string(index);
+}
+}  // namespace
+
+/**
+ * @brief RobotStateInformer that takes its input from the benchmark instead of the subscribers
+ */
+class BenchmarkStateInformer : public RobotStateInformer
+{
+public:
+  explicit BenchmarkStateInformer(ros::NodeHandle nh) : RobotStateInformer(nh)
+  {
+  }
+
+  void feedJointState(const sensor_msgs::JointState::Ptr msg)
+  {
+    jointStateCB(msg);
+  }
+
+  void feedTransform(const tf::StampedTransform& transform)
+  {
+    listener_.setTransform(transform, "benchmark");
+  }
+};
+
+namespace
+{
+BenchmarkStateInformer* stateInformer = nullptr;
+}  // namespace
+
+/**
+ * @brief Publishes synthetic joint states and pelvis transform at 1 kHz through BenchmarkStateInformer, the same way
+ * the subscriber would.
+ */
+class RobotStateBenchmarkFeed
+{
+public:
+  explicit RobotStateBenchmarkFeed(BenchmarkStateInformer* stateInformer) : stateInformer_(stateInformer), running_(false)
+  {
+  }
+
+  void start()
+  {
+    // readers should never see an empty state
+    write(0);
+    running_ = true;
+    thread_ = std::thread(&RobotStateBenchmarkFeed::run, this);
+  }
+
+  void stop()
+  {
+    running_ = false;
+    thread_.join();
+  }
+
+private:
+  BenchmarkStateInformer* stateInformer_;
+  std::atomic<bool> running_;
+  std::thread thread_;
+
+  void run()
+  {
+    const std::chrono::microseconds period(1000);
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+    for (uint32_t seq = 1; running_; ++seq)
+    {
+      write(seq);
+      next += period;
+      std::this_thread::sleep_until(next);
+    }
+  }
+
+  void write(const uint32_t seq)
+  {
+    // a new message every time, like the subscriber. Readers may still hold the previous one.
+    sensor_msgs::JointState::Ptr msg(new sensor_msgs::JointState());
+    msg->header.seq = seq;
+    msg->header.stamp = ros::Time::now();
+    for (size_t i = 0; i < NUM_JOINTS; ++i)
+    {
+      msg->name.push_back(jointName(i));
+      msg->position.push_back(std::sin(seq * 0.001 + i));
+      msg->velocity.push_back(std::cos(seq * 0.001 + i));
+      msg->effort.push_back(0.1 * i);
+    }
+    stateInformer_->feedJointState(msg);
+
+    tf::Transform pelvis(tf::createQuaternionFromYaw(seq * 0.001), tf::Vector3(seq * 0.0001, 0.0, 1.0));
+    stateInformer_->feedTransform(tf::StampedTransform(pelvis, msg->header.stamp, WORLD_FRAME, PELVIS_FRAME));
+  }
+};
+
+static void BM_GetJointPositionByName(benchmark::State& state)
+{
+  const std::string name = jointName(QUERY_JOINT);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(stateInformer->getJointPosition(name));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_GetJointPositionByIndex(benchmark::State& state)
+{
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(stateInformer->getJointPosition(QUERY_JOINT));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_JointHandleGetPosition(benchmark::State& state)
+{
+  JointHandle handle = stateInformer->getJointHandle(jointName(QUERY_JOINT));
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(handle.getPosition());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_JointGroupHandleGetPositions(benchmark::State& state)
+{
+  // same size as an arm
+  std::vector<std::string> names;
+  for (size_t i = 0; i < 7; ++i)
+  {
+    names.push_back(jointName(10 + i));
+  }
+  JointGroupHandle handle = stateInformer->getJointGroupHandle(names);
+  std::vector<double> positions;
+  for (auto _ : state)
+  {
+    handle.getPositions(positions);
+    benchmark::DoNotOptimize(positions.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_GetJointPositions(benchmark::State& state)
+{
+  std::vector<double> positions;
+  for (auto _ : state)
+  {
+    stateInformer->getJointPositions(positions);
+    benchmark::DoNotOptimize(positions.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_GetJointStateMessage(benchmark::State& state)
+{
+  sensor_msgs::JointState jointState;
+  for (auto _ : state)
+  {
+    stateInformer->getJointStateMessage(jointState);
+    benchmark::DoNotOptimize(jointState.position.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_GetTransform(benchmark::State& state)
+{
+  tf::StampedTransform transform;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(stateInformer->getTransform(PELVIS_FRAME, transform, WORLD_FRAME, false));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_TransformPoint(benchmark::State& state)
+{
+  geometry_msgs::Point in, out;
+  in.x = 1.0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(stateInformer->transformPoint(in, out, PELVIS_FRAME, WORLD_FRAME, false));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_TransformPointsBatch(benchmark::State& state)
+{
+  std::vector<geometry_msgs::Point> in(NUM_POINTS), out;
+  for (size_t i = 0; i < NUM_POINTS; ++i)
+  {
+    in[i].x = 0.001 * i;
+  }
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(stateInformer->transformPoints(in, out, PELVIS_FRAME, WORLD_FRAME, false));
+  }
+  state.SetItemsProcessed(state.iterations() * NUM_POINTS);
+}
+
+#define STATE_BENCHMARK(name) BENCHMARK(name)->Threads(1)->Threads(4)->Threads(16)->UseRealTime()
+
+STATE_BENCHMARK(BM_GetJointPositionByName);
+STATE_BENCHMARK(BM_GetJointPositionByIndex);
+STATE_BENCHMARK(BM_JointHandleGetPosition);
+STATE_BENCHMARK(BM_JointGroupHandleGetPositions);
+STATE_BENCHMARK(BM_GetJointPositions);
+STATE_BENCHMARK(BM_GetJointStateMessage);
+STATE_BENCHMARK(BM_GetTransform);
+STATE_BENCHMARK(BM_TransformPoint);
+STATE_BENCHMARK(BM_TransformPointsBatch);
+
+int main(int argc, char** argv)
+{
+  ros::init(argc, argv, "tough_common_benchmarks", ros::init_options::AnonymousName | ros::init_options::NoRosout);
+  // without a master, registration of publishers and subscribers gives up quickly instead of blocking
+  ros::master::setRetryTimeout(ros::WallDuration(0.01));
+  ros::NodeHandle nh;
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+  {
+    return 1;
+  }
+
+  BenchmarkStateInformer informer(nh);
+  stateInformer = &informer;
+  RobotStateBenchmarkFeed feed(stateInformer);
+  feed.start();
+  benchmark::RunSpecifiedBenchmarks();
+  feed.stop();
+
+  return 0;
+}
@@ -0,0 +1,92 @@
+#ifndef TOUGH_CALLBACK_LIST_H
+#define TOUGH_CALLBACK_LIST_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+/**
+ * @brief CallbackList stores functions called from a sensor callback. The list is replaced atomically when a function
+ * is added or removed, so calling the functions does not lock and does not allocate.
+ *
+ * A function that is removed may still be running in another thread when remove returns.
+ */
+template <typename... Args>
+class CallbackList
+{
+public:
+  typedef std::function<void(Args...)> Callback;
+
+  CallbackList() : next_(0)
+  {
+  }
+
+  // disable assign and copy
+  CallbackList(CallbackList const&) = delete;
+  void operator=(CallbackList const&) = delete;
+
+  /**
+   * @brief Add a function to the list
+   *
+   * @param callback          function to call
+   * @return int              handle used to remove the function
+   */
+  int add(const Callback& callback)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    std::shared_ptr<CallbackMap> callbacks(new CallbackMap());
+    std::shared_ptr<const CallbackMap> current = std::atomic_load(&callbacks_);
+    if (current)
+    {
+      *callbacks = *current;
+    }
+    const int handle = next_++;
+    (*callbacks)[handle] = callback;
+    std::atomic_store(&callbacks_, std::shared_ptr<const CallbackMap>(callbacks));
+    return handle;
+  }
+
+  /**
+   * @brief Remove a function from the list. Unknown handles are ignored.
+   *
+   * @param handle            handle returned by add
+   */
+  void remove(const int handle)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    std::shared_ptr<const CallbackMap> current = std::atomic_load(&callbacks_);
+    if (!current || current->find(handle) == current->end())
+    {
+      return;
+    }
+    std::shared_ptr<CallbackMap> callbacks(new CallbackMap(*current));
+    callbacks->erase(handle);
+    std::atomic_store(&callbacks_, callbacks->empty() ? std::shared_ptr<const CallbackMap>() :
+                                                        std::shared_ptr<const CallbackMap>(callbacks));
+  }
+
+  /**
+   * @brief Call all the functions in the order they were added
+   */
+  void call(Args... args) const
+  {
+    std::shared_ptr<const CallbackMap> callbacks = std::atomic_load(&callbacks_);
+    if (!callbacks)
+    {
+      return;
+    }
+    for (const auto& callback : *callbacks)
+    {
+      callback.second(args...);
+    }
+  }
+
+private:
+  typedef std::map<int, Callback> CallbackMap;
+  std::shared_ptr<const CallbackMap> callbacks_;
+  std::mutex mutex_;
+  int next_;
+};
+
+#endif  // TOUGH_CALLBACK_LIST_H
@@ -0,0 +1,182 @@
+#ifndef TOUGH_COMMAND_TRACER_H
+#define TOUGH_COMMAND_TRACER_H
+
+#include <sensor_msgs/JointState.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "tough_common/topic_statistics.h"
+#include "tough_common/joint_handle.h"
+
+/**
+ * @brief Latency statistics of one type of command. All the values are in seconds.
+ */
+struct CommandLatencySummary
+{
+  std::string type;
+  uint64_t published;              // number of traced commands that were published
+  uint64_t withoutMotion;          // published commands for which no motion was seen before the trace expired
+  HistogramSummary construction;   // start of message construction -> publish
+  HistogramSummary acknowledgement;  // publish -> acknowledgement from the controller, e.g. footstep status
+  HistogramSummary motionOnset;    // publish -> first joint state that moved away from the state at publish
+  HistogramSummary endToEnd;       // start of message construction -> first motion
+};
+
+/**
+ * @brief CommandTracer measures the latency of commands sent to the controller, from the construction of the message
+ * to the first motion of the robot. Commands are identified by a type, e.g. "arm_trajectory", and their unique_id.
+ * Latencies are recorded in one histogram per type of command and published with the diagnostics of
+ * RobotStateInformer.
+ *
+ * A trace starts when a message is published. The start of its construction is either given to recordPublish or
+ * recorded beforehand with recordConstruction, for messages that are built and published in different functions.
+ * Recorded constructions are not traces, they do not cost anything per joint state and are dropped when the message
+ * is not published within TRACE_TIMEOUT seconds.
+ *
+ * Motion onset is detected from the joint states received by RobotStateInformer: the first joint state after the
+ * publish is the reference, and motion starts when any of the joints of the command moves further than the motion
+ * threshold from it. Joints are read through a JointGroupHandle resolved once per trace. Traces without motion expire
+ * after TRACE_TIMEOUT seconds.
+ *
+ * Every method can be called from any thread. Joint states are ignored without locking while there is no published
+ * trace.
+ */
+class CommandTracer
+{
+public:
+  static constexpr double TRACE_TIMEOUT = 30.0;
+  static const size_t MAX_CONSTRUCTIONS = 1000;
+
+  typedef std::chrono::steady_clock Clock;
+
+  /**
+   * @brief Get the CommandTracer object, shared by the whole process
+   *
+   * @return CommandTracer*
+   */
+  static CommandTracer* getCommandTracer();
+
+  // disable assign and copy
+  CommandTracer(CommandTracer const&) = delete;
+  void operator=(CommandTracer const&) = delete;
+
+  /**
+   * @brief Record the start of the construction of a message that is published by another function. Only call it for
+   * messages that are published, see recordPublish to pass the construction time directly.
+   *
+   * @param type              type of the command
+   * @param uniqueId          unique id of the message
+   */
+  void recordConstruction(const std::string& type, const long uniqueId);
+
+  /**
+   * @brief Record the publish of a message and start its trace. Construction and end to end latencies are recorded
+   * only when the start of the construction is known.
+   *
+   * @param type              type of the command
+   * @param uniqueId          unique id of the message
+   * @param jointNames        joints moved by the command, all the joints when it is empty
+   * @param constructionTime  start of the construction of the message. When it is not set, the time recorded by
+   *                          recordConstruction is used if there is one.
+   */
+  void recordPublish(const std::string& type, const long uniqueId,
+                     const std::vector<std::string>& jointNames = std::vector<std::string>(),
+                     const Clock::time_point constructionTime = Clock::time_point());
+
+  /**
+   * @brief Record the acknowledgement of a published message by the controller. Only the first one is recorded.
+   *
+   * @param type              type of the command
+   * @param uniqueId          unique id of the message
+   */
+  void recordAcknowledgement(const std::string& type, const long uniqueId);
+
+  /**
+   * @brief Check the active traces for motion. Called by RobotStateInformer for every joint state, after the joint
+   * state is stored.
+   *
+   * @param stateInformer     informer that received the joint state, used to read the joints of the traces
+   * @param msg               joint state received from the controller
+   */
+  void recordJointState(RobotStateInformer* stateInformer, const sensor_msgs::JointState& msg);
+
+  /**
+   * @brief Set the distance a joint has to move to detect the motion onset
+   *
+   * @param threshold         radians for revolute joints, meters for prismatic joints
+   */
+  void setMotionThreshold(const double threshold);
+
+  /**
+   * @brief Get the latency statistics of all the types of commands
+   *
+   * @param summaries         [output]
+   */
+  void getLatencySummaries(std::vector<CommandLatencySummary>& summaries) const;
+
+  /**
+   * @brief Get the latency statistics of a type of command
+   *
+   * @param type              type of the command
+   * @param summary           [output]
+   * @return true             when commands of this type were traced
+   * @return false
+   */
+  bool getLatencySummary(const std::string& type, CommandLatencySummary& summary) const;
+
+  /**
+   * @brief Remove the active traces and the recorded statistics
+   */
+  void reset();
+
+private:
+  CommandTracer();
+
+  typedef std::pair<std::string, long> TraceKey;
+
+  struct TypeStatistics
+  {
+    std::atomic<uint64_t> published;
+    std::atomic<uint64_t> withoutMotion;
+    LatencyHistogram construction;
+    LatencyHistogram acknowledgement;
+    LatencyHistogram motionOnset;
+    LatencyHistogram endToEnd;
+    TypeStatistics() : published(0), withoutMotion(0)
+    {
+    }
+  };
+
+  struct Trace
+  {
+    TypeStatistics* statistics;
+    std::vector<std::string> jointNames;
+    JointGroupHandle joints;  // resolved on the first joint state after the publish
+    bool resolved;
+    bool hasConstruction;
+    Clock::time_point constructionTime;
+    Clock::time_point publishTime;
+    bool acknowledged;
+    std::vector<double> reference;  // positions of the first joint state after the publish
+  };
+
+  std::map<std::string, std::unique_ptr<TypeStatistics> > statistics_;
+  std::map<TraceKey, Trace> traces_;
+  std::map<TraceKey, Clock::time_point> constructions_;
+  std::atomic<size_t> activeTraces_;
+  double motionThreshold_;
+  std::vector<double> positions_;
+  mutable std::mutex mutex_;
+
+  TypeStatistics* getStatistics(const std::string& type);
+  void expireTraces(const Clock::time_point now);
+  void expireConstructions(const Clock::time_point now);
+  void fillSummary(const std::string& type, const TypeStatistics& statistics, CommandLatencySummary& summary) const;
+};
+
+#endif  // TOUGH_COMMAND_TRACER_H
@@ -0,0 +1,113 @@
+#ifndef TOUGH_DESCRIPTION_CACHE_H
+#define TOUGH_DESCRIPTION_CACHE_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+#include <Eigen/Core>
+
+/**
+ * @brief DescriptionCacheWriter serializes values in the binary format read by DescriptionCacheReader. The file starts
+ * with a header holding a magic number, the format version and a key, usually the hash of the URDF the values were
+ * derived from. Values are read back in the order they were written.
+ */
+class DescriptionCacheWriter
+{
+public:
+  /**
+   * @brief Start a new cache
+   *
+   * @param key                 key that must match when the cache is read
+   */
+  explicit DescriptionCacheWriter(const uint64_t key);
+
+  void write(const int32_t value);
+  void write(const double value);
+  void write(const std::string& value);
+  void write(const std::vector<std::string>& values);
+  void write(const std::vector<std::pair<double, double> >& values);
+  void write(const Eigen::VectorXd& values);
+
+  /**
+   * @brief Write the cache to a file. The data is written to a temporary file that is renamed, so that processes
+   * starting at the same time never read a partial cache.
+   *
+   * @param fileName            path of the cache file. The parent directory must exist.
+   * @return true               when the file was written
+   * @return false
+   */
+  bool save(const std::string& fileName) const;
+
+private:
+  std::string buffer_;
+
+  void append(const void* data, const size_t size);
+};
+
+/**
+ * @brief DescriptionCacheReader maps a cache file written by DescriptionCacheWriter in memory and reads its values.
+ * Every read is bounds checked, a truncated or corrupted file makes the reads fail instead of crashing.
+ */
+class DescriptionCacheReader
+{
+public:
+  DescriptionCacheReader();
+  ~DescriptionCacheReader();
+
+  // disable assign and copy
+  DescriptionCacheReader(DescriptionCacheReader const&) = delete;
+  void operator=(DescriptionCacheReader const&) = delete;
+
+  /**
+   * @brief Map a cache file in memory
+   *
+   * @param fileName            path of the cache file
+   * @param key                 expected key
+   * @return true               when the file exists, has the current format and the same key
+   * @return false
+   */
+  bool open(const std::string& fileName, const uint64_t key);
+
+  bool read(int32_t& value);
+  bool read(double& value);
+  bool read(std::string& value);
+  bool read(std::vector<std::string>& values);
+  bool read(std::vector<std::pair<double, double> >& values);
+  bool read(Eigen::VectorXd& values);
+
+  /**
+   * @brief Check that all the values were read
+   *
+   * @return true               when the end of the file was reached
+   * @return false
+   */
+  bool atEnd() const;
+
+private:
+  const char* data_;
+  size_t size_;
+  size_t offset_;
+
+  bool extract(void* data, const size_t size);
+  void close();
+};
+
+/**
+ * @brief 64 bit FNV-1a hash, used to key the cache on the content it was derived from
+ *
+ * @param data
+ * @param seed                  hash of the previous data when hashing several strings
+ * @return uint64_t
+ */
+uint64_t hashDescription(const std::string& data, const uint64_t seed = 14695981039346656037ULL);
+
+/**
+ * @brief Path of the cache file for a robot. Cache files are stored in $ROS_HOME, ~/.ros when it is not set.
+ *
+ * @param robotName
+ * @return std::string          empty if neither ROS_HOME nor HOME are set
+ */
+std::string getDescriptionCacheFile(const std::string& robotName);
+
+#endif  // TOUGH_DESCRIPTION_CACHE_H
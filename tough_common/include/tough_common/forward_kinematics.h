@@ -0,0 +1,112 @@
+#ifndef TOUGH_FORWARD_KINEMATICS_H
+#define TOUGH_FORWARD_KINEMATICS_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <urdf/model.h>
+#include <Eigen/Geometry>
+
+/**
+ * @brief ForwardKinematics computes the pose of every link of the URDF with respect to the root link (pelvis) from
+ * joint positions. The kinematic tree is flattened once at construction so that an update is a single pass over an
+ * array of links, parents are always updated before their children.
+ *
+ * A link whose pose depends on a movable joint that is not present in the joint state is marked unknown. Queries for
+ * such links return false so that the caller can fall back to TF.
+ *
+ * This class is not thread safe.
+ */
+class ForwardKinematics
+{
+public:
+  /**
+   * @brief Build the kinematic tree from the URDF model
+   *
+   * @param model               parsed URDF model of the robot
+   */
+  explicit ForwardKinematics(const urdf::Model& model);
+
+  /**
+   * @brief Checks if the model had a root link
+   *
+   * @return true               when the tree was built
+   * @return false
+   */
+  bool isValid() const;
+
+  /**
+   * @brief Name of the root link. All the poses are computed with respect to this frame.
+   *
+   * @return const std::string&
+   */
+  const std::string& getRootFrame() const;
+
+  /**
+   * @brief Checks if the frame is a link of the URDF. A leading '/' in the name is ignored.
+   *
+   * @param frameName
+   * @return true
+   * @return false
+   */
+  bool hasFrame(const std::string& frameName) const;
+
+  /**
+   * @brief Map URDF joints to their index in the joint state message. Call this whenever the order of joints in the
+   * joint state changes.
+   *
+   * @param jointNames          names of the joints in the joint state message
+   */
+  void setJointNames(const std::vector<std::string>& jointNames);
+
+  /**
+   * @brief Compute the pose of all the links from the joint positions
+   *
+   * @param positions           joint positions in the order of names passed to setJointNames
+   */
+  void update(const std::vector<double>& positions);
+
+  /**
+   * @brief Get the pose of a frame with respect to the root link as of the last update
+   *
+   * @param frameName           name of the link
+   * @param pose                [output]
+   * @return true               when the frame exists and all the joints it depends on are known
+   * @return false
+   */
+  bool getFramePose(const std::string& frameName, Eigen::Affine3d& pose) const;
+
+  /**
+   * @brief Get the pose of frameName with respect to baseFrame as of the last update
+   *
+   * @param frameName           name of the link
+   * @param baseFrame           name of the reference link
+   * @param pose                [output]
+   * @return true               when both frames are known
+   * @return false
+   */
+  bool getRelativePose(const std::string& frameName, const std::string& baseFrame, Eigen::Affine3d& pose) const;
+
+private:
+  struct Link
+  {
+    int parent;                // index of the parent link, -1 for root
+    int type;                  // urdf::Joint type of the joint connecting to parent
+    Eigen::Affine3d origin;    // joint origin with respect to parent link
+    Eigen::Vector3d axis;      // joint axis in joint frame
+    std::string jointName;     // joint whose position drives this link. For mimic joints this is the master joint
+    double multiplier;         // mimic multiplier, 1.0 otherwise
+    double offset;             // mimic offset, 0.0 otherwise
+    int jointIndex;            // index in the joint state, -1 when not published
+  };
+
+  std::string rootFrame_;
+  std::vector<Link> links_;
+  std::unordered_map<std::string, size_t> linkIndices_;
+  std::vector<Eigen::Affine3d> poses_;
+  std::vector<bool> known_;
+
+  bool getLinkIndex(const std::string& frameName, size_t& index) const;
+};
+
+#endif  // TOUGH_FORWARD_KINEMATICS_H
@@ -0,0 +1,155 @@
+#ifndef TOUGH_JOINT_HANDLE_H
+#define TOUGH_JOINT_HANDLE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+class RobotStateInformer;
+
+/**
+ * @brief JointHandle resolves a joint name to its index in the joint state message once and then reads the joint by
+ * index. The index is resolved again only when the set of joints published by the controller changes. Reads do not
+ * allocate and do not take a lock.
+ *
+ * Use RobotStateInformer::getJointHandle to create a handle. A handle caches its index, so use a separate copy in
+ * each thread.
+ */
+class JointHandle
+{
+public:
+  JointHandle();
+
+  /**
+   * @brief Name of the joint this handle refers to
+   *
+   * @return const std::string&
+   */
+  const std::string& getName() const;
+
+  /**
+   * @brief Checks if the joint is present in the latest joint state message
+   *
+   * @return true             when the joint exists
+   * @return false
+   */
+  bool isValid() const;
+
+  /**
+   * @brief Index of the joint in the joint state message. Same as RobotStateInformer::getJointNumber
+   *
+   * @return int              -1 if the joint does not exist
+   */
+  int getIndex() const;
+
+  /**
+   * @brief Get the current position of the joint
+   *
+   * @return double           0.0 if the joint does not exist
+   */
+  double getPosition() const;
+
+  /**
+   * @brief Get the current velocity of the joint
+   *
+   * @return double           0.0 if the joint does not exist
+   */
+  double getVelocity() const;
+
+  /**
+   * @brief Get the current effort of the joint
+   *
+   * @return double           0.0 if the joint does not exist
+   */
+  double getEffort() const;
+
+private:
+  friend class RobotStateInformer;
+  JointHandle(RobotStateInformer* stateInformer, const std::string& jointName);
+
+  bool resolve() const;
+  double read(const int field) const;
+
+  RobotStateInformer* stateInformer_;
+  std::string name_;
+  mutable int index_;
+  mutable uint64_t layoutVersion_;
+};
+
+/**
+ * @brief JointGroupHandle resolves a list of joint names to their indices once and then reads all of them from the
+ * same joint state update. The output order is the order of names used to create the handle. Reads do not allocate
+ * once the output vector has the right size.
+ *
+ * Use RobotStateInformer::getJointGroupHandle to create a handle. A handle caches its indices, so use a separate copy
+ * in each thread.
+ */
+class JointGroupHandle
+{
+public:
+  JointGroupHandle();
+
+  /**
+   * @brief Names of the joints in this group
+   *
+   * @return const std::vector<std::string>&
+   */
+  const std::vector<std::string>& getNames() const;
+
+  /**
+   * @brief Number of joints in the group
+   *
+   * @return size_t
+   */
+  size_t size() const;
+
+  /**
+   * @brief Checks if all the joints of the group are present in the latest joint state message
+   *
+   * @return true             when all the joints exist
+   * @return false
+   */
+  bool isValid() const;
+
+  /**
+   * @brief Get the current positions of the joints in the group
+   *
+   * @param positions         [output]
+   * @return true             when all the joints exist
+   * @return false
+   */
+  bool getPositions(std::vector<double>& positions) const;
+
+  /**
+   * @brief Get the current velocities of the joints in the group
+   *
+   * @param velocities        [output]
+   * @return true             when all the joints exist
+   * @return false
+   */
+  bool getVelocities(std::vector<double>& velocities) const;
+
+  /**
+   * @brief Get the current efforts of the joints in the group
+   *
+   * @param efforts           [output]
+   * @return true             when all the joints exist
+   * @return false
+   */
+  bool getEfforts(std::vector<double>& efforts) const;
+
+private:
+  friend class RobotStateInformer;
+  JointGroupHandle(RobotStateInformer* stateInformer, const std::vector<std::string>& jointNames);
+
+  bool resolve() const;
+  bool read(const int field, std::vector<double>& values) const;
+
+  RobotStateInformer* stateInformer_;
+  std::vector<std::string> names_;
+  mutable std::vector<size_t> indices_;
+  mutable bool valid_;
+  mutable uint64_t layoutVersion_;
+};
+
+#endif  // TOUGH_JOINT_HANDLE_H
@@ -0,0 +1,115 @@
+#ifndef TOUGH_JOINT_STATE_BUFFER_H
+#define TOUGH_JOINT_STATE_BUFFER_H
+
+#include <atomic>
+#include <vector>
+#include <stdint.h>
+#include <sensor_msgs/JointState.h>
+
+/**
+ * @brief JointStateBuffer stores the latest joint positions, velocities and efforts in fixed size arrays guarded by a
+ * sequence lock. There is a single writer (the joint state callback) and any number of readers. Writer never waits
+ * for readers and readers never take a lock, they retry only when a write happened while they were copying.
+ *
+ * All the values are stored as relaxed atomics so that a torn read is never a data race. On x86 and ARM these compile
+ * to plain loads and stores.
+ */
+class JointStateBuffer
+{
+public:
+  /**
+   * @brief Maximum number of joints that can be stored. Valkyrie and Atlas publish less than 64 joints.
+   */
+  static const size_t MAX_JOINTS = 128;
+
+  /**
+   * @brief Fields of a joint state that are stored in the buffer
+   */
+  enum Field
+  {
+    POSITION = 0,
+    VELOCITY,
+    EFFORT,
+    NUM_FIELDS
+  };
+
+  JointStateBuffer();
+
+  // disable assign and copy. Atomics cannot be copied anyway.
+  JointStateBuffer(JointStateBuffer const&) = delete;
+  void operator=(JointStateBuffer const&) = delete;
+
+  /**
+   * @brief Update the buffer with a new joint state message. Only one thread should call this at a time.
+   * Joints beyond MAX_JOINTS are dropped and missing velocity/effort values are stored as zero.
+   *
+   * @param msg                 joint state message received from the controller
+   */
+  void update(const sensor_msgs::JointState& msg);
+
+  /**
+   * @brief Number of joints in the latest update
+   *
+   * @return size_t
+   */
+  size_t size() const;
+
+  /**
+   * @brief Number of updates written to the buffer so far. It can be used to check if new data has arrived.
+   *
+   * @return uint64_t
+   */
+  uint64_t getUpdateCount() const;
+
+  /**
+   * @brief Read a single value of a joint.
+   *
+   * @param field               POSITION, VELOCITY or EFFORT
+   * @param index               Index of the joint in the joint state message
+   * @param value               [output]
+   * @return true               when index is valid
+   * @return false
+   */
+  bool read(const Field field, const size_t index, double& value) const;
+
+  /**
+   * @brief Read the values of all the joints
+   *
+   * @param field               POSITION, VELOCITY or EFFORT
+   * @param values              [output] resized to the number of joints
+   */
+  void read(const Field field, std::vector<double>& values) const;
+
+  /**
+   * @brief Read the values of a subset of joints. Output is in the same order as indices.
+   *
+   * @param field               POSITION, VELOCITY or EFFORT
+   * @param indices             Indices of the joints in the joint state message
+   * @param values              [output] resized to size of indices
+   * @return true               when all the indices are valid
+   * @return false
+   */
+  bool read(const Field field, const std::vector<size_t>& indices, std::vector<double>& values) const;
+
+  /**
+   * @brief Read positions, velocities and efforts of all the joints from the same update along with its stamp.
+   *
+   * @param positions           [output]
+   * @param velocities          [output]
+   * @param efforts             [output]
+   * @param stamp               [output] header stamp of the message in nanoseconds
+   */
+  void readAll(std::vector<double>& positions, std::vector<double>& velocities, std::vector<double>& efforts,
+               uint64_t& stamp) const;
+
+private:
+  std::atomic<uint64_t> sequence_;
+  std::atomic<size_t> size_;
+  std::atomic<uint64_t> stamp_;
+  std::atomic<double> data_[NUM_FIELDS][MAX_JOINTS];
+
+  uint64_t readBegin() const;
+  bool readRetry(const uint64_t sequence) const;
+};
+
+#endif  // TOUGH_JOINT_STATE_BUFFER_H
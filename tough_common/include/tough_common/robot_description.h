@@ -1,13 +1,16 @@
 #ifndef ROBOT_DESCRIPTION_H
 #define ROBOT_DESCRIPTION_H
 
+#include <mutex>
 #include <string>
 #include <ros/ros.h>
 #include <ros/console.h>
 #include <urdf/model.h>
 #include <urdf_model/types.h>
 #include "tough_common/tough_common_names.h"
+#include "tough_common/robot_traits.h"
 #include <geometry_msgs/TransformStamped.h>
+#include <Eigen/Core>
 
 /**
  * @brief enum to specify side of the robot. Used for limbs and end-effectors.
@@ -37,6 +40,29 @@ enum class EE_LOADING
   UNLOAD
 };
 
+/**
+ * @brief enum for specifying a kinematic chain of the robot.
+ */
+enum class JointChain
+{
+  LEFT_ARM = 0,
+  RIGHT_ARM,
+  CHEST
+};
+
+/**
+ * @brief Joint limits of a kinematic chain stored as structure of arrays, in the order of the joint names of the chain.
+ * Eigen vectors are contiguous and aligned, so the limits of all the joints of a chain can be checked or applied with
+ * vectorized operations, e.g. positions.cwiseMax(limits.lower).cwiseMin(limits.upper).
+ */
+struct JointChainLimits
+{
+  Eigen::VectorXd lower;     // radians or meters
+  Eigen::VectorXd upper;     // radians or meters
+  Eigen::VectorXd velocity;  // radians/s or meters/s
+  Eigen::VectorXd effort;    // Nm or N
+};
+
 class RobotDescription
 {
 public:
@@ -133,6 +159,21 @@ public:
    */
   const std::string getURDFParameter() const;
 
+  /**
+   * @brief Get the type of the robot, used to select the RobotTraits with the compile time joint counts
+   *
+   * @return RobotType        UNKNOWN for robots without traits
+   */
+  RobotType getRobotType() const;
+
+  /**
+   * @brief URDF model of the robot parsed from the parameter server. When the description was loaded from the
+   * cache, the URDF is parsed on the first call.
+   *
+   * @return const urdf::Model&
+   */
+  const urdf::Model& getURDFModel() const;
+
   /**
    * @brief Get the vector of Left Arm Joint Names
    * 
@@ -154,6 +195,21 @@ public:
    */
   void getChestJointNames(std::vector<std::string>& chest_joint_names) const;
 
+  /**
+   * @brief Get the names of the movable joints of a leg, from the pelvis to the foot, as found in the URDF
+   *
+   * @param side              LEFT or RIGHT
+   * @param leg_joint_names   a vector of std::string, empty when the foot is not in the URDF [output]
+   */
+  void getLegJointNames(const RobotSide side, std::vector<std::string>& leg_joint_names) const;
+
+  /**
+   * @brief Get the names of the movable joints of the neck, from the torso to the head, as found in the URDF
+   *
+   * @param neck_joint_names  a vector of std::string, empty when the head is not in the URDF [output]
+   */
+  void getNeckJointNames(std::vector<std::string>& neck_joint_names) const;
+
   /**
    * @brief Get the vector of Left Arm Frame Names 
    * 
@@ -189,6 +245,35 @@ public:
    */
   void getChestJointLimits(std::vector<std::pair<double, double> >& chest_joint_limits) const;
 
+  /**
+   * @brief Get the joint limits of a chain without copying them
+   *
+   * @param chain             LEFT_ARM, RIGHT_ARM or CHEST
+   * @return const JointChainLimits&  valid as long as the limits of the chain are not set again
+   */
+  const JointChainLimits& getJointChainLimits(const JointChain chain) const;
+
+  /**
+   * @brief Get the joint names of a chain without copying them
+   *
+   * @param chain             LEFT_ARM, RIGHT_ARM or CHEST
+   * @return const std::vector<std::string>&
+   */
+  const std::vector<std::string>& getJointChainNames(const JointChain chain) const;
+
+  /**
+   * @brief Get the index of every joint of a chain in a JointState message. The indices of the last layout of every
+   * chain are cached, calls with the same joint_state_names do not search the names again.
+   *
+   * @param chain             LEFT_ARM, RIGHT_ARM or CHEST
+   * @param joint_state_names name field of the JointState message
+   * @param indices           [output] index in joint_state_names of each joint of the chain
+   * @return true             when all the joints of the chain are in joint_state_names
+   * @return false
+   */
+  bool getJointStateIndices(const JointChain chain, const std::vector<std::string>& joint_state_names,
+                            std::vector<int>& indices) const;
+
   int getNumberOfNeckJoints() const;
 
   /**
@@ -314,7 +399,10 @@ private:
   RobotDescription(ros::NodeHandle nh, std::string urdf_param = "/robot_description");
   ~RobotDescription();
   static RobotDescription* object;
-  urdf::Model model_;
+  mutable urdf::Model model_;
+  mutable std::once_flag model_parsed_;
+  mutable bool model_valid_;
+  std::string robot_xml_;
   std::vector<urdf::JointSharedPtr> joints_;
   std::vector<urdf::LinkSharedPtr> links_;
   std::string urdf_param_;
@@ -351,10 +439,40 @@ private:
   std::vector<std::pair<double, double> > right_arm_joint_limits_;
   std::vector<std::pair<double, double> > chest_joint_limits_;
 
+  // indexed by JointChain, lower and upper are kept in sync with the vectors of pairs by updateJointChainLimits
+  static const size_t NUM_JOINT_CHAINS = 3;
+  JointChainLimits joint_chain_limits_[NUM_JOINT_CHAINS];
+
+  // indices of each chain in the last joint name layout it was looked up in, indexed by JointChain. The layout of
+  // trajectories and joint states rarely changes, a lookup with the same names only compares them.
+  struct JointStateIndices
+  {
+    std::vector<std::string> joint_state_names;
+    std::vector<int> indices;
+    bool resolved = false;
+    bool valid = false;
+  };
+  mutable JointStateIndices joint_state_indices_[NUM_JOINT_CHAINS];
+  mutable std::mutex joint_state_indices_mutex_;
+  void resetJointStateIndices(const JointChain chain);
+
   int number_of_neck_joints_;
 
   double foot_frame_offset_;
 
+  /* Values derived from the URDF and the joint name parameters are cached in a binary file keyed by the hash of the
+   * URDF and of the values of the joint and frame name parameters, so that nodes do not parse the URDF on every
+   * start. The cache is rebuilt when any of them changes.
+   */
+  bool parseModel() const;
+  // movable joints from base_link to tip_link in the URDF, empty when tip_link is not below base_link
+  void getJointsBetween(const std::string& base_link, const std::string& tip_link,
+                        std::vector<std::string>& joint_names) const;
+  void updateJointChainLimits();
+  bool parseDescription(ros::NodeHandle& nh);
+  bool loadDescriptionCache(const std::string& file_name, const uint64_t key);
+  bool storeDescriptionCache(const std::string& file_name, const uint64_t key) const;
+
   /* Frame hash - these are defined in us.ihmc.sensorProcessing.frames.CommonReferenceFrameIds
    * Currently there is no way of querying hashID of a frame. Once it is available, it will be implemented in teh
    * constructor of this class
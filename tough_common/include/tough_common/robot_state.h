@@ -4,14 +4,28 @@
 #include <ros/ros.h>
 #include <sensor_msgs/JointState.h>
 #include <map>
+#include <unordered_map>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <condition_variable>
 #include <tf/transform_listener.h>
 #include <mutex>
 #include <geometry_msgs/Pose2D.h>
+#include <Eigen/Geometry>
 #include "tough_common/robot_description.h"
+#include "tough_common/joint_state_buffer.h"
+#include "tough_common/joint_handle.h"
+#include "tough_common/state_history.h"
+#include "tough_common/forward_kinematics.h"
+#include "tough_common/topic_statistics.h"
+#include "tough_common/callback_list.h"
 #include <sensor_msgs/Imu.h>
 #include <ihmc_msgs/Point2dRosMessage.h>
 #include <geometry_msgs/WrenchStamped.h>
+#include <geometry_msgs/PointStamped.h>
 #include <std_msgs/Bool.h>
+#include <diagnostic_msgs/DiagnosticArray.h>
 
 struct RobotState
 {
@@ -21,54 +35,166 @@ struct RobotState
   float effort;
 };
 
+/**
+ * @brief RobotStateSnapshot holds the latest value of every signal received by RobotStateInformer, copied together.
+ * Each field carries its own stamp and is only consistent to that stamp: the signals arrive on separate topics at
+ * different rates, so the joint state and the sensor fields may come from slightly different times. Messages that do
+ * not have a header (center of mass, capture point and double support) are stamped with the time they were received.
+ *
+ * Wrench arrays are indexed with RobotSide.
+ */
+struct RobotStateSnapshot
+{
+  ros::Time stamp;  // time at which the snapshot was taken
+  sensor_msgs::JointState jointState;
+  sensor_msgs::Imu pelvisImu;
+  geometry_msgs::PointStamped centerOfMass;
+  geometry_msgs::PointStamped capturePoint;
+  bool isInDoubleSupport;
+  ros::Time doubleSupportStamp;
+  geometry_msgs::WrenchStamped footWrenches[2];
+  geometry_msgs::WrenchStamped wristWrenches[2];
+};
+
 class RobotStateInformer
 {
-private:
-  // private constructor to disable user from creating objects
+protected:
+  // users get the shared instance with getRobotStateInformer. Tests and benchmarks derive from it to feed the state
+  // through the callbacks and the listener without a running robot.
   RobotStateInformer(ros::NodeHandle nh);
+  tf::TransformListener listener_;
+  void jointStateCB(const sensor_msgs::JointState::Ptr msg);
+
+private:
   static RobotStateInformer* currentObject_;
   RobotDescription* rd_;
 
   ros::NodeHandle nh_;
-  tf::TransformListener listener_;
   std::string robotName_;
 
+  // latest available transform from source_frame to target_frame. When wait is false, it returns immediately if the
+  // transform is not available yet instead of waiting for it.
+  bool lookupTransform(const std::string& target_frame, const std::string& source_frame,
+                       tf::StampedTransform& transform, const bool wait);
+
   ros::Subscriber jointStateSub_;
-  void jointStateCB(const sensor_msgs::JointState::Ptr msg);
+  // latest message is swapped atomically, values are read from jointStateBuffer_ without locking
   sensor_msgs::JointState::Ptr currentStatePtr_;
-  std::map<std::string, RobotState> currentState_;
-  std::vector<std::string> jointNames_;
-  std::mutex currentStateMutex_;
+  JointStateBuffer jointStateBuffer_;
+
+  // joint names and their index in the joint state message. Rebuilt only when the set of joints changes.
+  struct JointLayout
+  {
+    std::vector<std::string> names;
+    std::unordered_map<std::string, size_t> indices;
+  };
+  typedef boost::shared_ptr<const JointLayout> JointLayoutConstPtr;
+  JointLayoutConstPtr jointLayout_;
+  std::atomic<uint64_t> jointLayoutVersion_;
+  void updateJointLayout(const std::vector<std::string>& jointNames);
+
+  friend class JointHandle;
+  friend class JointGroupHandle;
+  friend class RobotStateReplay;
+
+  // joint names read from a parameter and their indices in the joint state message. Parameter server is queried only
+  // the first time a group is used and indices are resolved again only when the joint layout changes.
+  struct JointGroup
+  {
+    std::vector<std::string> names;
+    std::vector<size_t> indices;
+    uint64_t layoutVersion;
+  };
+  typedef boost::shared_ptr<const JointGroup> JointGroupConstPtr;
+  std::map<std::string, JointGroupConstPtr> jointGroups_;
+  std::mutex jointGroupsMutex_;
+  bool getJointGroup(const std::string& paramName, JointGroupConstPtr& group);
+  bool getJointGroupValues(const std::string& paramName, const JointStateBuffer::Field field,
+                           std::vector<double>& values);
 
   ros::Subscriber pelvisIMUSub_;
   void pelvisImuCB(const sensor_msgs::Imu::Ptr msg);
-  sensor_msgs::Imu::Ptr pelvisImuValue_;
 
   ros::Subscriber centerOfMassSub_;
   void centerOfMassCB(const geometry_msgs::Point32::Ptr msg);
-  geometry_msgs::Point32::Ptr centerOfMassValue_;
 
   ros::Subscriber capturePointSub_;
   void capturPointCB(const ihmc_msgs::Point2dRosMessage::Ptr msg);
-  ihmc_msgs::Point2dRosMessage::Ptr capturePointValue_;
 
   ros::Subscriber isInDoubleSupportSub_;
   void doubleSupportStatusCB(const std_msgs::Bool& msg);
-  bool doubleSupportStatus_;
 
   ros::Subscriber leftFootForceSensorSub_;
   ros::Subscriber rightFootForceSensorSub_;
   void leftFootForceSensorCB(const geometry_msgs::WrenchStamped::Ptr msg);
   void rightFootForceSensorCB(const geometry_msgs::WrenchStamped::Ptr msg);
-  std::map<RobotSide, geometry_msgs::WrenchStamped::Ptr> footWrenches_;
 
   ros::Subscriber leftWristForceSensorSub_;
   ros::Subscriber rightWristForceSensorSub_;
   void leftWristForceSensorCB(const geometry_msgs::WrenchStamped::Ptr msg);
   void rightWristForceSensorCB(const geometry_msgs::WrenchStamped::Ptr msg);
-  std::map<RobotSide, geometry_msgs::WrenchStamped::Ptr> wristWrenches_;
 
-  void populateStateMap();
+  // functions called from the sensor callbacks
+  CallbackList<const RobotSide, const geometry_msgs::WrenchStamped&> wristWrenchCallbacks_;
+  CallbackList<const sensor_msgs::JointState&> jointStateCallbacks_;
+
+  // latest values of all the signals other than joint states. jointState field is not used here.
+  RobotStateSnapshot sensorState_;
+  std::mutex sensorStateMutex_;
+
+  // recent history of the signals for time aligned queries. Wrench arrays are indexed with RobotSide.
+  struct JointSample
+  {
+    JointLayoutConstPtr layout;  // names of the joints when the sample was received
+    std::vector<double> position;
+    std::vector<double> velocity;
+    std::vector<double> effort;
+  };
+  StateHistory<JointSample> jointStateHistory_;
+  static void bracketSameLayout(const JointSample& before, const JointSample& after, const double ratio,
+                                const JointSample*& first, const JointSample*& second, double& blend);
+  StateHistory<sensor_msgs::Imu> pelvisImuHistory_;
+  StateHistory<geometry_msgs::Wrench> footWrenchHistory_[2];
+  StateHistory<geometry_msgs::Wrench> wristWrenchHistory_[2];
+
+  // pose of robot links computed from the URDF and the latest joint state. Links are updated lazily, at most once per
+  // joint state update, and the pose of the root link in world is looked up from TF once per update. The kinematic
+  // tree is built from the URDF on the first query, so nodes that never query link poses do not parse the URDF.
+  std::unique_ptr<ForwardKinematics> forwardKinematics_;
+  std::mutex forwardKinematicsMutex_;
+  uint64_t fkUpdateCount_;
+  uint64_t fkLayoutVersion_;
+  std::vector<double> fkPositions_;
+  Eigen::Affine3d fkRootPose_;
+  bool fkRootPoseValid_;
+  bool getForwardKinematicsPose(const std::string& frameName, const std::string& baseFrame, Eigen::Affine3d& pose);
+
+  // statistics of every subscriber, indexed with StateTopic. Published periodically on the diagnostics topic.
+  enum StateTopic
+  {
+    TOPIC_JOINT_STATES = 0,
+    TOPIC_PELVIS_IMU,
+    TOPIC_CENTER_OF_MASS,
+    TOPIC_CAPTURE_POINT,
+    TOPIC_DOUBLE_SUPPORT,
+    TOPIC_LEFT_FOOT_FORCE_SENSOR,
+    TOPIC_RIGHT_FOOT_FORCE_SENSOR,
+    TOPIC_LEFT_WRIST_FORCE_SENSOR,
+    TOPIC_RIGHT_WRIST_FORCE_SENSOR,
+    NUM_STATE_TOPICS
+  };
+  TopicStatistics topicStatistics_[NUM_STATE_TOPICS];
+  ros::Publisher diagnosticsPub_;
+  ros::Timer diagnosticsTimer_;
+  void publishDiagnostics(const ros::TimerEvent& event);
+
+  // incremented by every callback, waiters block on stateUpdateCondition_ until it changes
+  uint64_t stateUpdateCount_;
+  std::mutex stateUpdateMutex_;
+  std::condition_variable stateUpdateCondition_;
+  // waiters process the callbacks themselves, for nodes without a spinner thread
+  std::atomic<bool> spinWhileWaiting_;
+
   void initializeClassMembers();
 
   void inline parseParameter(const std::string& paramName, std::string& parameter)
@@ -130,6 +256,41 @@ public:
    */
   int getJointNumber(std::string jointName);
 
+  /**
+   * @brief Get the index of a joint in the joint state message using a hash lookup.
+   *
+   * @param jointName
+   * @param index             [output]
+   * @return true             when the joint exists
+   * @return false
+   */
+  bool getJointIndex(const std::string& jointName, size_t& index);
+
+  /**
+   * @brief Version of the joint name to index mapping. It changes only when the set of joints published by the
+   * controller changes. JointHandle and JointGroupHandle use this to decide when to resolve their indices again.
+   *
+   * @return uint64_t
+   */
+  uint64_t getJointLayoutVersion() const;
+
+  /**
+   * @brief Get a handle to read a joint by index. The name is resolved once, which avoids a lookup on every read.
+   *
+   * @param jointName
+   * @return JointHandle
+   */
+  JointHandle getJointHandle(const std::string& jointName);
+
+  /**
+   * @brief Get a handle to read a group of joints by index. The names are resolved once, which avoids lookups on
+   * every read. Values are returned in the order of jointNames.
+   *
+   * @param jointNames
+   * @return JointGroupHandle
+   */
+  JointGroupHandle getJointGroupHandle(const std::vector<std::string>& jointNames);
+
   /**
    * @brief Get the current positions of all joints. Ordering is based on the order in the JointNames vector.
    * The order for the Joints' Names, Numbers, Positions, Velocities and Efforts in their vectors are same. 
@@ -143,10 +304,12 @@ public:
    * The order for the Joints' Names, Numbers, Positions, Velocities and Efforts in their vectors are same.
    * So any perticular joint will have a same index in all of the vectors.
    *
+   * The parameter is read only on the first call, later calls gather the values from cached joint indices.
+   *
    * @param paramName         - Parameter on ros param server that has an array of joint names
    * @param positions         [output]
    * @return true             when successful
-   * @return false
+   * @return false            when the parameter does not exist or a joint is missing in the joint state
    */
   bool getJointPositions(const std::string& paramName, std::vector<double>& positions);
 
@@ -167,7 +330,7 @@ public:
    * @param paramName       - Parameter name on ros param server that has an array of joint names
    * @param velocities      [output]
    * @return true           - when successful
-   * @return false 
+   * @return false          - when the parameter does not exist or a joint is missing in the joint state
    */
   bool getJointVelocities(const std::string& paramName, std::vector<double>& velocities);
 
@@ -185,10 +348,10 @@ public:
    * The order for the Joints' Names, Numbers, Positions, Velocities and Efforts in their vectors are same.
    * So any perticular joint will have a same index in all of the vectors.
    *
-   * @param paramName
-   * @param efforts
-   * @return true
-   * @return false
+   * @param paramName       - Parameter name on ros param server that has an array of joint names
+   * @param efforts         [output]
+   * @return true           - when successful
+   * @return false          - when the parameter does not exist or a joint is missing in the joint state
    */
   bool getJointEfforts(const std::string& paramName, std::vector<double>& efforts);
 
@@ -262,16 +425,19 @@ public:
   void getJointNames(std::vector<std::string>& jointNames);
 
   /**
-   * @brief Get the Current Pose of the frameName with respect to the baseFrame
+   * @brief Get the Current Pose of the frameName with respect to the baseFrame. When both the frames are links of the
+   * robot (or world), the pose is computed from the latest joint state without going through TF.
    * 
    * @param frameName               - The name of the required frame, whose pose is to be found
    * @param pose                    - Pose of the frameName wrt baseFrame [output]
    * @param baseFrame               - The name of the Reference frame
+   * @param wait                    - Wait upto 2 seconds for the transform when it is looked up from TF. When false,
+   *                                  the latest available transform is used and the call never sleeps.
    * @return true                   - when successful
    * @return false 
    */
   bool getCurrentPose(const std::string& frameName, geometry_msgs::Pose& pose,
-                      const std::string& baseFrame = TOUGH_COMMON_NAMES::WORLD_TF);
+                      const std::string& baseFrame = TOUGH_COMMON_NAMES::WORLD_TF, const bool wait = true);
 
   /**
    * @brief Get the Transform from baseFrame to the frameName.
@@ -279,11 +445,27 @@ public:
    * @param frameName               - The name of the required frame, whose transform is to be found
    * @param transform               - Final transform from baseFrame to the frameName [output]
    * @param baseFrame               - The name of the reference frame
+   * @param wait                    - Wait upto 2 seconds for the transform. When false, the latest available transform
+   *                                  is used and the call never sleeps. Use false inside callbacks.
    * @return true                   - When successful
    * @return false
    */
   bool getTransform(const std::string& frameName, tf::StampedTransform& transform,
-                    const std::string& baseFrame = TOUGH_COMMON_NAMES::WORLD_TF);
+                    const std::string& baseFrame = TOUGH_COMMON_NAMES::WORLD_TF, const bool wait = true);
+
+  /**
+   * @brief Get the Transform from baseFrame to the frameName as an Eigen transform. Like getCurrentPose, links of the
+   * robot are served from forward kinematics.
+   *
+   * @param frameName               - The name of the required frame, whose transform is to be found
+   * @param transform               - Final transform from baseFrame to the frameName [output]
+   * @param baseFrame               - The name of the reference frame
+   * @param wait                    - Wait upto 2 seconds for the transform. When false, the call never sleeps.
+   * @return true                   - When successful
+   * @return false
+   */
+  bool getTransform(const std::string& frameName, Eigen::Affine3d& transform,
+                    const std::string& baseFrame = TOUGH_COMMON_NAMES::WORLD_TF, const bool wait = true);
 
   /**
    * @brief Transforms the quaternion from the current reference frame to the target_frame
@@ -329,11 +511,12 @@ public:
    * @param pt_out                  - Output Point after the transformation [output]
    * @param from_frame              - Current Reference frame Before thr transformation
    * @param to_frame                - Reference frame for the transformation
+   * @param wait                    - Wait upto 2 seconds for the transform. When false, the call never sleeps.
    * @return true                   - When Successful
    * @return false
    */
   bool transformPoint(const geometry_msgs::Point& pt_in, geometry_msgs::Point& pt_out, const std::string& from_frame,
-                      const std::string& to_frame = TOUGH_COMMON_NAMES::WORLD_TF);
+                      const std::string& to_frame = TOUGH_COMMON_NAMES::WORLD_TF, const bool wait = true);
 
   /**
    * @brief Transforms the pose from the current reference frame to the target_frame
@@ -373,6 +556,53 @@ public:
   bool transformPose(const geometry_msgs::Pose2D& pose_in, geometry_msgs::Pose2D& pose_out,
                      const std::string& from_frame, const std::string& to_frame = TOUGH_COMMON_NAMES::WORLD_TF);
 
+  /**
+   * @brief Transforms a batch of points from the from_frame to the to_frame. The transform is looked up only once
+   * and applied to all the points. pts_in and pts_out can be the same vector.
+   *
+   * @param pts_in                  - Input Points for the transformation
+   * @param pts_out                 - Output Points after the transformation, in the same order [output]
+   * @param from_frame              - Current Reference frame before the transformation.
+   * @param to_frame                - Reference frame for the transformation
+   * @param wait                    - Wait upto 2 seconds for the transform. When false, the call never sleeps.
+   * @return true                   - When Successful
+   * @return false
+   */
+  bool transformPoints(const std::vector<geometry_msgs::Point>& pts_in, std::vector<geometry_msgs::Point>& pts_out,
+                       const std::string& from_frame, const std::string& to_frame = TOUGH_COMMON_NAMES::WORLD_TF,
+                       const bool wait = true);
+
+  /**
+   * @brief Transforms a batch of points stored as columns of a matrix from the from_frame to the to_frame.
+   * The transform is looked up only once and applied to the whole matrix.
+   *
+   * @param pts_in                  - Input Points for the transformation, one point per column
+   * @param pts_out                 - Output Points after the transformation [output]
+   * @param from_frame              - Current Reference frame before the transformation.
+   * @param to_frame                - Reference frame for the transformation
+   * @param wait                    - Wait upto 2 seconds for the transform. When false, the call never sleeps.
+   * @return true                   - When Successful
+   * @return false
+   */
+  bool transformPoints(const Eigen::Matrix3Xd& pts_in, Eigen::Matrix3Xd& pts_out, const std::string& from_frame,
+                       const std::string& to_frame = TOUGH_COMMON_NAMES::WORLD_TF, const bool wait = true);
+
+  /**
+   * @brief Transforms a batch of poses from the from_frame to the to_frame. The transform is looked up only once
+   * and applied to all the poses. poses_in and poses_out can be the same vector.
+   *
+   * @param poses_in                - Input Poses for the transformation
+   * @param poses_out               - Output Poses after the transformation, in the same order [output]
+   * @param from_frame              - Current Reference frame before the transformation.
+   * @param to_frame                - Reference frame for the transformation
+   * @param wait                    - Wait upto 2 seconds for the transform. When false, the call never sleeps.
+   * @return true                   - When Successful
+   * @return false
+   */
+  bool transformPoses(const std::vector<geometry_msgs::Pose>& poses_in, std::vector<geometry_msgs::Pose>& poses_out,
+                      const std::string& from_frame, const std::string& to_frame = TOUGH_COMMON_NAMES::WORLD_TF,
+                      const bool wait = true);
+
   /**
    * @brief Transforms the vector3 message from the from_frame frame to the to_frame
    *
@@ -427,8 +657,21 @@ public:
    *
    * @param side                    - Side of the robot. It can be RIGHT or LEFT.
    * @param wrench                  - [output]
+   * @return true                   - When a wrench was received from the sensor
+   * @return false                  - When the wrench is still zero
+   */
+  bool getWristWrench(const RobotSide side, geometry_msgs::Wrench& wrench);
+
+  /**
+   * @brief Get the Wrenches on the wrists with the time they were measured
+   *
+   * @param side                    - Side of the robot. It can be RIGHT or LEFT.
+   * @param wrench                  - [output]
+   * @param stamp                   - [output] stamp of the message, or its receipt time when it is not stamped
+   * @return true                   - When a wrench was received from the sensor
+   * @return false                  - When the wrench is still zero
    */
-  void getWristWrench(const RobotSide side, geometry_msgs::Wrench& wrench);
+  bool getWristWrench(const RobotSide side, geometry_msgs::Wrench& wrench, ros::Time& stamp);
 
   /**
    * @brief Get the Forces on the foot
@@ -462,6 +705,50 @@ public:
    */
   void getWristTorque(const RobotSide side, geometry_msgs::Vector3& torque);
 
+  /**
+   * @brief Function called with every joint state message
+   */
+  typedef std::function<void(const sensor_msgs::JointState& jointState)> JointStateCallback;
+
+  /**
+   * @brief Call a function from the joint state callback, after the state is updated. It must return quickly, it
+   * delays the processing of the joint states.
+   *
+   * @param callback                - Function called with the joint state message
+   * @return int                    - Handle used to remove the callback
+   */
+  int addJointStateCallback(const JointStateCallback& callback);
+
+  /**
+   * @brief Remove a callback added with addJointStateCallback. The callback may still be running in the joint state
+   * callback when this returns.
+   *
+   * @param handle                  - Handle returned by addJointStateCallback
+   */
+  void removeJointStateCallback(const int handle);
+
+  /**
+   * @brief Function called with every wrench measured by a wrist force sensor
+   */
+  typedef std::function<void(const RobotSide side, const geometry_msgs::WrenchStamped& wrench)> WristWrenchCallback;
+
+  /**
+   * @brief Call a function from the wrist force sensor callbacks, as soon as each wrench is received. It must return
+   * quickly, it delays the processing of the sensor messages.
+   *
+   * @param callback                - Function called with the side and the wrench of the sensor
+   * @return int                    - Handle used to remove the callback
+   */
+  int addWristWrenchCallback(const WristWrenchCallback& callback);
+
+  /**
+   * @brief Remove a callback added with addWristWrenchCallback. The callback may still be running in the sensor
+   * callback when this returns.
+   *
+   * @param handle                  - Handle returned by addWristWrenchCallback
+   */
+  void removeWristWrenchCallback(const int handle);
+
   /**
    * @brief     If the robot has both of its feet in contact with the ground, the robot is 
    * said to be in double support. 
@@ -492,6 +779,141 @@ public:
    * @param msg                     - [output]
    */
   void getPelvisIMUReading(sensor_msgs::Imu& msg);
+
+  /**
+   * @brief Get the latest value of every signal (joint states, pelvis IMU, center of mass, capture point, double
+   * support and the foot and wrist wrenches) copied together. Use this instead of calling the individual getters to
+   * get all the signals with a single lock. The fields are not aligned in time, compare their stamps or use the
+   * get*At queries when they need to be.
+   *
+   * @param snapshot                - [output]
+   */
+  void getStateSnapshot(RobotStateSnapshot& snapshot);
+
+  /**
+   * @brief Get the joint positions at a given time. The value is linearly interpolated between the two recorded joint
+   * states around the given time. Use this to align sensor data like laser scans or images with the kinematics of the
+   * robot. The joint states of the last state_history_duration seconds (parameter, 2 s by default) are kept.
+   *
+   * @param time                    - Time of the query, usually the stamp of the sensor message
+   * @param positions               - [output]
+   * @return true                   - When time is within the recorded history
+   * @return false
+   */
+  bool getJointPositionsAt(const ros::Time& time, std::vector<double>& positions);
+
+  /**
+   * @brief Get the joint state message at a given time. Positions, velocities and efforts are linearly interpolated
+   * between the two recorded joint states around the given time.
+   *
+   * @param time                    - Time of the query
+   * @param jointState              - [output]
+   * @return true                   - When time is within the recorded history
+   * @return false
+   */
+  bool getJointStateAt(const ros::Time& time, sensor_msgs::JointState& jointState);
+
+  /**
+   * @brief Get the Pelvis IMU Reading at a given time. Orientation is interpolated with slerp and the rates are
+   * interpolated linearly.
+   *
+   * @param time                    - Time of the query
+   * @param msg                     - [output]
+   * @return true                   - When time is within the recorded history
+   * @return false
+   */
+  bool getPelvisIMUReadingAt(const ros::Time& time, sensor_msgs::Imu& msg);
+
+  /**
+   * @brief Get the Wrench on the foot at a given time, linearly interpolated.
+   *
+   * @param side                    - Side of the robot. It can be RIGHT or LEFT.
+   * @param time                    - Time of the query
+   * @param wrench                  - [output]
+   * @return true                   - When time is within the recorded history
+   * @return false
+   */
+  bool getFootWrenchAt(const RobotSide side, const ros::Time& time, geometry_msgs::Wrench& wrench);
+
+  /**
+   * @brief Get the Wrench on the wrist at a given time, linearly interpolated.
+   *
+   * @param side                    - Side of the robot. It can be RIGHT or LEFT.
+   * @param time                    - Time of the query
+   * @param wrench                  - [output]
+   * @return true                   - When time is within the recorded history
+   * @return false
+   */
+  bool getWristWrenchAt(const RobotSide side, const ros::Time& time, geometry_msgs::Wrench& wrench);
+
+  /**
+   * @brief Get the rate, latency and callback duration statistics of all the topics subscribed by this class. The
+   * same values are published on the diagnostics topic every second.
+   *
+   * @param statistics              - [output]
+   */
+  void getTopicStatistics(std::vector<TopicStatisticsSummary>& statistics);
+
+  /**
+   * @brief Get the rate, latency and callback duration statistics of a topic
+   *
+   * @param topic                   - Full name of the topic
+   * @param statistics              - [output]
+   * @return true                   - When the topic is subscribed by this class
+   * @return false
+   */
+  bool getTopicStatistics(const std::string& topic, TopicStatisticsSummary& statistics);
+
+  /**
+   * @brief Clear the statistics of all the topics
+   */
+  void resetTopicStatistics();
+
+  /**
+   * @brief Block until the predicate is true or the timeout expires. The predicate is evaluated again as soon as any
+   * of the subscribed topics is updated. By default callbacks are processed from this call, so it works in single
+   * threaded nodes as well. Nodes with a spinner thread must disable this with setSpinWhileWaiting.
+   *
+   * @param predicate               - Condition to wait for. It is called without holding any lock, so it can use
+   *                                  the getters of this class.
+   * @param timeout                 - Maximum time to wait. Use ros::DURATION_MAX to wait forever.
+   * @return true                   - When the predicate is true
+   * @return false                  - When the timeout expired or ros is shutting down
+   */
+  bool waitForCondition(const std::function<bool()>& predicate, const ros::Duration& timeout);
+
+  /**
+   * @brief Choose whether waitForCondition processes the callbacks of the global queue while it waits. Disable it in
+   * nodes that process callbacks with a ros::AsyncSpinner or a ros::MultiThreadedSpinner, the callbacks would
+   * otherwise run concurrently with the spinner and out of order.
+   *
+   * @param spin                    - true by default, call ros::spinOnce while waiting
+   */
+  void setSpinWhileWaiting(const bool spin);
+
+  /**
+   * @brief Wake up the threads blocked in waitForCondition so that they evaluate their predicate again. Called by every
+   * subscriber callback, and by other classes when a predicate depends on their state, e.g. a completed command.
+   */
+  void notifyStateUpdate();
+
+  /**
+   * @brief Block until a joint state message newer than the one available at the time of the call is received.
+   *
+   * @param timeout                 - Maximum time to wait.
+   * @return true                   - When a new joint state is received
+   * @return false
+   */
+  bool waitForNewJointState(const ros::Duration& timeout);
+
+  /**
+   * @brief Block until the robot is in double support.
+   *
+   * @param timeout                 - Maximum time to wait.
+   * @return true                   - When the robot is in double support
+   * @return false
+   */
+  bool waitForDoubleSupport(const ros::Duration& timeout);
 };
 
 #endif  // TOUGH_ROBOT_STATE_INFORMER_H
@@ -0,0 +1,112 @@
+#ifndef TOUGH_ROBOT_STATE_REPLAY_H
+#define TOUGH_ROBOT_STATE_REPLAY_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <rosbag/bag.h>
+#include <rosbag/view.h>
+#include "tough_common/robot_state.h"
+
+/**
+ * @brief RobotStateReplay feeds RobotStateInformer from a recorded bag instead of the IHMC controller. Joint states,
+ * pelvis IMU, center of mass, capture point, double support, foot and wrist wrenches and TF (/tf and /tf_static) are
+ * dispatched to the same callbacks that handle live messages, so every getter of RobotStateInformer works unchanged.
+ *
+ * Messages are dispatched synchronously from the calling thread in the order they were recorded. Before each message
+ * ros::Time is set to the time it was recorded at (this switches the process to simulated time), so a replay gives
+ * the same results every time and can run faster than real time.
+ *
+ * The bag can be recorded with rosbag record on the topics used by RobotStateInformer, optionally with --lz4 or --bz2
+ * to keep it small. Robot description parameters must be loaded on the parameter server as for a live robot.
+ */
+class RobotStateReplay
+{
+public:
+  /**
+   * @brief Create a replay that feeds the RobotStateInformer of this process
+   *
+   * @param nh                  ros Nodehandle
+   */
+  explicit RobotStateReplay(ros::NodeHandle nh);
+
+  // disable assign and copy
+  RobotStateReplay(RobotStateReplay const&) = delete;
+  void operator=(RobotStateReplay const&) = delete;
+
+  /**
+   * @brief Open a bag and rewind to its first message. Topics that are not used by RobotStateInformer are skipped.
+   *
+   * @param bagFile             path to the bag file
+   * @return true               when the bag could be opened
+   * @return false
+   */
+  bool open(const std::string& bagFile);
+
+  /**
+   * @brief Close the bag
+   */
+  void close();
+
+  /**
+   * @brief Dispatch the next message
+   *
+   * @return true               when a message was dispatched
+   * @return false              at the end of the bag
+   */
+  bool step();
+
+  /**
+   * @brief Dispatch all the messages recorded before or at the given time
+   *
+   * @param time                time in the bag
+   * @return true               when there are more messages after time
+   * @return false              at the end of the bag
+   */
+  bool playUntil(const ros::Time& time);
+
+  /**
+   * @brief Dispatch all the remaining messages
+   *
+   * @param rate                playback speed relative to the recording. 1.0 is real time, 0.0 dispatches the
+   *                            messages as fast as possible.
+   */
+  void play(const double rate = 0.0);
+
+  /**
+   * @brief Time of the last dispatched message
+   *
+   * @return ros::Time          zero before the first message
+   */
+  ros::Time getCurrentTime() const;
+
+  /**
+   * @brief Time of the first and the last message of the bag
+   *
+   * @param start               [output]
+   * @param end                 [output]
+   * @return true               when a bag is open
+   * @return false
+   */
+  bool getTimeRange(ros::Time& start, ros::Time& end) const;
+
+private:
+  typedef std::function<void(const rosbag::MessageInstance&)> MessageHandler;
+
+  RobotStateInformer* stateInformer_;
+  rosbag::Bag bag_;
+  std::unique_ptr<rosbag::View> view_;
+  rosbag::View::iterator next_;
+  std::map<std::string, MessageHandler> handlers_;
+  ros::Time currentTime_;
+
+  // handlers for callbacks that take a message pointer and a message reference
+  template <typename M>
+  void addHandler(const std::string& topic, void (RobotStateInformer::*callback)(boost::shared_ptr<M>));
+  template <typename M>
+  void addHandler(const std::string& topic, void (RobotStateInformer::*callback)(const M&));
+  void addTFHandler(const std::string& topic, const bool isStatic);
+};
+
+#endif  // TOUGH_ROBOT_STATE_REPLAY_H
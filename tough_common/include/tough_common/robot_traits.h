@@ -0,0 +1,175 @@
+#ifndef TOUGH_ROBOT_TRAITS_H
+#define TOUGH_ROBOT_TRAITS_H
+
+#include <string>
+#include <utility>
+#include <Eigen/Core>
+#include "tough_common/tough_common_names.h"
+
+/**
+ * @brief enum for the robots supported by open-humanoids-software.
+ */
+enum class RobotType
+{
+  UNKNOWN = 0,
+  ATLAS,
+  VALKYRIE
+};
+
+/**
+ * @brief Get the type of a robot from its name
+ *
+ * @param robot_name          value of the robot_name parameter
+ * @return RobotType          UNKNOWN for robots without traits
+ */
+inline RobotType getRobotType(const std::string& robot_name)
+{
+  if (robot_name == TOUGH_COMMON_NAMES::atlas)
+  {
+    return RobotType::ATLAS;
+  }
+  else if (robot_name == TOUGH_COMMON_NAMES::valkyrie)
+  {
+    return RobotType::VALKYRIE;
+  }
+  return RobotType::UNKNOWN;
+}
+
+/**
+ * @brief Joint counts of a robot known at compile time and the fixed size Eigen types built from them. Joint counts
+ * of RobotTraits<RobotType::UNKNOWN> are Eigen::Dynamic, so code templated on the traits compiles to fixed size,
+ * unrolled loops for known robots and to dynamic size loops for the others.
+ *
+ * Frame IDs are defined in us.ihmc.sensorProcessing.frames.CommonReferenceFrameIds and are the same for all robots.
+ */
+template <RobotType TYPE_, int NUM_ARM_JOINTS_, int NUM_NECK_JOINTS_, int NUM_CHEST_JOINTS_>
+struct RobotTraitsBase
+{
+  static constexpr RobotType TYPE = TYPE_;
+  static constexpr int NUM_ARM_JOINTS = NUM_ARM_JOINTS_;
+  static constexpr int NUM_NECK_JOINTS = NUM_NECK_JOINTS_;
+  static constexpr int NUM_CHEST_JOINTS = NUM_CHEST_JOINTS_;
+  // chains from pelvis to palm used for inverse kinematics include the chest joints
+  static constexpr int NUM_ARM_CHAIN_JOINTS = (NUM_ARM_JOINTS_ == Eigen::Dynamic || NUM_CHEST_JOINTS_ == Eigen::Dynamic) ?
+                                                  Eigen::Dynamic :
+                                                  NUM_ARM_JOINTS_ + NUM_CHEST_JOINTS_;
+
+  static constexpr int MIDFEET_ZUP_FRAME_ID = TOUGH_COMMON_NAMES::MIDFEET_ZUP_FRAME_HASH;
+  static constexpr int PELVIS_ZUP_FRAME_ID = TOUGH_COMMON_NAMES::PELVIS_ZUP_FRAME_HASH;
+  static constexpr int PELVIS_FRAME_ID = TOUGH_COMMON_NAMES::PELVIS_FRAME_HASH;
+  static constexpr int CHEST_FRAME_ID = TOUGH_COMMON_NAMES::CHEST_FRAME_HASH;
+  static constexpr int CENTER_OF_MASS_FRAME_ID = TOUGH_COMMON_NAMES::CENTER_OF_MASS_FRAME_HASH;
+  static constexpr int LEFT_SOLE_FRAME_ID = TOUGH_COMMON_NAMES::LEFT_SOLE_FRAME_HASH;
+  static constexpr int RIGHT_SOLE_FRAME_ID = TOUGH_COMMON_NAMES::RIGHT_SOLE_FRAME_HASH;
+  static constexpr int WORLD_FRAME_ID = TOUGH_COMMON_NAMES::WORLD_FRAME_HASH;
+
+  typedef Eigen::Matrix<double, NUM_ARM_JOINTS, 1> ArmVector;
+  typedef Eigen::Matrix<double, NUM_NECK_JOINTS, 1> NeckVector;
+  typedef Eigen::Matrix<double, NUM_CHEST_JOINTS, 1> ChestVector;
+  typedef Eigen::Matrix<double, NUM_ARM_CHAIN_JOINTS, 1> ArmChainVector;
+};
+
+/**
+ * @brief Traits of a robot without compile time specialization. All the sizes are dynamic and must be read from
+ * RobotDescription.
+ */
+template <RobotType TYPE>
+struct RobotTraits : public RobotTraitsBase<RobotType::UNKNOWN, Eigen::Dynamic, Eigen::Dynamic, Eigen::Dynamic>
+{
+  static constexpr bool IS_KNOWN = false;
+  static constexpr double FOOT_FRAME_OFFSET = 0.0;
+};
+
+template <>
+struct RobotTraits<RobotType::ATLAS> : public RobotTraitsBase<RobotType::ATLAS, 7, 1, 3>
+{
+  static constexpr bool IS_KNOWN = true;
+  // With 0.11 version of open-robotics-software, the foot offset is not handled on JAVA side
+  static constexpr double FOOT_FRAME_OFFSET = 0.085;
+};
+
+template <>
+struct RobotTraits<RobotType::VALKYRIE> : public RobotTraitsBase<RobotType::VALKYRIE, 7, 3, 3>
+{
+  static constexpr bool IS_KNOWN = true;
+  static constexpr double FOOT_FRAME_OFFSET = 0.102;
+};
+
+/**
+ * @brief Call a visitor with the traits of a robot type known only at runtime. The visitor must provide a templated
+ * call operator taking the traits by value, e.g.
+ *
+ *   struct Visitor
+ *   {
+ *     template <typename Traits>
+ *     void operator()(Traits) const;
+ *   };
+ *
+ * Unknown robots are dispatched to RobotTraits<RobotType::UNKNOWN>.
+ *
+ * @param type                type of the robot
+ * @param visitor             functor called with an instance of the traits
+ */
+template <typename Visitor>
+void dispatchRobotTraits(const RobotType type, Visitor&& visitor)
+{
+  switch (type)
+  {
+    case RobotType::ATLAS:
+      std::forward<Visitor>(visitor)(RobotTraits<RobotType::ATLAS>());
+      break;
+    case RobotType::VALKYRIE:
+      std::forward<Visitor>(visitor)(RobotTraits<RobotType::VALKYRIE>());
+      break;
+    default:
+      std::forward<Visitor>(visitor)(RobotTraits<RobotType::UNKNOWN>());
+      break;
+  }
+}
+
+/**
+ * @brief Runtime copy of the constants in RobotTraits, for code that is not templated on the robot
+ */
+struct RobotConstants
+{
+  RobotType type;
+  bool is_known;
+  int num_arm_joints;        // Eigen::Dynamic when the robot is unknown
+  int num_neck_joints;       // Eigen::Dynamic when the robot is unknown
+  int num_chest_joints;      // Eigen::Dynamic when the robot is unknown
+  double foot_frame_offset;  // zero when the robot is unknown
+};
+
+namespace robot_traits_detail
+{
+struct GetRobotConstants
+{
+  RobotConstants& constants;
+
+  template <typename Traits>
+  void operator()(Traits) const
+  {
+    constants.type = Traits::TYPE;
+    constants.is_known = Traits::IS_KNOWN;
+    constants.num_arm_joints = Traits::NUM_ARM_JOINTS;
+    constants.num_neck_joints = Traits::NUM_NECK_JOINTS;
+    constants.num_chest_joints = Traits::NUM_CHEST_JOINTS;
+    constants.foot_frame_offset = Traits::FOOT_FRAME_OFFSET;
+  }
+};
+}  // namespace robot_traits_detail
+
+/**
+ * @brief Get the constants of a robot type known only at runtime
+ *
+ * @param type                type of the robot
+ * @return RobotConstants     is_known is false and the joint counts are Eigen::Dynamic for unknown robots
+ */
+inline RobotConstants getRobotConstants(const RobotType type)
+{
+  RobotConstants constants;
+  dispatchRobotTraits(type, robot_traits_detail::GetRobotConstants{ constants });
+  return constants;
+}
+
+#endif  // TOUGH_ROBOT_TRAITS_H
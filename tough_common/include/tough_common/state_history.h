@@ -0,0 +1,242 @@
+#ifndef TOUGH_STATE_HISTORY_H
+#define TOUGH_STATE_HISTORY_H
+
+#include <ros/time.h>
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief StateHistory is a ring buffer of time stamped samples that keeps a window of the most recent time. The buffer
+ * grows until it holds a window worth of samples, so the number of samples adapts to the rate of the signal. Once it
+ * covers the window (or reaches the maximum capacity), the oldest sample is overwritten. Slots are reused, so a sample
+ * that owns memory (like a std::vector) does not allocate once the buffer has stopped growing.
+ *
+ * Samples are expected in increasing order of time. If an older stamp is pushed (for example when simulation time is
+ * reset) the history is cleared.
+ *
+ * Queries copy the two samples around the query time out of the buffer and combine them without holding the lock, so
+ * the writer waits at most for the copy of two samples.
+ *
+ * @tparam T    type of the sample
+ */
+template <typename T>
+class StateHistory
+{
+public:
+  static constexpr double DEFAULT_WINDOW = 2.0;  // seconds
+  static const size_t DEFAULT_MAX_CAPACITY = 100000;
+
+  /**
+   * @brief Create a history that keeps the samples of the last window of time
+   *
+   * @param window          time covered by the history
+   * @param max_capacity    upper bound on the number of samples, in case a signal is published faster than expected
+   */
+  explicit StateHistory(const ros::Duration& window = ros::Duration(DEFAULT_WINDOW),
+                        const size_t max_capacity = DEFAULT_MAX_CAPACITY)
+    : window_(window), maxCapacity_(max_capacity), oldest_(0), size_(0)
+  {
+  }
+
+  /**
+   * @brief Create a history with a fixed number of samples, whatever time they cover
+   *
+   * @param capacity        number of samples
+   */
+  explicit StateHistory(const size_t capacity)
+    : stamps_(capacity), values_(capacity), window_(), maxCapacity_(capacity), oldest_(0), size_(0)
+  {
+  }
+
+  // disable assign and copy
+  StateHistory(StateHistory const&) = delete;
+  void operator=(StateHistory const&) = delete;
+
+  /**
+   * @brief Set the time covered by the history. Samples already recorded are kept.
+   *
+   * @param window          time covered by the history
+   */
+  void setWindow(const ros::Duration& window)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    window_ = window;
+  }
+
+  /**
+   * @brief Add a sample to the history by assigning it in place.
+   *
+   * @param stamp           time of the sample
+   * @param assign          callable with signature void(T& slot) that writes the sample into the slot
+   */
+  template <typename Assign>
+  void emplace(const ros::Time& stamp, Assign assign)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (size_ > 0 && stamp < stamps_[physicalIndex(size_ - 1)])
+    {
+      size_ = 0;
+      oldest_ = 0;
+    }
+
+    size_t slot;
+    if (size_ < values_.size())
+    {
+      slot = physicalIndex(size_);
+      ++size_;
+    }
+    else if (values_.size() < maxCapacity_ && (size_ == 0 || stamp - stamps_[oldest_] <= window_))
+    {
+      // the history does not cover the window yet, move the oldest sample to the front and append a slot
+      std::rotate(stamps_.begin(), stamps_.begin() + oldest_, stamps_.end());
+      std::rotate(values_.begin(), values_.begin() + oldest_, values_.end());
+      oldest_ = 0;
+      stamps_.emplace_back();
+      values_.emplace_back();
+      slot = size_;
+      ++size_;
+    }
+    else
+    {
+      slot = oldest_;
+      oldest_ = (oldest_ + 1) % values_.size();
+    }
+    stamps_[slot] = stamp;
+    assign(values_[slot]);
+  }
+
+  /**
+   * @brief Add a sample to the history
+   *
+   * @param stamp           time of the sample
+   * @param value           sample
+   */
+  void push(const ros::Time& stamp, const T& value)
+  {
+    emplace(stamp, [&value](T& slot) { slot = value; });
+  }
+
+  /**
+   * @brief Find the two samples around the given time and combine them.
+   *
+   * @param time            time of the query
+   * @param result          [output]
+   * @param combine         callable with signature void(const T& before, const T& after, double ratio, Result&
+   *                        result). ratio is 0 at before and 1 at after.
+   * @return true           when time is within the history
+   * @return false          when time is older than the oldest sample or newer than the latest sample
+   */
+  template <typename Result, typename Combine>
+  bool interpolate(const ros::Time& time, Result& result, Combine combine) const
+  {
+    T before;
+    T after;
+    double ratio;
+    if (!copyBracket(time, before, after, ratio))
+    {
+      return false;
+    }
+    combine(before, after, ratio, result);
+    return true;
+  }
+
+  /**
+   * @brief Copy the two samples around the given time
+   *
+   * @param time            time of the query
+   * @param before          [output] latest sample at or before time
+   * @param after           [output] first sample after time, the same as before when time is the latest stamp
+   * @param ratio           [output] position of time between the samples, 0 at before and 1 at after
+   * @return true           when time is within the history
+   * @return false          when time is older than the oldest sample or newer than the latest sample
+   */
+  bool copyBracket(const ros::Time& time, T& before, T& after, double& ratio) const
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (size_ == 0 || time < stamps_[physicalIndex(0)] || time > stamps_[physicalIndex(size_ - 1)])
+    {
+      return false;
+    }
+
+    // first sample that is newer than time
+    size_t low = 0, high = size_;
+    while (low < high)
+    {
+      size_t mid = (low + high) / 2;
+      if (stamps_[physicalIndex(mid)] <= time)
+      {
+        low = mid + 1;
+      }
+      else
+      {
+        high = mid;
+      }
+    }
+
+    if (low == size_)
+    {
+      // time is the stamp of the latest sample
+      before = values_[physicalIndex(size_ - 1)];
+      after = before;
+      ratio = 0.0;
+      return true;
+    }
+
+    size_t beforeIndex = physicalIndex(low - 1);
+    size_t afterIndex = physicalIndex(low);
+    double duration = (stamps_[afterIndex] - stamps_[beforeIndex]).toSec();
+    ratio = duration > 0.0 ? (time - stamps_[beforeIndex]).toSec() / duration : 0.0;
+    before = values_[beforeIndex];
+    after = values_[afterIndex];
+    return true;
+  }
+
+  /**
+   * @brief Number of samples in the history
+   *
+   * @return size_t
+   */
+  size_t size() const
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return size_;
+  }
+
+  /**
+   * @brief Get the time range covered by the history
+   *
+   * @param oldest          [output] stamp of the oldest sample
+   * @param latest          [output] stamp of the latest sample
+   * @return true           when the history is not empty
+   * @return false
+   */
+  bool getTimeRange(ros::Time& oldest, ros::Time& latest) const
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (size_ == 0)
+    {
+      return false;
+    }
+    oldest = stamps_[physicalIndex(0)];
+    latest = stamps_[physicalIndex(size_ - 1)];
+    return true;
+  }
+
+private:
+  std::vector<ros::Time> stamps_;
+  std::vector<T> values_;
+  ros::Duration window_;
+  size_t maxCapacity_;
+  size_t oldest_;
+  size_t size_;
+  mutable std::mutex mutex_;
+
+  // converts index from the oldest sample to index in the storage
+  inline size_t physicalIndex(const size_t index) const
+  {
+    return (oldest_ + index) % values_.size();
+  }
+};
+
+#endif  // TOUGH_STATE_HISTORY_H
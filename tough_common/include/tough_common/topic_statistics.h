@@ -0,0 +1,180 @@
+#ifndef TOUGH_TOPIC_STATISTICS_H
+#define TOUGH_TOPIC_STATISTICS_H
+
+#include <ros/time.h>
+#include <std_msgs/Header.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <stdint.h>
+
+/**
+ * @brief Summary of the values recorded in a LatencyHistogram. All the values are in seconds.
+ */
+struct HistogramSummary
+{
+  uint64_t count;
+  double min;
+  double max;
+  double mean;
+  double p50;
+  double p90;
+  double p99;
+};
+
+/**
+ * @brief LatencyHistogram records durations in log-linear buckets, similar to an HDR histogram. Every power of two is
+ * split in 16 buckets, so the reported percentiles are within about 6% of the recorded value. Durations are stored in
+ * microseconds and are clamped to about 70 minutes.
+ *
+ * Recording is lock free and does not allocate, it can be used from callbacks while other threads read the summary.
+ */
+class LatencyHistogram
+{
+public:
+  LatencyHistogram();
+
+  // disable assign and copy
+  LatencyHistogram(LatencyHistogram const&) = delete;
+  void operator=(LatencyHistogram const&) = delete;
+
+  /**
+   * @brief Record a duration. Negative durations are recorded as zero.
+   *
+   * @param seconds
+   */
+  void record(const double seconds);
+
+  /**
+   * @brief Get the count, min, max, mean and percentiles of the recorded durations
+   *
+   * @param summary           [output] all zeros when nothing has been recorded
+   */
+  void getSummary(HistogramSummary& summary) const;
+
+  /**
+   * @brief Remove all the recorded values
+   */
+  void reset();
+
+private:
+  static const int SUB_BUCKET_BITS = 4;
+  static const uint64_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+  static const int MAX_VALUE_BITS = 32;
+  static const size_t NUM_BUCKETS = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+  std::atomic<uint64_t> buckets_[NUM_BUCKETS];
+  std::atomic<uint64_t> sum_;
+  std::atomic<uint64_t> min_;
+  std::atomic<uint64_t> max_;
+
+  static size_t bucketIndex(const uint64_t value);
+  static uint64_t bucketValue(const size_t index);
+};
+
+/**
+ * @brief Summary of the statistics of a topic
+ */
+struct TopicStatisticsSummary
+{
+  std::string topic;
+  uint64_t messageCount;
+  uint64_t droppedCount;              // gaps in the header sequence number
+  ros::Time lastReceiptTime;          // zero if no message was received
+  double rate;                        // messages per second, from the mean inter-arrival time
+  HistogramSummary interArrival;      // time between two messages
+  HistogramSummary age;               // receipt time - header stamp. Empty for messages without a header
+  HistogramSummary callbackDuration;  // wall time spent in the callback
+};
+
+/**
+ * @brief TopicStatistics tracks the number of messages, inter-arrival time, age of the message at receipt and the
+ * duration of the callback for one subscriber.
+ *
+ * Create a CallbackTimer at the beginning of the callback. It records the receipt and the callback duration when it
+ * goes out of scope.
+ */
+class TopicStatistics
+{
+public:
+  explicit TopicStatistics(const std::string& topic = "");
+
+  // disable assign and copy
+  TopicStatistics(TopicStatistics const&) = delete;
+  void operator=(TopicStatistics const&) = delete;
+
+  /**
+   * @brief Set the name of the topic reported in the summary. Call this before the subscriber is created.
+   *
+   * @param topic
+   */
+  void setTopic(const std::string& topic);
+
+  /**
+   * @brief Name of the topic
+   *
+   * @return const std::string&
+   */
+  const std::string& getTopic() const;
+
+  /**
+   * @brief Record the receipt of a message with a header. Age is computed from the stamp and dropped messages are
+   * counted from the sequence number.
+   *
+   * @param header            header of the message
+   */
+  void recordReceipt(const std_msgs::Header& header);
+
+  /**
+   * @brief Record the receipt of a message without a header
+   */
+  void recordReceipt();
+
+  /**
+   * @brief Record the time spent in the callback
+   *
+   * @param seconds
+   */
+  void recordCallbackDuration(const double seconds);
+
+  /**
+   * @brief Get the statistics of the topic
+   *
+   * @param summary           [output]
+   */
+  void getSummary(TopicStatisticsSummary& summary) const;
+
+  /**
+   * @brief Remove all the recorded values
+   */
+  void reset();
+
+  /**
+   * @brief Records the receipt on construction and the callback duration on destruction
+   */
+  class CallbackTimer
+  {
+  public:
+    CallbackTimer(TopicStatistics& statistics, const std_msgs::Header& header);
+    explicit CallbackTimer(TopicStatistics& statistics);
+    ~CallbackTimer();
+
+  private:
+    TopicStatistics& statistics_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+private:
+  std::string topic_;
+  std::atomic<uint64_t> messageCount_;
+  std::atomic<uint64_t> droppedCount_;
+  std::atomic<uint64_t> lastReceiptNSec_;
+  std::atomic<int64_t> lastSequence_;
+  LatencyHistogram interArrival_;
+  LatencyHistogram age_;
+  LatencyHistogram callbackDuration_;
+
+  void recordReceipt(const ros::Time& stamp);
+};
+
+#endif  // TOUGH_TOPIC_STATISTICS_H
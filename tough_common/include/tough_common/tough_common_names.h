@@ -14,10 +14,13 @@ const std::string ROBOT_NAME_PARAM = "/ihmc_ros/robot_name";
 const std::string LEFT_ARM_JOINT_NAMES_PARAM = "left_arm_joint_names";
 const std::string RIGHT_ARM_JOINT_NAMES_PARAM = "right_arm_joint_names";
 const std::string CHEST_JOINT_NAMES_PARAM = "chest_joint_names";
+const std::string LEFT_GRIPPER_JOINT_NAMES_PARAM = "left_gripper_joint_names";
+const std::string RIGHT_GRIPPER_JOINT_NAMES_PARAM = "right_gripper_joint_names";
 const std::string LEFT_FOOT_FRAME_NAME_PARAM = "left_foot_frame_name";
 const std::string RIGHT_FOOT_FRAME_NAME_PARAM = "right_foot_frame_name";
 const std::string LEFT_EE_FRAME_NAME_PARAM = "left_ee_frame_name";
 const std::string RIGHT_EE_FRAME_NAME_PARAM = "right_ee_frame_name";
+const std::string STATE_HISTORY_DURATION_PARAM = "state_history_duration";
 
 /********* Topic Names *********/
 const std::string TOPIC_PREFIX = "/ihmc_ros/";
@@ -60,6 +63,9 @@ const std::string RIGHT_WRIST_FORCE_SENSOR_TOPIC = "/wrist_force_sensor/right";
 const std::string NAVIGATION_GOAL_TOPIC = "/goal";
 const std::string APPROVE_FOOTSTEPS_TOPIC = "/approve_footsteps";
 
+/* Diagnostics */
+const std::string DIAGNOSTICS_TOPIC = "/diagnostics";
+
 /********* Frame Hash from IHMC controllers *********/
 const int MIDFEET_ZUP_FRAME_HASH = -100;
 const int PELVIS_ZUP_FRAME_HASH = -101;
@@ -0,0 +1,241 @@
+#include "tough_common/command_tracer.h"
+#include "tough_common/robot_state.h"
+#include <algorithm>
+#include <cmath>
+
+constexpr double CommandTracer::TRACE_TIMEOUT;
+const size_t CommandTracer::MAX_CONSTRUCTIONS;
+
+namespace
+{
+inline double secondsBetween(const std::chrono::steady_clock::time_point start,
+                             const std::chrono::steady_clock::time_point end)
+{
+  return std::chrono::duration<double>(end - start).count();
+}
+}  // namespace
+
+CommandTracer* CommandTracer::getCommandTracer()
+{
+  static CommandTracer obj;
+  return &obj;
+}
+
+CommandTracer::CommandTracer() : activeTraces_(0), motionThreshold_(0.002)
+{
+}
+
+CommandTracer::TypeStatistics* CommandTracer::getStatistics(const std::string& type)
+{
+  std::unique_ptr<TypeStatistics>& statistics = statistics_[type];
+  if (!statistics)
+  {
+    statistics.reset(new TypeStatistics());
+  }
+  return statistics.get();
+}
+
+void CommandTracer::recordConstruction(const std::string& type, const long uniqueId)
+{
+  const Clock::time_point now = Clock::now();
+  std::lock_guard<std::mutex> guard(mutex_);
+  expireConstructions(now);
+  if (constructions_.size() < MAX_CONSTRUCTIONS)
+  {
+    constructions_[TraceKey(type, uniqueId)] = now;
+  }
+}
+
+void CommandTracer::recordPublish(const std::string& type, const long uniqueId,
+                                  const std::vector<std::string>& jointNames, const Clock::time_point constructionTime)
+{
+  const Clock::time_point now = Clock::now();
+  const TraceKey key(type, uniqueId);
+  std::lock_guard<std::mutex> guard(mutex_);
+  expireTraces(now);
+
+  Trace& trace = traces_[key];
+  trace.statistics = getStatistics(type);
+  trace.jointNames = jointNames;
+  trace.joints = JointGroupHandle();
+  trace.resolved = false;
+  trace.hasConstruction = constructionTime != Clock::time_point();
+  trace.constructionTime = constructionTime;
+  trace.publishTime = now;
+  trace.acknowledged = false;
+  trace.reference.clear();
+
+  auto construction = constructions_.find(key);
+  if (construction != constructions_.end())
+  {
+    if (!trace.hasConstruction)
+    {
+      trace.hasConstruction = true;
+      trace.constructionTime = construction->second;
+    }
+    constructions_.erase(construction);
+  }
+
+  trace.statistics->published++;
+  if (trace.hasConstruction)
+  {
+    trace.statistics->construction.record(secondsBetween(trace.constructionTime, now));
+  }
+  activeTraces_ = traces_.size();
+}
+
+void CommandTracer::recordAcknowledgement(const std::string& type, const long uniqueId)
+{
+  const Clock::time_point now = Clock::now();
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = traces_.find(TraceKey(type, uniqueId));
+  if (it == traces_.end() || it->second.acknowledged)
+  {
+    return;
+  }
+  it->second.acknowledged = true;
+  it->second.statistics->acknowledgement.record(secondsBetween(it->second.publishTime, now));
+}
+
+void CommandTracer::recordJointState(RobotStateInformer* stateInformer, const sensor_msgs::JointState& msg)
+{
+  if (activeTraces_ == 0)
+  {
+    return;
+  }
+
+  const Clock::time_point now = Clock::now();
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto it = traces_.begin(); it != traces_.end();)
+  {
+    Trace& trace = it->second;
+    if (!trace.resolved)
+    {
+      trace.joints = stateInformer->getJointGroupHandle(trace.jointNames.empty() ? msg.name : trace.jointNames);
+      trace.resolved = true;
+    }
+    if (!trace.joints.getPositions(positions_))
+    {
+      ++it;
+      continue;
+    }
+    if (trace.reference.empty())
+    {
+      trace.reference = positions_;
+      ++it;
+      continue;
+    }
+
+    bool moved = false;
+    for (size_t i = 0; i < positions_.size() && !moved; ++i)
+    {
+      moved = std::fabs(positions_[i] - trace.reference[i]) > motionThreshold_;
+    }
+    if (moved)
+    {
+      trace.statistics->motionOnset.record(secondsBetween(trace.publishTime, now));
+      if (trace.hasConstruction)
+      {
+        trace.statistics->endToEnd.record(secondsBetween(trace.constructionTime, now));
+      }
+      it = traces_.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+  expireTraces(now);
+}
+
+void CommandTracer::expireTraces(const Clock::time_point now)
+{
+  for (auto it = traces_.begin(); it != traces_.end();)
+  {
+    if (secondsBetween(it->second.publishTime, now) > TRACE_TIMEOUT)
+    {
+      it->second.statistics->withoutMotion++;
+      it = traces_.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+  activeTraces_ = traces_.size();
+}
+
+void CommandTracer::expireConstructions(const Clock::time_point now)
+{
+  // messages that were built but never published are not counted
+  for (auto it = constructions_.begin(); it != constructions_.end();)
+  {
+    if (secondsBetween(it->second, now) > TRACE_TIMEOUT)
+    {
+      it = constructions_.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+void CommandTracer::setMotionThreshold(const double threshold)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  motionThreshold_ = std::fabs(threshold);
+}
+
+void CommandTracer::fillSummary(const std::string& type, const TypeStatistics& statistics,
+                                CommandLatencySummary& summary) const
+{
+  summary.type = type;
+  summary.published = statistics.published;
+  summary.withoutMotion = statistics.withoutMotion;
+  statistics.construction.getSummary(summary.construction);
+  statistics.acknowledgement.getSummary(summary.acknowledgement);
+  statistics.motionOnset.getSummary(summary.motionOnset);
+  statistics.endToEnd.getSummary(summary.endToEnd);
+}
+
+void CommandTracer::getLatencySummaries(std::vector<CommandLatencySummary>& summaries) const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  summaries.resize(statistics_.size());
+  size_t i = 0;
+  for (const auto& statistics : statistics_)
+  {
+    fillSummary(statistics.first, *statistics.second, summaries[i++]);
+  }
+}
+
+bool CommandTracer::getLatencySummary(const std::string& type, CommandLatencySummary& summary) const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = statistics_.find(type);
+  if (it == statistics_.end())
+  {
+    return false;
+  }
+  fillSummary(it->first, *it->second, summary);
+  return true;
+}
+
+void CommandTracer::reset()
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  traces_.clear();
+  constructions_.clear();
+  activeTraces_ = 0;
+  // histograms are reset in place, traces of other threads may still point to them
+  for (auto& statistics : statistics_)
+  {
+    statistics.second->published = 0;
+    statistics.second->withoutMotion = 0;
+    statistics.second->construction.reset();
+    statistics.second->acknowledgement.reset();
+    statistics.second->motionOnset.reset();
+    statistics.second->endToEnd.reset();
+  }
+}
@@ -0,0 +1,267 @@
+#include "tough_common/description_cache.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+const uint32_t CACHE_MAGIC = 0x48475554;  // "TUGH"
+// increment when the order or the type of the cached values changes
+const uint32_t CACHE_VERSION = 2;
+const size_t HEADER_SIZE = sizeof(uint32_t) * 2 + sizeof(uint64_t);
+const uint64_t FNV_PRIME = 1099511628211ULL;
+}  // namespace
+
+DescriptionCacheWriter::DescriptionCacheWriter(const uint64_t key)
+{
+  append(&CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  append(&CACHE_VERSION, sizeof(CACHE_VERSION));
+  append(&key, sizeof(key));
+}
+
+void DescriptionCacheWriter::append(const void* data, const size_t size)
+{
+  buffer_.append(static_cast<const char*>(data), size);
+}
+
+void DescriptionCacheWriter::write(const int32_t value)
+{
+  append(&value, sizeof(value));
+}
+
+void DescriptionCacheWriter::write(const double value)
+{
+  append(&value, sizeof(value));
+}
+
+void DescriptionCacheWriter::write(const std::string& value)
+{
+  write(static_cast<int32_t>(value.size()));
+  append(value.data(), value.size());
+}
+
+void DescriptionCacheWriter::write(const std::vector<std::string>& values)
+{
+  write(static_cast<int32_t>(values.size()));
+  for (const auto& value : values)
+  {
+    write(value);
+  }
+}
+
+void DescriptionCacheWriter::write(const std::vector<std::pair<double, double> >& values)
+{
+  write(static_cast<int32_t>(values.size()));
+  for (const auto& value : values)
+  {
+    write(value.first);
+    write(value.second);
+  }
+}
+
+void DescriptionCacheWriter::write(const Eigen::VectorXd& values)
+{
+  write(static_cast<int32_t>(values.size()));
+  append(values.data(), values.size() * sizeof(double));
+}
+
+bool DescriptionCacheWriter::save(const std::string& fileName) const
+{
+  // unique per process, several nodes may write the same cache at the same time
+  std::string tempFileName = fileName + "." + std::to_string(getpid());
+  FILE* file = fopen(tempFileName.c_str(), "wb");
+  if (file == nullptr)
+  {
+    return false;
+  }
+  bool written = fwrite(buffer_.data(), 1, buffer_.size(), file) == buffer_.size();
+  written = (fclose(file) == 0) && written;
+  if (!written || rename(tempFileName.c_str(), fileName.c_str()) != 0)
+  {
+    unlink(tempFileName.c_str());
+    return false;
+  }
+  return true;
+}
+
+DescriptionCacheReader::DescriptionCacheReader() : data_(nullptr), size_(0), offset_(0)
+{
+}
+
+DescriptionCacheReader::~DescriptionCacheReader()
+{
+  close();
+}
+
+bool DescriptionCacheReader::open(const std::string& fileName, const uint64_t key)
+{
+  close();
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(HEADER_SIZE))
+  {
+    ::close(fd);
+    return false;
+  }
+
+  void* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping stays valid after the file is closed
+  ::close(fd);
+  if (data == MAP_FAILED)
+  {
+    return false;
+  }
+  data_ = static_cast<const char*>(data);
+  size_ = fileStat.st_size;
+  offset_ = 0;
+
+  uint32_t magic, version;
+  uint64_t fileKey;
+  if (!extract(&magic, sizeof(magic)) || !extract(&version, sizeof(version)) || !extract(&fileKey, sizeof(fileKey)) ||
+      magic != CACHE_MAGIC || version != CACHE_VERSION || fileKey != key)
+  {
+    close();
+    return false;
+  }
+  return true;
+}
+
+void DescriptionCacheReader::close()
+{
+  if (data_ != nullptr)
+  {
+    munmap(const_cast<char*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  offset_ = 0;
+}
+
+bool DescriptionCacheReader::extract(void* data, const size_t size)
+{
+  if (data_ == nullptr || size > size_ - offset_)
+  {
+    return false;
+  }
+  // values are not aligned in the file
+  std::memcpy(data, data_ + offset_, size);
+  offset_ += size;
+  return true;
+}
+
+bool DescriptionCacheReader::read(int32_t& value)
+{
+  return extract(&value, sizeof(value));
+}
+
+bool DescriptionCacheReader::read(double& value)
+{
+  return extract(&value, sizeof(value));
+}
+
+bool DescriptionCacheReader::read(std::string& value)
+{
+  int32_t size;
+  if (!read(size) || size < 0 || static_cast<size_t>(size) > size_ - offset_)
+  {
+    return false;
+  }
+  value.assign(data_ + offset_, size);
+  offset_ += size;
+  return true;
+}
+
+bool DescriptionCacheReader::read(std::vector<std::string>& values)
+{
+  int32_t size;
+  // every string takes at least its size, this keeps a corrupted size from allocating a huge vector
+  if (!read(size) || size < 0 || static_cast<size_t>(size) > (size_ - offset_) / sizeof(int32_t))
+  {
+    return false;
+  }
+  values.resize(size);
+  for (auto& value : values)
+  {
+    if (!read(value))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DescriptionCacheReader::read(std::vector<std::pair<double, double> >& values)
+{
+  int32_t size;
+  if (!read(size) || size < 0 || static_cast<size_t>(size) > (size_ - offset_) / (2 * sizeof(double)))
+  {
+    return false;
+  }
+  values.resize(size);
+  for (auto& value : values)
+  {
+    if (!read(value.first) || !read(value.second))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DescriptionCacheReader::read(Eigen::VectorXd& values)
+{
+  int32_t size;
+  if (!read(size) || size < 0 || static_cast<size_t>(size) > (size_ - offset_) / sizeof(double))
+  {
+    return false;
+  }
+  values.resize(size);
+  return extract(values.data(), size * sizeof(double));
+}
+
+bool DescriptionCacheReader::atEnd() const
+{
+  return data_ != nullptr && offset_ == size_;
+}
+
+uint64_t hashDescription(const std::string& data, const uint64_t seed)
+{
+  uint64_t hash = seed;
+  for (const char c : data)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+std::string getDescriptionCacheFile(const std::string& robotName)
+{
+  std::string directory;
+  const char* rosHome = std::getenv("ROS_HOME");
+  const char* home = std::getenv("HOME");
+  if (rosHome != nullptr)
+  {
+    directory = rosHome;
+  }
+  else if (home != nullptr)
+  {
+    directory = std::string(home) + "/.ros";
+  }
+  else
+  {
+    return "";
+  }
+  // the directory usually exists already, created by roslaunch for the logs
+  mkdir(directory.c_str(), 0775);
+  return directory + "/tough_" + robotName + "_description.cache";
+}
@@ -0,0 +1,191 @@
+#include "tough_common/forward_kinematics.h"
+#include <ros/console.h>
+#include <deque>
+
+namespace
+{
+Eigen::Affine3d poseToEigen(const urdf::Pose& pose)
+{
+  Eigen::Affine3d transform;
+  transform.matrix().setIdentity();
+  transform.linear() =
+      Eigen::Quaterniond(pose.rotation.w, pose.rotation.x, pose.rotation.y, pose.rotation.z).toRotationMatrix();
+  transform.translation() = Eigen::Vector3d(pose.position.x, pose.position.y, pose.position.z);
+  return transform;
+}
+
+inline const std::string stripSlash(const std::string& frameName)
+{
+  return (!frameName.empty() && frameName[0] == '/') ? frameName.substr(1) : frameName;
+}
+}  // namespace
+
+ForwardKinematics::ForwardKinematics(const urdf::Model& model)
+{
+  urdf::LinkConstSharedPtr root = model.getRoot();
+  if (!root)
+  {
+    ROS_ERROR("URDF does not have a root link, forward kinematics is disabled");
+    return;
+  }
+  rootFrame_ = root->name;
+
+  Link rootLink;
+  rootLink.parent = -1;
+  rootLink.type = urdf::Joint::FIXED;
+  rootLink.origin.matrix().setIdentity();
+  rootLink.axis.setZero();
+  rootLink.multiplier = 1.0;
+  rootLink.offset = 0.0;
+  rootLink.jointIndex = -1;
+  links_.push_back(rootLink);
+  linkIndices_[root->name] = 0;
+
+  // breadth first so that parents are stored before children
+  std::deque<urdf::LinkConstSharedPtr> queue(1, root);
+  while (!queue.empty())
+  {
+    urdf::LinkConstSharedPtr link = queue.front();
+    queue.pop_front();
+    int parent = linkIndices_[link->name];
+
+    for (const auto& joint : link->child_joints)
+    {
+      urdf::LinkConstSharedPtr child = model.getLink(joint->child_link_name);
+      if (!child)
+      {
+        continue;
+      }
+
+      Link childLink;
+      childLink.parent = parent;
+      childLink.type = joint->type;
+      childLink.origin = poseToEigen(joint->parent_to_joint_origin_transform);
+      childLink.axis = Eigen::Vector3d(joint->axis.x, joint->axis.y, joint->axis.z);
+      if (childLink.axis.norm() > 0.0)
+      {
+        childLink.axis.normalize();
+      }
+      childLink.jointName = joint->name;
+      childLink.multiplier = 1.0;
+      childLink.offset = 0.0;
+      childLink.jointIndex = -1;
+      if (joint->mimic)
+      {
+        childLink.jointName = joint->mimic->joint_name;
+        childLink.multiplier = joint->mimic->multiplier;
+        childLink.offset = joint->mimic->offset;
+      }
+
+      linkIndices_[child->name] = links_.size();
+      links_.push_back(childLink);
+      queue.push_back(child);
+    }
+  }
+
+  poses_.resize(links_.size(), Eigen::Affine3d::Identity());
+  known_.resize(links_.size(), false);
+}
+
+bool ForwardKinematics::isValid() const
+{
+  return !links_.empty();
+}
+
+const std::string& ForwardKinematics::getRootFrame() const
+{
+  return rootFrame_;
+}
+
+bool ForwardKinematics::getLinkIndex(const std::string& frameName, size_t& index) const
+{
+  auto it = linkIndices_.find(stripSlash(frameName));
+  if (it == linkIndices_.end())
+  {
+    return false;
+  }
+  index = it->second;
+  return true;
+}
+
+bool ForwardKinematics::hasFrame(const std::string& frameName) const
+{
+  size_t index;
+  return getLinkIndex(frameName, index);
+}
+
+void ForwardKinematics::setJointNames(const std::vector<std::string>& jointNames)
+{
+  std::unordered_map<std::string, int> jointIndices;
+  for (size_t i = 0; i < jointNames.size(); ++i)
+  {
+    jointIndices[jointNames[i]] = i;
+  }
+
+  for (auto& link : links_)
+  {
+    auto it = jointIndices.find(link.jointName);
+    link.jointIndex = it == jointIndices.end() ? -1 : it->second;
+  }
+}
+
+void ForwardKinematics::update(const std::vector<double>& positions)
+{
+  if (!isValid())
+  {
+    return;
+  }
+
+  known_[0] = true;
+  for (size_t i = 1; i < links_.size(); ++i)
+  {
+    const Link& link = links_[i];
+    bool movable = link.type == urdf::Joint::REVOLUTE || link.type == urdf::Joint::CONTINUOUS ||
+                   link.type == urdf::Joint::PRISMATIC;
+    bool hasPosition = link.jointIndex >= 0 && static_cast<size_t>(link.jointIndex) < positions.size();
+
+    known_[i] = known_[link.parent] && (!movable || hasPosition);
+    if (!known_[i])
+    {
+      continue;
+    }
+
+    Eigen::Affine3d& pose = poses_[i];
+    pose = poses_[link.parent] * link.origin;
+    if (movable)
+    {
+      double q = positions[link.jointIndex] * link.multiplier + link.offset;
+      if (link.type == urdf::Joint::PRISMATIC)
+      {
+        pose.translate(link.axis * q);
+      }
+      else
+      {
+        pose.rotate(Eigen::AngleAxisd(q, link.axis));
+      }
+    }
+  }
+}
+
+bool ForwardKinematics::getFramePose(const std::string& frameName, Eigen::Affine3d& pose) const
+{
+  size_t index;
+  if (!getLinkIndex(frameName, index) || !known_[index])
+  {
+    return false;
+  }
+  pose = poses_[index];
+  return true;
+}
+
+bool ForwardKinematics::getRelativePose(const std::string& frameName, const std::string& baseFrame,
+                                        Eigen::Affine3d& pose) const
+{
+  Eigen::Affine3d framePose, basePose;
+  if (!getFramePose(frameName, framePose) || !getFramePose(baseFrame, basePose))
+  {
+    return false;
+  }
+  pose = basePose.inverse(Eigen::Isometry) * framePose;
+  return true;
+}
@@ -0,0 +1,156 @@
+#include "tough_common/joint_handle.h"
+#include "tough_common/robot_state.h"
+#include <limits>
+
+namespace
+{
+// layout version that is never used by RobotStateInformer, forces a resolve on first read
+const uint64_t UNRESOLVED_LAYOUT = std::numeric_limits<uint64_t>::max();
+}
+
+JointHandle::JointHandle() : stateInformer_(nullptr), index_(-1), layoutVersion_(UNRESOLVED_LAYOUT)
+{
+}
+
+JointHandle::JointHandle(RobotStateInformer* stateInformer, const std::string& jointName)
+  : stateInformer_(stateInformer), name_(jointName), index_(-1), layoutVersion_(UNRESOLVED_LAYOUT)
+{
+}
+
+bool JointHandle::resolve() const
+{
+  if (stateInformer_ == nullptr)
+  {
+    return false;
+  }
+
+  uint64_t layoutVersion = stateInformer_->getJointLayoutVersion();
+  if (layoutVersion != layoutVersion_)
+  {
+    size_t index;
+    index_ = stateInformer_->getJointIndex(name_, index) ? static_cast<int>(index) : -1;
+    layoutVersion_ = layoutVersion;
+  }
+  return index_ >= 0;
+}
+
+double JointHandle::read(const int field) const
+{
+  double value = 0.0;
+  if (resolve())
+  {
+    stateInformer_->jointStateBuffer_.read(static_cast<JointStateBuffer::Field>(field), index_, value);
+  }
+  return value;
+}
+
+const std::string& JointHandle::getName() const
+{
+  return name_;
+}
+
+bool JointHandle::isValid() const
+{
+  return resolve();
+}
+
+int JointHandle::getIndex() const
+{
+  resolve();
+  return index_;
+}
+
+double JointHandle::getPosition() const
+{
+  return read(JointStateBuffer::POSITION);
+}
+
+double JointHandle::getVelocity() const
+{
+  return read(JointStateBuffer::VELOCITY);
+}
+
+double JointHandle::getEffort() const
+{
+  return read(JointStateBuffer::EFFORT);
+}
+
+JointGroupHandle::JointGroupHandle() : stateInformer_(nullptr), valid_(false), layoutVersion_(UNRESOLVED_LAYOUT)
+{
+}
+
+JointGroupHandle::JointGroupHandle(RobotStateInformer* stateInformer, const std::vector<std::string>& jointNames)
+  : stateInformer_(stateInformer)
+  , names_(jointNames)
+  , indices_(jointNames.size(), 0)
+  , valid_(false)
+  , layoutVersion_(UNRESOLVED_LAYOUT)
+{
+}
+
+bool JointGroupHandle::resolve() const
+{
+  if (stateInformer_ == nullptr)
+  {
+    return false;
+  }
+
+  uint64_t layoutVersion = stateInformer_->getJointLayoutVersion();
+  if (layoutVersion != layoutVersion_)
+  {
+    valid_ = true;
+    for (size_t i = 0; i < names_.size(); ++i)
+    {
+      if (!stateInformer_->getJointIndex(names_[i], indices_[i]))
+      {
+        // out of range index is reported as invalid by the buffer
+        indices_[i] = JointStateBuffer::MAX_JOINTS;
+        valid_ = false;
+      }
+    }
+    layoutVersion_ = layoutVersion;
+  }
+  return valid_;
+}
+
+bool JointGroupHandle::read(const int field, std::vector<double>& values) const
+{
+  if (stateInformer_ == nullptr)
+  {
+    values.clear();
+    return false;
+  }
+  resolve();
+  return stateInformer_->jointStateBuffer_.read(static_cast<JointStateBuffer::Field>(field), indices_, values) &&
+         valid_;
+}
+
+const std::vector<std::string>& JointGroupHandle::getNames() const
+{
+  return names_;
+}
+
+size_t JointGroupHandle::size() const
+{
+  return names_.size();
+}
+
+bool JointGroupHandle::isValid() const
+{
+  return resolve();
+}
+
+bool JointGroupHandle::getPositions(std::vector<double>& positions) const
+{
+  return read(JointStateBuffer::POSITION, positions);
+}
+
+bool JointGroupHandle::getVelocities(std::vector<double>& velocities) const
+{
+  return read(JointStateBuffer::VELOCITY, velocities);
+}
+
+bool JointGroupHandle::getEfforts(std::vector<double>& efforts) const
+{
+  return read(JointStateBuffer::EFFORT, efforts);
+}
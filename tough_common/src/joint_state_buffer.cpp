@@ -0,0 +1,155 @@
+#include "tough_common/joint_state_buffer.h"
+#include <algorithm>
+#include <thread>
+
+const size_t JointStateBuffer::MAX_JOINTS;
+
+JointStateBuffer::JointStateBuffer() : sequence_(0), size_(0), stamp_(0)
+{
+  for (size_t field = 0; field < NUM_FIELDS; ++field)
+  {
+    for (size_t i = 0; i < MAX_JOINTS; ++i)
+    {
+      data_[field][i].store(0.0, std::memory_order_relaxed);
+    }
+  }
+}
+
+void JointStateBuffer::update(const sensor_msgs::JointState& msg)
+{
+  size_t numJoints = std::min(msg.name.size(), MAX_JOINTS);
+  if (msg.name.size() > MAX_JOINTS)
+  {
+    ROS_ERROR_THROTTLE(1.0, "Joint state has %lu joints, only first %lu are stored", msg.name.size(), MAX_JOINTS);
+  }
+
+  const std::vector<double>* fields[NUM_FIELDS] = { &msg.position, &msg.velocity, &msg.effort };
+
+  // odd sequence number marks a write in progress
+  uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+  sequence_.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  for (size_t field = 0; field < NUM_FIELDS; ++field)
+  {
+    const std::vector<double>& src = *fields[field];
+    size_t available = std::min(src.size(), numJoints);
+    for (size_t i = 0; i < available; ++i)
+    {
+      data_[field][i].store(src[i], std::memory_order_relaxed);
+    }
+    for (size_t i = available; i < numJoints; ++i)
+    {
+      data_[field][i].store(0.0, std::memory_order_relaxed);
+    }
+  }
+  size_.store(numJoints, std::memory_order_relaxed);
+  stamp_.store(msg.header.stamp.toNSec(), std::memory_order_relaxed);
+
+  sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+uint64_t JointStateBuffer::readBegin() const
+{
+  uint64_t sequence = sequence_.load(std::memory_order_acquire);
+  while (sequence & 1)
+  {
+    std::this_thread::yield();
+    sequence = sequence_.load(std::memory_order_acquire);
+  }
+  return sequence;
+}
+
+bool JointStateBuffer::readRetry(const uint64_t sequence) const
+{
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return sequence_.load(std::memory_order_relaxed) != sequence;
+}
+
+size_t JointStateBuffer::size() const
+{
+  return size_.load(std::memory_order_acquire);
+}
+
+uint64_t JointStateBuffer::getUpdateCount() const
+{
+  return sequence_.load(std::memory_order_acquire) / 2;
+}
+
+bool JointStateBuffer::read(const Field field, const size_t index, double& value) const
+{
+  uint64_t sequence;
+  bool valid;
+  do
+  {
+    sequence = readBegin();
+    valid = index < size_.load(std::memory_order_relaxed);
+    value = valid ? data_[field][index].load(std::memory_order_relaxed) : 0.0;
+  } while (readRetry(sequence));
+
+  return valid;
+}
+
+void JointStateBuffer::read(const Field field, std::vector<double>& values) const
+{
+  uint64_t sequence;
+  do
+  {
+    sequence = readBegin();
+    size_t numJoints = size_.load(std::memory_order_relaxed);
+    values.resize(numJoints);
+    for (size_t i = 0; i < numJoints; ++i)
+    {
+      values[i] = data_[field][i].load(std::memory_order_relaxed);
+    }
+  } while (readRetry(sequence));
+}
+
+bool JointStateBuffer::read(const Field field, const std::vector<size_t>& indices, std::vector<double>& values) const
+{
+  values.resize(indices.size());
+  uint64_t sequence;
+  bool valid;
+  do
+  {
+    sequence = readBegin();
+    size_t numJoints = size_.load(std::memory_order_relaxed);
+    valid = true;
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      if (indices[i] < numJoints)
+      {
+        values[i] = data_[field][indices[i]].load(std::memory_order_relaxed);
+      }
+      else
+      {
+        values[i] = 0.0;
+        valid = false;
+      }
+    }
+  } while (readRetry(sequence));
+
+  return valid;
+}
+
+void JointStateBuffer::readAll(std::vector<double>& positions, std::vector<double>& velocities,
+                               std::vector<double>& efforts, uint64_t& stamp) const
+{
+  std::vector<double>* fields[NUM_FIELDS] = { &positions, &velocities, &efforts };
+  uint64_t sequence;
+  do
+  {
+    sequence = readBegin();
+    size_t numJoints = size_.load(std::memory_order_relaxed);
+    for (size_t field = 0; field < NUM_FIELDS; ++field)
+    {
+      std::vector<double>& dst = *fields[field];
+      dst.resize(numJoints);
+      for (size_t i = 0; i < numJoints; ++i)
+      {
+        dst[i] = data_[field][i].load(std::memory_order_relaxed);
+      }
+    }
+    stamp = stamp_.load(std::memory_order_relaxed);
+  } while (readRetry(sequence));
+}
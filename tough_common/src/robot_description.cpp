@@ -1,4 +1,5 @@
 #include "tough_common/robot_description.h"
+#include "tough_common/description_cache.h"
 
 #include <ros/ros.h>
 #include <tf2_ros/transform_broadcaster.h>
@@ -7,6 +8,7 @@
 #include <algorithm>
 #include <string>
 #include <cctype>
+#include <limits>
 
 // The following function to find substring is copied from stack overflow
 // Try to find in the Haystack the Needle - ignore case
@@ -17,6 +19,16 @@ bool findSubStringIC(const std::string& strHaystack, const std::string& strNeedl
   return (it != strHaystack.end());
 }
 
+// strings are terminated so that moving a character from one value to the next changes the hash
+uint64_t hashStrings(const std::vector<std::string>& values, uint64_t seed)
+{
+  for (const auto& value : values)
+  {
+    seed = hashDescription(value + '\0', seed);
+  }
+  return seed;
+}
+
 // define static variables
 RobotDescription* RobotDescription::object = nullptr;
 
@@ -31,6 +43,7 @@ RobotDescription* RobotDescription::getRobotDescription(ros::NodeHandle nh, std:
 }
 
 RobotDescription::RobotDescription(ros::NodeHandle nh, std::string urdf_param)
+  : model_valid_(false), number_of_neck_joints_(0), foot_frame_offset_(0.0)
 {
   param_left_arm_joint_names_ = TOUGH_COMMON_NAMES::LEFT_ARM_JOINT_NAMES_PARAM;
   param_right_arm_joint_names_ = TOUGH_COMMON_NAMES::RIGHT_ARM_JOINT_NAMES_PARAM;
@@ -48,27 +61,95 @@ RobotDescription::RobotDescription(ros::NodeHandle nh, std::string urdf_param)
   ROS_INFO("Robot Name : %s", robot_name_.c_str());
   std::string prefix = TOUGH_COMMON_NAMES::TOPIC_PREFIX + robot_name_ + "/";
 
-  std::string robot_xml;
+  param_left_arm_joint_names_.insert(0, prefix);
+  param_right_arm_joint_names_.insert(0, prefix);
+  param_chest_joint_names_.insert(0, prefix);
+  param_left_foot_frame_name_.insert(0, prefix);
+  param_right_foot_frame_name_.insert(0, prefix);
+  param_left_ee_frame_name_.insert(0, prefix);
+  param_right_ee_frame_name_.insert(0, prefix);
+
   urdf_param = "/" + robot_name_ + urdf_param;
-  if (!nh.getParam(urdf_param, robot_xml) || !model_.initString(robot_xml))
+  if (!nh.getParam(urdf_param, robot_xml_))
   {
     ROS_ERROR("Could not read the robot_description");
     return;
   }
   urdf_param_ = urdf_param;
+
+  // joint and frame names are served from the cache as well, the values of their parameters are part of the key
+  uint64_t cache_key = hashDescription(robot_xml_, hashDescription(robot_name_));
+  for (const std::string& param :
+       { param_left_arm_joint_names_, param_right_arm_joint_names_, param_chest_joint_names_ })
+  {
+    std::vector<std::string> names;
+    nh.getParam(param, names);
+    cache_key = hashStrings(names, hashDescription(param, cache_key));
+  }
+  for (const std::string& param : { param_left_foot_frame_name_, param_right_foot_frame_name_,
+                                    param_left_ee_frame_name_, param_right_ee_frame_name_ })
+  {
+    std::string name;
+    nh.getParam(param, name);
+    cache_key = hashStrings({ name }, hashDescription(param, cache_key));
+  }
+  const std::string cache_file = getDescriptionCacheFile(robot_name_);
+  if (!cache_file.empty() && loadDescriptionCache(cache_file, cache_key))
+  {
+    ROS_INFO("Loaded robot description from %s", cache_file.c_str());
+  }
+  else
+  {
+    if (!parseDescription(nh))
+    {
+      return;
+    }
+    if (!cache_file.empty() && !storeDescriptionCache(cache_file, cache_key))
+    {
+      ROS_WARN("Could not write the robot description cache %s", cache_file.c_str());
+    }
+  }
+
+  updateJointChainLimits();
+  updateFrameHash();
+
+  ROS_INFO("Left foot frame : %s", left_foot_frame_name_.c_str());
+  ROS_INFO("Right foot frame : %s", right_foot_frame_name_.c_str());
+  ROS_INFO("Pelvis Frame : %s", PELVIS_TF.c_str());
+  ROS_INFO("Torso Frame : %s", TORSO_TF.c_str());
+  ROS_INFO("Right Palm Frame : %s", R_PALM_TF.c_str());
+  ROS_INFO("Left Palm Frame : %s", L_PALM_TF.c_str());
+  ROS_INFO("Right EE Frame : %s", R_END_EFFECTOR_TF.c_str());
+  ROS_INFO("Left EE Frame : %s", L_END_EFFECTOR_TF.c_str());
+}
+
+RobotDescription::~RobotDescription()
+{
+}
+
+bool RobotDescription::parseModel() const
+{
+  std::call_once(model_parsed_, [this]() {
+    model_valid_ = model_.initString(robot_xml_);
+    if (!model_valid_)
+    {
+      ROS_ERROR("Could not parse the robot_description");
+    }
+  });
+  return model_valid_;
+}
+
+bool RobotDescription::parseDescription(ros::NodeHandle& nh)
+{
+  if (!parseModel())
+  {
+    return false;
+  }
   if (robot_name_ == "")
   {
     robot_name_.assign(model_.getName());
   }
 
-  param_left_arm_joint_names_.insert(0, prefix);
-  param_right_arm_joint_names_.insert(0, prefix);
-  param_chest_joint_names_.insert(0, prefix);
-  param_left_foot_frame_name_.insert(0, prefix);
-  param_right_foot_frame_name_.insert(0, prefix);
-  param_left_ee_frame_name_.insert(0, prefix);
-  param_right_ee_frame_name_.insert(0, prefix);
-
   if (!(nh.getParam(param_left_arm_joint_names_, left_arm_joint_names_) &&
         nh.getParam(param_right_arm_joint_names_, right_arm_joint_names_) &&
         nh.getParam(param_chest_joint_names_, chest_joint_names_) &&
@@ -79,7 +160,7 @@ RobotDescription::RobotDescription(ros::NodeHandle nh, std::string urdf_param)
   {
     ROS_ERROR("Could not read the joint names from parameter server. Check if you have the latest ihmc_%s_ros package",
               robot_name_.c_str());
-    return;
+    return false;
   }
 
   // get a vector of all links
@@ -123,35 +204,106 @@ RobotDescription::RobotDescription(ros::NodeHandle nh, std::string urdf_param)
   R_PALM_TF = *(right_arm_frame_names_.end() - 1);
   TORSO_TF = model_.joints_[left_arm_joint_names_[0]]->parent_link_name;
 
+  // lower and upper limits are copied from the vectors of pairs by updateJointChainLimits
+  for (size_t chain = 0; chain < NUM_JOINT_CHAINS; ++chain)
+  {
+    const std::vector<std::string>& joint_names = getJointChainNames(static_cast<JointChain>(chain));
+    JointChainLimits& limits = joint_chain_limits_[chain];
+    limits.velocity.resize(joint_names.size());
+    limits.effort.resize(joint_names.size());
+    for (size_t i = 0; i < joint_names.size(); ++i)
+    {
+      limits.velocity[i] = model_.joints_[joint_names[i]]->limits->velocity;
+      limits.effort[i] = model_.joints_[joint_names[i]]->limits->effort;
+    }
+  }
+
   /* With 0.11 version of open-robotics-software, the foot offset is not handled on JAVA side
    * This causes footsteps to be at a height from ground. should this be fixed on JAVA side?
    */
 
-  if (robot_name_ == "atlas")
-  {
-    number_of_neck_joints_ = 1;
-    foot_frame_offset_ = 0.085;
-  }
-  else if (robot_name_ == "valkyrie")
+  const RobotConstants constants = getRobotConstants(getRobotType());
+  if (constants.is_known)
   {
-    number_of_neck_joints_ = 3;
-    foot_frame_offset_ = 0.102;
+    number_of_neck_joints_ = constants.num_neck_joints;
+    foot_frame_offset_ = constants.foot_frame_offset;
   }
-
-  updateFrameHash();
-
-  ROS_INFO("Left foot frame : %s", left_foot_frame_name_.c_str());
-  ROS_INFO("Right foot frame : %s", right_foot_frame_name_.c_str());
-  ROS_INFO("Pelvis Frame : %s", PELVIS_TF.c_str());
-  ROS_INFO("Torso Frame : %s", TORSO_TF.c_str());
-  ROS_INFO("Right Palm Frame : %s", R_PALM_TF.c_str());
-  ROS_INFO("Left Palm Frame : %s", L_PALM_TF.c_str());
-  ROS_INFO("Right EE Frame : %s", R_END_EFFECTOR_TF.c_str());
-  ROS_INFO("Left EE Frame : %s", L_END_EFFECTOR_TF.c_str());
+  return true;
 }
 
-RobotDescription::~RobotDescription()
+bool RobotDescription::loadDescriptionCache(const std::string& file_name, const uint64_t key)
 {
+  DescriptionCacheReader reader;
+  if (!reader.open(file_name, key))
+  {
+    return false;
+  }
+
+  // same order as storeDescriptionCache
+  const std::string robot_name = robot_name_;
+  int32_t number_of_neck_joints;
+  bool valid = reader.read(robot_name_) && reader.read(left_arm_joint_names_) &&
+               reader.read(right_arm_joint_names_) && reader.read(chest_joint_names_) &&
+               reader.read(left_arm_frame_names_) && reader.read(right_arm_frame_names_) &&
+               reader.read(chest_frame_names_) && reader.read(left_arm_joint_limits_) &&
+               reader.read(right_arm_joint_limits_) && reader.read(chest_joint_limits_) &&
+               reader.read(joint_chain_limits_[0].velocity) && reader.read(joint_chain_limits_[0].effort) &&
+               reader.read(joint_chain_limits_[1].velocity) && reader.read(joint_chain_limits_[1].effort) &&
+               reader.read(joint_chain_limits_[2].velocity) && reader.read(joint_chain_limits_[2].effort) &&
+               reader.read(left_foot_frame_name_) && reader.read(right_foot_frame_name_) && reader.read(PELVIS_TF) &&
+               reader.read(TORSO_TF) && reader.read(L_PALM_TF) && reader.read(R_PALM_TF) &&
+               reader.read(L_END_EFFECTOR_TF) && reader.read(R_END_EFFECTOR_TF) &&
+               reader.read(number_of_neck_joints) && reader.read(foot_frame_offset_) && reader.atEnd();
+  if (!valid)
+  {
+    ROS_WARN("Ignoring corrupted robot description cache %s", file_name.c_str());
+    // parseDescription appends to the lists and keeps the shortest pelvis frame
+    robot_name_ = robot_name;
+    left_arm_joint_names_.clear();
+    right_arm_joint_names_.clear();
+    chest_joint_names_.clear();
+    left_arm_frame_names_.clear();
+    right_arm_frame_names_.clear();
+    chest_frame_names_.clear();
+    left_arm_joint_limits_.clear();
+    right_arm_joint_limits_.clear();
+    chest_joint_limits_.clear();
+    PELVIS_TF.clear();
+    return false;
+  }
+  number_of_neck_joints_ = number_of_neck_joints;
+  return true;
+}
+
+bool RobotDescription::storeDescriptionCache(const std::string& file_name, const uint64_t key) const
+{
+  DescriptionCacheWriter writer(key);
+  writer.write(robot_name_);
+  writer.write(left_arm_joint_names_);
+  writer.write(right_arm_joint_names_);
+  writer.write(chest_joint_names_);
+  writer.write(left_arm_frame_names_);
+  writer.write(right_arm_frame_names_);
+  writer.write(chest_frame_names_);
+  writer.write(left_arm_joint_limits_);
+  writer.write(right_arm_joint_limits_);
+  writer.write(chest_joint_limits_);
+  for (size_t chain = 0; chain < NUM_JOINT_CHAINS; ++chain)
+  {
+    writer.write(joint_chain_limits_[chain].velocity);
+    writer.write(joint_chain_limits_[chain].effort);
+  }
+  writer.write(left_foot_frame_name_);
+  writer.write(right_foot_frame_name_);
+  writer.write(PELVIS_TF);
+  writer.write(TORSO_TF);
+  writer.write(L_PALM_TF);
+  writer.write(R_PALM_TF);
+  writer.write(L_END_EFFECTOR_TF);
+  writer.write(R_END_EFFECTOR_TF);
+  writer.write(static_cast<int32_t>(number_of_neck_joints_));
+  writer.write(foot_frame_offset_);
+  return writer.save(file_name);
 }
 
 double RobotDescription::getFootFrameOffset() const
@@ -245,6 +397,18 @@ const std::string RobotDescription::getURDFParameter() const
 {
   return urdf_param_;
 }
+
+RobotType RobotDescription::getRobotType() const
+{
+  return ::getRobotType(robot_name_);
+}
+
+const urdf::Model& RobotDescription::getURDFModel() const
+{
+  parseModel();
+  return model_;
+}
+
 void RobotDescription::setRightPalmFrame(const std::string& value)
 {
   R_PALM_TF = value;
@@ -268,6 +432,7 @@ void RobotDescription::getRightArmJointLimits(std::vector<std::pair<double, doub
 void RobotDescription::setRightArmJointLimits(const std::vector<std::pair<double, double> >& right_arm_joint_limits)
 {
   right_arm_joint_limits_.assign(right_arm_joint_limits.begin(), right_arm_joint_limits.end());
+  updateJointChainLimits();
 }
 
 void RobotDescription::getLeftArmJointLimits(std::vector<std::pair<double, double> >& left_arm_joint_limits) const
@@ -278,6 +443,83 @@ void RobotDescription::getLeftArmJointLimits(std::vector<std::pair<double, doubl
 void RobotDescription::setLeftArmJointLimits(const std::vector<std::pair<double, double> >& left_arm_joint_limits)
 {
   left_arm_joint_limits_.assign(left_arm_joint_limits.begin(), left_arm_joint_limits.end());
+  updateJointChainLimits();
+}
+
+const JointChainLimits& RobotDescription::getJointChainLimits(const JointChain chain) const
+{
+  return joint_chain_limits_[static_cast<size_t>(chain)];
+}
+
+const std::vector<std::string>& RobotDescription::getJointChainNames(const JointChain chain) const
+{
+  switch (chain)
+  {
+    case JointChain::LEFT_ARM:
+      return left_arm_joint_names_;
+    case JointChain::RIGHT_ARM:
+      return right_arm_joint_names_;
+    default:
+      return chest_joint_names_;
+  }
+}
+
+bool RobotDescription::getJointStateIndices(const JointChain chain, const std::vector<std::string>& joint_state_names,
+                                            std::vector<int>& indices) const
+{
+  std::lock_guard<std::mutex> guard(joint_state_indices_mutex_);
+  JointStateIndices& cache = joint_state_indices_[static_cast<size_t>(chain)];
+  if (!cache.resolved || cache.joint_state_names != joint_state_names)
+  {
+    const std::vector<std::string>& joint_names = getJointChainNames(chain);
+    cache.joint_state_names = joint_state_names;
+    cache.indices.resize(joint_names.size());
+    cache.resolved = true;
+    cache.valid = true;
+    for (size_t i = 0; i < joint_names.size(); ++i)
+    {
+      auto it = std::find(joint_state_names.begin(), joint_state_names.end(), joint_names[i]);
+      if (it == joint_state_names.end())
+      {
+        cache.valid = false;
+        break;
+      }
+      cache.indices[i] = it - joint_state_names.begin();
+    }
+  }
+  indices = cache.indices;
+  return cache.valid;
+}
+
+void RobotDescription::resetJointStateIndices(const JointChain chain)
+{
+  std::lock_guard<std::mutex> guard(joint_state_indices_mutex_);
+  joint_state_indices_[static_cast<size_t>(chain)].resolved = false;
+}
+
+void RobotDescription::updateJointChainLimits()
+{
+  const std::vector<std::pair<double, double> >* joint_limits[NUM_JOINT_CHAINS] = {
+    &left_arm_joint_limits_, &right_arm_joint_limits_, &chest_joint_limits_
+  };
+  for (size_t chain = 0; chain < NUM_JOINT_CHAINS; ++chain)
+  {
+    const std::vector<std::pair<double, double> >& pairs = *joint_limits[chain];
+    JointChainLimits& limits = joint_chain_limits_[chain];
+    limits.lower.resize(pairs.size());
+    limits.upper.resize(pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i)
+    {
+      limits.lower[i] = pairs[i].first;
+      limits.upper[i] = pairs[i].second;
+    }
+    // limits set without a URDF have no velocity or effort limit
+    if (limits.velocity.size() != limits.lower.size())
+    {
+      limits.velocity.setConstant(pairs.size(), std::numeric_limits<double>::infinity());
+      limits.effort.setConstant(pairs.size(), std::numeric_limits<double>::infinity());
+    }
+  }
 }
 
 void RobotDescription::getChestJointLimits(std::vector<std::pair<double, double> >& chest_joint_limits) const
@@ -288,6 +530,7 @@ void RobotDescription::getChestJointLimits(std::vector<std::pair<double, double>
 void RobotDescription::setChestJointLimits(const std::vector<std::pair<double, double> >& chest_joint_limits)
 {
   chest_joint_limits_.assign(chest_joint_limits.begin(), chest_joint_limits.end());
+  updateJointChainLimits();
 }
 
 const std::string RobotDescription::getRightFootFrameName() const
@@ -340,14 +583,61 @@ void RobotDescription::getChestJointNames(std::vector<std::string>& chest_joint_
   chest_joint_names = chest_joint_names_;
 }
 
+void RobotDescription::getLegJointNames(const RobotSide side, std::vector<std::string>& leg_joint_names) const
+{
+  getJointsBetween(PELVIS_TF, side == LEFT ? left_foot_frame_name_ : right_foot_frame_name_, leg_joint_names);
+}
+
+void RobotDescription::getNeckJointNames(std::vector<std::string>& neck_joint_names) const
+{
+  getJointsBetween(TORSO_TF, TOUGH_COMMON_NAMES::ROBOT_HEAD_FRAME_TF, neck_joint_names);
+}
+
+void RobotDescription::getJointsBetween(const std::string& base_link, const std::string& tip_link,
+                                        std::vector<std::string>& joint_names) const
+{
+  joint_names.clear();
+  if (!parseModel())
+  {
+    return;
+  }
+  // frame names may have a leading slash, link names do not
+  auto linkName = [](const std::string& frame) { return !frame.empty() && frame[0] == '/' ? frame.substr(1) : frame; };
+  const std::string base = linkName(base_link);
+  urdf::LinkConstSharedPtr link = model_.getLink(linkName(tip_link));
+  while (link && link->name != base)
+  {
+    const urdf::JointConstSharedPtr& joint = link->parent_joint;
+    if (!joint)
+    {
+      joint_names.clear();
+      return;
+    }
+    if (joint->type == urdf::Joint::REVOLUTE || joint->type == urdf::Joint::CONTINUOUS ||
+        joint->type == urdf::Joint::PRISMATIC)
+    {
+      joint_names.push_back(joint->name);
+    }
+    link = model_.getLink(joint->parent_link_name);
+  }
+  if (!link)
+  {
+    joint_names.clear();
+    return;
+  }
+  std::reverse(joint_names.begin(), joint_names.end());
+}
+
 void RobotDescription::setRightArmJointNames(const std::vector<std::string>& right_arm_joint_names)
 {
   right_arm_joint_names_.assign(right_arm_joint_names.begin(), right_arm_joint_names.end());
+  resetJointStateIndices(JointChain::RIGHT_ARM);
 }
 
 void RobotDescription::setChestJointNames(const std::vector<std::string>& chest_joint_names)
 {
   chest_joint_names_.assign(chest_joint_names.begin(), chest_joint_names.end());
+  resetJointStateIndices(JointChain::CHEST);
 }
 
 void RobotDescription::getLeftArmJointNames(std::vector<std::string>& left_arm_joint_names) const
@@ -358,6 +648,7 @@ void RobotDescription::getLeftArmJointNames(std::vector<std::string>& left_arm_j
 void RobotDescription::setLeftArmJointNames(const std::vector<std::string>& left_arm_joint_names)
 {
   left_arm_joint_names_.assign(left_arm_joint_names.begin(), left_arm_joint_names.end());
+  resetJointStateIndices(JointChain::LEFT_ARM);
 }
 
 const std::string RobotDescription::getTorsoFrame() const
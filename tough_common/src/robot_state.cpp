@@ -1,8 +1,129 @@
 #include "tough_common/robot_state.h"
+#include "tough_common/command_tracer.h"
+#include <chrono>
+#include <sstream>
+#include <algorithm>
 
 using namespace TOUGH_COMMON_NAMES;
 RobotStateInformer* RobotStateInformer::currentObject_ = nullptr;
 
+namespace
+{
+// messages without a valid stamp are recorded at the time of receipt
+inline ros::Time historyStamp(const std_msgs::Header& header)
+{
+  return header.stamp.isZero() ? ros::Time::now() : header.stamp;
+}
+
+inline double lerp(const double before, const double after, const double ratio)
+{
+  return before + (after - before) * ratio;
+}
+
+void interpolate(const std::vector<double>& before, const std::vector<double>& after, const double ratio,
+                 std::vector<double>& result)
+{
+  if (before.size() != after.size())
+  {
+    // joint layout changed between the samples, use the nearest one
+    result = ratio < 0.5 ? before : after;
+    return;
+  }
+  result.resize(before.size());
+  for (size_t i = 0; i < before.size(); ++i)
+  {
+    result[i] = lerp(before[i], after[i], ratio);
+  }
+}
+
+void interpolate(const geometry_msgs::Vector3& before, const geometry_msgs::Vector3& after, const double ratio,
+                 geometry_msgs::Vector3& result)
+{
+  result.x = lerp(before.x, after.x, ratio);
+  result.y = lerp(before.y, after.y, ratio);
+  result.z = lerp(before.z, after.z, ratio);
+}
+
+void interpolate(const geometry_msgs::Wrench& before, const geometry_msgs::Wrench& after, const double ratio,
+                 geometry_msgs::Wrench& result)
+{
+  interpolate(before.force, after.force, ratio, result.force);
+  interpolate(before.torque, after.torque, ratio, result.torque);
+}
+
+void interpolate(const sensor_msgs::Imu& before, const sensor_msgs::Imu& after, const double ratio,
+                 sensor_msgs::Imu& result)
+{
+  result = before;
+  tf::Quaternion q_before, q_after;
+  tf::quaternionMsgToTF(before.orientation, q_before);
+  tf::quaternionMsgToTF(after.orientation, q_after);
+  tf::quaternionTFToMsg(q_before.slerp(q_after, ratio), result.orientation);
+  interpolate(before.angular_velocity, after.angular_velocity, ratio, result.angular_velocity);
+  interpolate(before.linear_acceleration, after.linear_acceleration, ratio, result.linear_acceleration);
+}
+
+void transformTFToEigen(const tf::Transform& in, Eigen::Affine3d& out)
+{
+  const tf::Matrix3x3& basis = in.getBasis();
+  for (int row = 0; row < 3; ++row)
+  {
+    for (int col = 0; col < 3; ++col)
+    {
+      out.matrix()(row, col) = basis[row][col];
+    }
+    out.matrix()(row, 3) = in.getOrigin()[row];
+  }
+  out.matrix().row(3) << 0.0, 0.0, 0.0, 1.0;
+}
+
+void poseEigenToMsg(const Eigen::Affine3d& in, geometry_msgs::Pose& out)
+{
+  Eigen::Quaterniond orientation(in.linear());
+  out.position.x = in.translation().x();
+  out.position.y = in.translation().y();
+  out.position.z = in.translation().z();
+  out.orientation.x = orientation.x();
+  out.orientation.y = orientation.y();
+  out.orientation.z = orientation.z();
+  out.orientation.w = orientation.w();
+}
+
+const double DIAGNOSTICS_PERIOD = 1.0;
+// a topic is reported stale when nothing is received for this many times the usual inter-arrival time
+const double STALE_FACTOR = 5.0;
+const double MIN_STALE_TIME = 0.5;
+
+void addDiagnosticValue(diagnostic_msgs::DiagnosticStatus& status, const std::string& key, const double value)
+{
+  std::ostringstream stream;
+  stream << value;
+  diagnostic_msgs::KeyValue keyValue;
+  keyValue.key = key;
+  keyValue.value = stream.str();
+  status.values.push_back(keyValue);
+}
+
+void addDiagnosticValues(diagnostic_msgs::DiagnosticStatus& status, const std::string& name,
+                         const HistogramSummary& summary)
+{
+  // values are reported in milliseconds
+  addDiagnosticValue(status, name + " mean (ms)", summary.mean * 1000.0);
+  addDiagnosticValue(status, name + " p50 (ms)", summary.p50 * 1000.0);
+  addDiagnosticValue(status, name + " p99 (ms)", summary.p99 * 1000.0);
+  addDiagnosticValue(status, name + " max (ms)", summary.max * 1000.0);
+}
+
+// waiters wake up at least this often to process callbacks when there is no spinner thread
+const std::chrono::milliseconds WAIT_SLICE(10);
+
+inline bool isWorldFrame(const std::string& frameName)
+{
+  static const std::string world = WORLD_TF[0] == '/' ? WORLD_TF.substr(1) : WORLD_TF;
+  return frameName == WORLD_TF || frameName == world;
+}
+}  // namespace
+
 /* Singleton implementation */
 RobotStateInformer* RobotStateInformer::getRobotStateInformer(ros::NodeHandle nh)
 {
@@ -15,12 +136,38 @@ RobotStateInformer* RobotStateInformer::getRobotStateInformer(ros::NodeHandle nh
   return currentObject_;
 }
 
-RobotStateInformer::RobotStateInformer(ros::NodeHandle nh) : nh_(nh)
+RobotStateInformer::RobotStateInformer(ros::NodeHandle nh)
+  : nh_(nh), jointLayoutVersion_(0), fkUpdateCount_(0), fkLayoutVersion_(0), fkRootPoseValid_(false), stateUpdateCount_(0)
+  , spinWhileWaiting_(true)
 {
+  // members must be ready before subscribers start calling back
+  initializeClassMembers();
   rd_ = RobotDescription::getRobotDescription(nh_);
   nh.getParam(ROBOT_NAME_PARAM, robotName_);
   std::string prefix = TOPIC_PREFIX + robotName_ + OUTPUT_TOPIC_PREFIX;
 
+  double historyDuration;
+  if (nh_.getParam(STATE_HISTORY_DURATION_PARAM, historyDuration))
+  {
+    jointStateHistory_.setWindow(ros::Duration(historyDuration));
+    pelvisImuHistory_.setWindow(ros::Duration(historyDuration));
+    for (int side = LEFT; side <= RIGHT; ++side)
+    {
+      footWrenchHistory_[side].setWindow(ros::Duration(historyDuration));
+      wristWrenchHistory_[side].setWindow(ros::Duration(historyDuration));
+    }
+  }
+
+  topicStatistics_[TOPIC_JOINT_STATES].setTopic(prefix + JOINT_STATES_TOPIC);
+  topicStatistics_[TOPIC_PELVIS_IMU].setTopic(prefix + PELVIS_IMU_TOPIC);
+  topicStatistics_[TOPIC_CENTER_OF_MASS].setTopic(prefix + CENTER_OF_MASS_TOPIC);
+  topicStatistics_[TOPIC_CAPTURE_POINT].setTopic(prefix + CAPTURE_POINT_TOPIC);
+  topicStatistics_[TOPIC_DOUBLE_SUPPORT].setTopic(prefix + DOUBLE_SUPPORT_STATUS_TOPIC);
+  topicStatistics_[TOPIC_LEFT_FOOT_FORCE_SENSOR].setTopic(prefix + LEFT_FOOT_FORCE_SENSOR_TOPIC);
+  topicStatistics_[TOPIC_RIGHT_FOOT_FORCE_SENSOR].setTopic(prefix + RIGHT_FOOT_FORCE_SENSOR_TOPIC);
+  topicStatistics_[TOPIC_LEFT_WRIST_FORCE_SENSOR].setTopic(prefix + LEFT_WRIST_FORCE_SENSOR_TOPIC);
+  topicStatistics_[TOPIC_RIGHT_WRIST_FORCE_SENSOR].setTopic(prefix + RIGHT_WRIST_FORCE_SENSOR_TOPIC);
+
   jointStateSub_ = nh_.subscribe(prefix + JOINT_STATES_TOPIC, 1, &RobotStateInformer::jointStateCB, this);
 
   pelvisIMUSub_ = nh_.subscribe(prefix + PELVIS_IMU_TOPIC, 1, &RobotStateInformer::pelvisImuCB, this);
@@ -39,7 +186,9 @@ RobotStateInformer::RobotStateInformer(ros::NodeHandle nh) : nh_(nh)
   rightWristForceSensorSub_ =
       nh_.subscribe(prefix + RIGHT_WRIST_FORCE_SENSOR_TOPIC, 1, &RobotStateInformer::rightWristForceSensorCB, this);
 
-  initializeClassMembers();
+  diagnosticsPub_ = nh_.advertise<diagnostic_msgs::DiagnosticArray>(DIAGNOSTICS_TOPIC, 1);
+  diagnosticsTimer_ =
+      nh_.createTimer(ros::Duration(DIAGNOSTICS_PERIOD), &RobotStateInformer::publishDiagnostics, this);
 }
 
 RobotStateInformer::~RobotStateInformer()
@@ -53,233 +202,475 @@ RobotStateInformer::~RobotStateInformer()
   rightFootForceSensorSub_.shutdown();
   leftWristForceSensorSub_.shutdown();
   rightWristForceSensorSub_.shutdown();
+  diagnosticsTimer_.stop();
+  diagnosticsPub_.shutdown();
 }
 
 void RobotStateInformer::initializeClassMembers()
 {
   currentStatePtr_ = sensor_msgs::JointState::Ptr(new sensor_msgs::JointState());
-  pelvisImuValue_ = sensor_msgs::Imu::Ptr(new sensor_msgs::Imu());
-  centerOfMassValue_ = geometry_msgs::Point32::Ptr(new geometry_msgs::Point32());
-  capturePointValue_ = ihmc_msgs::Point2dRosMessage::Ptr(new ihmc_msgs::Point2dRosMessage());
-  doubleSupportStatus_ = true;
-  footWrenches_[LEFT] = geometry_msgs::WrenchStamped::Ptr(new geometry_msgs::WrenchStamped());
-  footWrenches_[RIGHT] = geometry_msgs::WrenchStamped::Ptr(new geometry_msgs::WrenchStamped());
-  wristWrenches_[LEFT] = geometry_msgs::WrenchStamped::Ptr(new geometry_msgs::WrenchStamped());
-  wristWrenches_[RIGHT] = geometry_msgs::WrenchStamped::Ptr(new geometry_msgs::WrenchStamped());
+  jointLayout_ = JointLayoutConstPtr(new JointLayout());
+  // IHMC publishes center of mass and capture point in world frame
+  sensorState_.centerOfMass.header.frame_id = WORLD_TF;
+  sensorState_.capturePoint.header.frame_id = WORLD_TF;
+  sensorState_.isInDoubleSupport = true;
 }
 
 void RobotStateInformer::jointStateCB(const sensor_msgs::JointState::Ptr msg)
 {
-  std::lock_guard<std::mutex> guard(currentStateMutex_);
-  currentStatePtr_ = msg;
+  TopicStatistics::CallbackTimer timer(topicStatistics_[TOPIC_JOINT_STATES], msg->header);
+  if (jointLayout_->names != msg->name)
+  {
+    updateJointLayout(msg->name);
+  }
+  jointStateBuffer_.update(*msg);
+  boost::atomic_store(&currentStatePtr_, msg);
+
+  JointLayoutConstPtr layout = boost::atomic_load(&jointLayout_);
+  jointStateHistory_.emplace(historyStamp(msg->header), [&msg, &layout](JointSample& sample) {
+    sample.layout = layout;
+    sample.position = msg->position;
+    sample.velocity = msg->velocity;
+    sample.effort = msg->effort;
+  });
+  CommandTracer::getCommandTracer()->recordJointState(this, *msg);
+  jointStateCallbacks_.call(*msg);
+  notifyStateUpdate();
 }
 
 void RobotStateInformer::pelvisImuCB(const sensor_msgs::Imu::Ptr msg)
 {
-  pelvisImuValue_ = msg;
+  TopicStatistics::CallbackTimer timer(topicStatistics_[TOPIC_PELVIS_IMU], msg->header);
+  pelvisImuHistory_.push(historyStamp(msg->header), *msg);
+  {
+    std::lock_guard<std::mutex> guard(sensorStateMutex_);
+    sensorState_.pelvisImu = *msg;
+  }
+  notifyStateUpdate();
 }
 void RobotStateInformer::centerOfMassCB(const geometry_msgs::Point32::Ptr msg)
 {
-  centerOfMassValue_ = msg;
+  TopicStatistics::CallbackTimer timer(topicStatistics_[TOPIC_CENTER_OF_MASS]);
+  {
+    std::lock_guard<std::mutex> guard(sensorStateMutex_);
+    sensorState_.centerOfMass.header.stamp = ros::Time::now();
+    sensorState_.centerOfMass.point.x = msg->x;
+    sensorState_.centerOfMass.point.y = msg->y;
+    sensorState_.centerOfMass.point.z = msg->z;
+  }
+  notifyStateUpdate();
 }
 void RobotStateInformer::capturPointCB(const ihmc_msgs::Point2dRosMessage::Ptr msg)
 {
-  capturePointValue_ = msg;
+  TopicStatistics::CallbackTimer timer(topicStatistics_[TOPIC_CAPTURE_POINT]);
+  {
+    std::lock_guard<std::mutex> guard(sensorStateMutex_);
+    sensorState_.capturePoint.header.stamp = ros::Time::now();
+    sensorState_.capturePoint.point.x = msg->x;
+    sensorState_.capturePoint.point.y = msg->y;
+    sensorState_.capturePoint.point.z = 0.0;
+  }
+  notifyStateUpdate();
 }
 
 void RobotStateInformer::doubleSupportStatusCB(const std_msgs::Bool& msg)
 {
-  doubleSupportStatus_ = msg.data;
+  TopicStatistics::CallbackTimer timer(topicStatistics_[TOPIC_DOUBLE_SUPPORT]);
+  {
+    std::lock_guard<std::mutex> guard(sensorStateMutex_);
+    sensorState_.doubleSupportStamp = ros::Time::now();
+    sensorState_.isInDoubleSupport = msg.data;
+  }
+  notifyStateUpdate();
 }
 void RobotStateInformer::leftFootForceSensorCB(const geometry_msgs::WrenchStamped::Ptr msg)
 {
-  footWrenches_[LEFT] = msg;
+  TopicStatistics::CallbackTimer timer(topicStatistics_[TOPIC_LEFT_FOOT_FORCE_SENSOR], msg->header);
+  footWrenchHistory_[LEFT].push(historyStamp(msg->header), msg->wrench);
+  {
+    std::lock_guard<std::mutex> guard(sensorStateMutex_);
+    sensorState_.footWrenches[LEFT] = *msg;
+  }
+  notifyStateUpdate();
 }
 void RobotStateInformer::rightFootForceSensorCB(const geometry_msgs::WrenchStamped::Ptr msg)
 {
-  footWrenches_[RIGHT] = msg;
+  TopicStatistics::CallbackTimer timer(topicStatistics_[TOPIC_RIGHT_FOOT_FORCE_SENSOR], msg->header);
+  footWrenchHistory_[RIGHT].push(historyStamp(msg->header), msg->wrench);
+  {
+    std::lock_guard<std::mutex> guard(sensorStateMutex_);
+    sensorState_.footWrenches[RIGHT] = *msg;
+  }
+  notifyStateUpdate();
 }
 void RobotStateInformer::leftWristForceSensorCB(const geometry_msgs::WrenchStamped::Ptr msg)
 {
-  wristWrenches_[LEFT] = msg;
+  TopicStatistics::CallbackTimer timer(topicStatistics_[TOPIC_LEFT_WRIST_FORCE_SENSOR], msg->header);
+  const ros::Time stamp = historyStamp(msg->header);
+  wristWrenchHistory_[LEFT].push(stamp, msg->wrench);
+  {
+    std::lock_guard<std::mutex> guard(sensorStateMutex_);
+    sensorState_.wristWrenches[LEFT] = *msg;
+    sensorState_.wristWrenches[LEFT].header.stamp = stamp;
+  }
+  wristWrenchCallbacks_.call(LEFT, *msg);
+  notifyStateUpdate();
 }
 void RobotStateInformer::rightWristForceSensorCB(const geometry_msgs::WrenchStamped::Ptr msg)
 {
-  wristWrenches_[RIGHT] = msg;
+  TopicStatistics::CallbackTimer timer(topicStatistics_[TOPIC_RIGHT_WRIST_FORCE_SENSOR], msg->header);
+  const ros::Time stamp = historyStamp(msg->header);
+  wristWrenchHistory_[RIGHT].push(stamp, msg->wrench);
+  {
+    std::lock_guard<std::mutex> guard(sensorStateMutex_);
+    sensorState_.wristWrenches[RIGHT] = *msg;
+    sensorState_.wristWrenches[RIGHT].header.stamp = stamp;
+  }
+  wristWrenchCallbacks_.call(RIGHT, *msg);
+  notifyStateUpdate();
 }
 
-int RobotStateInformer::getJointNumber(std::string jointName)
+int RobotStateInformer::addJointStateCallback(const JointStateCallback& callback)
+{
+  return jointStateCallbacks_.add(callback);
+}
+
+void RobotStateInformer::removeJointStateCallback(const int handle)
+{
+  jointStateCallbacks_.remove(handle);
+}
+
+int RobotStateInformer::addWristWrenchCallback(const WristWrenchCallback& callback)
+{
+  return wristWrenchCallbacks_.add(callback);
+}
+
+void RobotStateInformer::removeWristWrenchCallback(const int handle)
+{
+  wristWrenchCallbacks_.remove(handle);
+}
+
+void RobotStateInformer::notifyStateUpdate()
+{
+  {
+    std::lock_guard<std::mutex> guard(stateUpdateMutex_);
+    ++stateUpdateCount_;
+  }
+  stateUpdateCondition_.notify_all();
+}
+
+void RobotStateInformer::setSpinWhileWaiting(const bool spin)
 {
-  if (jointNames_.empty())
+  spinWhileWaiting_ = spin;
+}
+
+void RobotStateInformer::updateJointLayout(const std::vector<std::string>& jointNames)
+{
+  boost::shared_ptr<JointLayout> layout(new JointLayout());
+  layout->names = jointNames;
+  layout->indices.reserve(jointNames.size());
+  for (size_t i = 0; i < jointNames.size(); ++i)
   {
-    this->getJointNames(jointNames_);
+    layout->indices[jointNames[i]] = i;
   }
+  boost::atomic_store(&jointLayout_, JointLayoutConstPtr(layout));
+  jointLayoutVersion_.fetch_add(1, std::memory_order_release);
+}
+
+uint64_t RobotStateInformer::getJointLayoutVersion() const
+{
+  return jointLayoutVersion_.load(std::memory_order_acquire);
+}
 
-  for (int i = 0; i < jointNames_.size(); i++)
+bool RobotStateInformer::getJointIndex(const std::string& jointName, size_t& index)
+{
+  JointLayoutConstPtr layout = boost::atomic_load(&jointLayout_);
+  auto it = layout->indices.find(jointName);
+  if (it == layout->indices.end())
   {
-    if (jointNames_.at(i) == jointName)
-    {
-      return i;
-    }
+    return false;
   }
-  return jointNames_.size();
+  index = it->second;
+  return true;
+}
+
+int RobotStateInformer::getJointNumber(std::string jointName)
+{
+  JointLayoutConstPtr layout = boost::atomic_load(&jointLayout_);
+  auto it = layout->indices.find(jointName);
+  return it == layout->indices.end() ? layout->names.size() : it->second;
+}
+
+JointHandle RobotStateInformer::getJointHandle(const std::string& jointName)
+{
+  return JointHandle(this, jointName);
+}
+
+JointGroupHandle RobotStateInformer::getJointGroupHandle(const std::vector<std::string>& jointNames)
+{
+  return JointGroupHandle(this, jointNames);
 }
 void RobotStateInformer::getJointStateMessage(sensor_msgs::JointState& jointState)
 {
-  std::lock_guard<std::mutex> guard(currentStateMutex_);
-  jointState = *currentStatePtr_;
+  jointState = *boost::atomic_load(&currentStatePtr_);
 }
 
 void RobotStateInformer::getFootWrenches(std::map<RobotSide, geometry_msgs::Wrench>& wrenches)
 {
-  wrenches[LEFT] = footWrenches_[LEFT]->wrench;
-  wrenches[RIGHT] = footWrenches_[RIGHT]->wrench;
+  std::lock_guard<std::mutex> guard(sensorStateMutex_);
+  wrenches[LEFT] = sensorState_.footWrenches[LEFT].wrench;
+  wrenches[RIGHT] = sensorState_.footWrenches[RIGHT].wrench;
 }
 void RobotStateInformer::getWristWrenches(std::map<RobotSide, geometry_msgs::Wrench>& wrenches)
 {
-  wrenches[LEFT] = wristWrenches_[LEFT]->wrench;
-  wrenches[RIGHT] = wristWrenches_[RIGHT]->wrench;
+  std::lock_guard<std::mutex> guard(sensorStateMutex_);
+  wrenches[LEFT] = sensorState_.wristWrenches[LEFT].wrench;
+  wrenches[RIGHT] = sensorState_.wristWrenches[RIGHT].wrench;
 }
 
 void RobotStateInformer::getFootWrench(const RobotSide side, geometry_msgs::Wrench& wrench)
 {
-  wrench = footWrenches_[side]->wrench;
+  std::lock_guard<std::mutex> guard(sensorStateMutex_);
+  wrench = sensorState_.footWrenches[side].wrench;
 }
-void RobotStateInformer::getWristWrench(const RobotSide side, geometry_msgs::Wrench& wrench)
+bool RobotStateInformer::getWristWrench(const RobotSide side, geometry_msgs::Wrench& wrench)
 {
-  wrench = wristWrenches_[side]->wrench;
+  ros::Time stamp;
+  return getWristWrench(side, wrench, stamp);
+}
+
+bool RobotStateInformer::getWristWrench(const RobotSide side, geometry_msgs::Wrench& wrench, ros::Time& stamp)
+{
+  std::lock_guard<std::mutex> guard(sensorStateMutex_);
+  wrench = sensorState_.wristWrenches[side].wrench;
+  stamp = sensorState_.wristWrenches[side].header.stamp;
+  return !stamp.isZero();
 }
 
 void RobotStateInformer::getFootForce(const RobotSide side, geometry_msgs::Vector3& force)
 {
-  force = footWrenches_[side]->wrench.force;
+  std::lock_guard<std::mutex> guard(sensorStateMutex_);
+  force = sensorState_.footWrenches[side].wrench.force;
 }
 void RobotStateInformer::getFootTorque(const RobotSide side, geometry_msgs::Vector3& torque)
 {
-  torque = footWrenches_[side]->wrench.torque;
+  std::lock_guard<std::mutex> guard(sensorStateMutex_);
+  torque = sensorState_.footWrenches[side].wrench.torque;
 }
 
 void RobotStateInformer::getWristForce(const RobotSide side, geometry_msgs::Vector3& force)
 {
-  force = wristWrenches_[side]->wrench.force;
+  std::lock_guard<std::mutex> guard(sensorStateMutex_);
+  force = sensorState_.wristWrenches[side].wrench.force;
 }
 void RobotStateInformer::getWristTorque(const RobotSide side, geometry_msgs::Vector3& torque)
 {
-  torque = wristWrenches_[side]->wrench.torque;
+  std::lock_guard<std::mutex> guard(sensorStateMutex_);
+  torque = sensorState_.wristWrenches[side].wrench.torque;
 }
 
 bool RobotStateInformer::isRobotInDoubleSupport()
 {
-  return doubleSupportStatus_;
+  std::lock_guard<std::mutex> guard(sensorStateMutex_);
+  return sensorState_.isInDoubleSupport;
 }
 
 void RobotStateInformer::getCapturePoint(geometry_msgs::Point& point)
 {
-  point.x = capturePointValue_->x;
-  point.y = capturePointValue_->y;
-  point.z = 0.0;
+  std::lock_guard<std::mutex> guard(sensorStateMutex_);
+  point = sensorState_.capturePoint.point;
 }
 
 void RobotStateInformer::getCenterOfMass(geometry_msgs::Point& point)
 {
-  point.x = centerOfMassValue_->x;
-  point.y = centerOfMassValue_->y;
-  point.z = centerOfMassValue_->z;
+  std::lock_guard<std::mutex> guard(sensorStateMutex_);
+  point = sensorState_.centerOfMass.point;
 }
 
 void RobotStateInformer::getPelvisIMUReading(sensor_msgs::Imu& msg)
 {
-  msg = *pelvisImuValue_;
+  std::lock_guard<std::mutex> guard(sensorStateMutex_);
+  msg = sensorState_.pelvisImu;
 }
 
-void RobotStateInformer::populateStateMap()
+void RobotStateInformer::getStateSnapshot(RobotStateSnapshot& snapshot)
 {
-  for (size_t i = 0; i < currentStatePtr_->name.size(); ++i)
+  // the joint state is published without the sensor lock, loading it in the same critical section only keeps the two
+  // copies as close in time as possible
+  sensor_msgs::JointState::Ptr jointState;
   {
-    RobotState state;
-    state.name = currentStatePtr_->name[i];
-    state.position = currentStatePtr_->position[i];
-    state.velocity = currentStatePtr_->velocity[i];
-    state.effort = currentStatePtr_->effort[i];
-    currentState_[currentStatePtr_->name[i]] = state;
+    std::lock_guard<std::mutex> guard(sensorStateMutex_);
+    jointState = boost::atomic_load(&currentStatePtr_);
+    snapshot = sensorState_;
   }
+  snapshot.jointState = *jointState;
+  snapshot.stamp = ros::Time::now();
 }
-void RobotStateInformer::getJointPositions(std::vector<double>& positions)
+
+void RobotStateInformer::bracketSameLayout(const JointSample& before, const JointSample& after, const double ratio,
+                                           const JointSample*& first, const JointSample*& second, double& blend)
 {
-  std::lock_guard<std::mutex> guard(currentStateMutex_);
-  positions = currentStatePtr_->position;
+  if (before.layout == after.layout)
+  {
+    first = &before;
+    second = &after;
+    blend = ratio;
+    return;
+  }
+  // samples with different joints cannot be blended, use the nearest one
+  first = ratio < 0.5 ? &before : &after;
+  second = first;
+  blend = 0.0;
 }
 
-bool RobotStateInformer::getJointPositions(const std::string& paramName, std::vector<double>& positions)
+bool RobotStateInformer::getJointPositionsAt(const ros::Time& time, std::vector<double>& positions)
 {
-  positions.clear();
-  std::vector<std::string> jointNames;
-  std::string parameter;
-  parseParameter(paramName, parameter);
+  return jointStateHistory_.interpolate(time, positions, [](const JointSample& before, const JointSample& after,
+                                                            double ratio, std::vector<double>& result) {
+    const JointSample* first;
+    const JointSample* second;
+    double blend;
+    bracketSameLayout(before, after, ratio, first, second, blend);
+    interpolate(first->position, second->position, blend, result);
+  });
+}
 
-  if (nh_.getParam(parameter, jointNames))
+bool RobotStateInformer::getJointStateAt(const ros::Time& time, sensor_msgs::JointState& jointState)
+{
+  if (!jointStateHistory_.interpolate(time, jointState, [](const JointSample& before, const JointSample& after,
+                                                           double ratio, sensor_msgs::JointState& result) {
+        const JointSample* first;
+        const JointSample* second;
+        double blend;
+        bracketSameLayout(before, after, ratio, first, second, blend);
+        interpolate(first->position, second->position, blend, result.position);
+        interpolate(first->velocity, second->velocity, blend, result.velocity);
+        interpolate(first->effort, second->effort, blend, result.effort);
+        result.name = first->layout ? first->layout->names : std::vector<std::string>();
+      }))
   {
-    std::lock_guard<std::mutex> guard(currentStateMutex_);
-    populateStateMap();
-    for (auto joint : jointNames)
-    {
-      positions.push_back((currentState_[joint]).position);
-    }
-    return true;
+    return false;
   }
-  return false;
+  jointState.header.stamp = time;
+  return true;
 }
 
-void RobotStateInformer::getJointVelocities(std::vector<double>& velocities)
+bool RobotStateInformer::getPelvisIMUReadingAt(const ros::Time& time, sensor_msgs::Imu& msg)
 {
-  std::lock_guard<std::mutex> guard(currentStateMutex_);
-  velocities = currentStatePtr_->velocity;
+  if (!pelvisImuHistory_.interpolate(time, msg, [](const sensor_msgs::Imu& before, const sensor_msgs::Imu& after,
+                                                   double ratio, sensor_msgs::Imu& result) {
+        interpolate(before, after, ratio, result);
+      }))
+  {
+    return false;
+  }
+  msg.header.stamp = time;
+  return true;
 }
 
-bool RobotStateInformer::getJointVelocities(const std::string& paramName, std::vector<double>& velocities)
+bool RobotStateInformer::getFootWrenchAt(const RobotSide side, const ros::Time& time, geometry_msgs::Wrench& wrench)
+{
+  return footWrenchHistory_[side].interpolate(
+      time, wrench, [](const geometry_msgs::Wrench& before, const geometry_msgs::Wrench& after, double ratio,
+                       geometry_msgs::Wrench& result) { interpolate(before, after, ratio, result); });
+}
+
+bool RobotStateInformer::getWristWrenchAt(const RobotSide side, const ros::Time& time, geometry_msgs::Wrench& wrench)
+{
+  return wristWrenchHistory_[side].interpolate(
+      time, wrench, [](const geometry_msgs::Wrench& before, const geometry_msgs::Wrench& after, double ratio,
+                       geometry_msgs::Wrench& result) { interpolate(before, after, ratio, result); });
+}
+
+bool RobotStateInformer::getJointGroup(const std::string& paramName, JointGroupConstPtr& group)
 {
-  velocities.clear();
-  std::vector<std::string> jointNames;
   std::string parameter;
   parseParameter(paramName, parameter);
+  uint64_t layoutVersion = getJointLayoutVersion();
 
-  if (nh_.getParam(parameter, jointNames))
   {
-    std::lock_guard<std::mutex> guard(currentStateMutex_);
-    populateStateMap();
-    for (auto joint : jointNames)
+    std::lock_guard<std::mutex> guard(jointGroupsMutex_);
+    auto it = jointGroups_.find(parameter);
+    if (it != jointGroups_.end() && it->second->layoutVersion == layoutVersion)
     {
-      velocities.push_back((currentState_[joint]).velocity);
+      group = it->second;
+      return true;
     }
-    return true;
   }
-  return false;
+
+  boost::shared_ptr<JointGroup> newGroup(new JointGroup());
+  {
+    std::lock_guard<std::mutex> guard(jointGroupsMutex_);
+    auto it = jointGroups_.find(parameter);
+    if (it != jointGroups_.end())
+    {
+      newGroup->names = it->second->names;
+    }
+  }
+
+  // parameter server is queried only once per group
+  if (newGroup->names.empty() && !nh_.getParam(parameter, newGroup->names))
+  {
+    return false;
+  }
+
+  newGroup->layoutVersion = layoutVersion;
+  newGroup->indices.resize(newGroup->names.size());
+  for (size_t i = 0; i < newGroup->names.size(); ++i)
+  {
+    if (!getJointIndex(newGroup->names[i], newGroup->indices[i]))
+    {
+      // out of range index is reported as invalid by the buffer
+      newGroup->indices[i] = JointStateBuffer::MAX_JOINTS;
+    }
+  }
+
+  group = newGroup;
+  std::lock_guard<std::mutex> guard(jointGroupsMutex_);
+  jointGroups_[parameter] = group;
+  return true;
+}
+
+bool RobotStateInformer::getJointGroupValues(const std::string& paramName, const JointStateBuffer::Field field,
+                                             std::vector<double>& values)
+{
+  JointGroupConstPtr group;
+  if (!getJointGroup(paramName, group))
+  {
+    values.clear();
+    return false;
+  }
+  return jointStateBuffer_.read(field, group->indices, values);
+}
+
+void RobotStateInformer::getJointPositions(std::vector<double>& positions)
+{
+  jointStateBuffer_.read(JointStateBuffer::POSITION, positions);
+}
+
+bool RobotStateInformer::getJointPositions(const std::string& paramName, std::vector<double>& positions)
+{
+  return getJointGroupValues(paramName, JointStateBuffer::POSITION, positions);
+}
+
+void RobotStateInformer::getJointVelocities(std::vector<double>& velocities)
+{
+  jointStateBuffer_.read(JointStateBuffer::VELOCITY, velocities);
+}
+
+bool RobotStateInformer::getJointVelocities(const std::string& paramName, std::vector<double>& velocities)
+{
+  return getJointGroupValues(paramName, JointStateBuffer::VELOCITY, velocities);
 }
 
 void RobotStateInformer::getJointEfforts(std::vector<double>& efforts)
 {
-  std::lock_guard<std::mutex> guard(currentStateMutex_);
-  efforts = currentStatePtr_->effort;
+  jointStateBuffer_.read(JointStateBuffer::EFFORT, efforts);
 }
 
 bool RobotStateInformer::getJointEfforts(const std::string& paramName, std::vector<double>& efforts)
 {
-  efforts.clear();
-  std::vector<std::string> jointNames;
-  std::string parameter;
-  parseParameter(paramName, parameter);
-
-  if (nh_.getParam(parameter, jointNames))
-  {
-    std::lock_guard<std::mutex> guard(currentStateMutex_);
-    populateStateMap();
-    for (auto joint : jointNames)
-    {
-      efforts.push_back((currentState_[joint]).effort);
-    }
-    return true;
-  }
-  return false;
+  return getJointGroupValues(paramName, JointStateBuffer::EFFORT, efforts);
 }
 
 double RobotStateInformer::getJointPosition(const std::string& jointName)
@@ -289,11 +680,12 @@ double RobotStateInformer::getJointPosition(const std::string& jointName)
 
 double RobotStateInformer::getJointPosition(const int jointNumber)
 {
-  std::lock_guard<std::mutex> guard(currentStateMutex_);
-  if (currentStatePtr_->position.size() > jointNumber)
+  double value = 0.0;
+  if (jointNumber >= 0)
   {
-    return currentStatePtr_->position[jointNumber];
+    jointStateBuffer_.read(JointStateBuffer::POSITION, jointNumber, value);
   }
+  return value;
 }
 
 double RobotStateInformer::getJointVelocity(const std::string& jointName)
@@ -303,11 +695,12 @@ double RobotStateInformer::getJointVelocity(const std::string& jointName)
 
 double RobotStateInformer::getJointVelocity(const int jointNumber)
 {
-  std::lock_guard<std::mutex> guard(currentStateMutex_);
-  if (currentStatePtr_->velocity.size() > jointNumber)
+  double value = 0.0;
+  if (jointNumber >= 0)
   {
-    return currentStatePtr_->velocity[jointNumber];
+    jointStateBuffer_.read(JointStateBuffer::VELOCITY, jointNumber, value);
   }
+  return value;
 }
 
 double RobotStateInformer::getJointEffort(const std::string& jointName)
@@ -317,28 +710,105 @@ double RobotStateInformer::getJointEffort(const std::string& jointName)
 
 double RobotStateInformer::getJointEffort(const int jointNumber)
 {
-  std::lock_guard<std::mutex> guard(currentStateMutex_);
-  if (currentStatePtr_->effort.size() > jointNumber)
+  double value = 0.0;
+  if (jointNumber >= 0)
   {
-    return currentStatePtr_->effort[jointNumber];
+    jointStateBuffer_.read(JointStateBuffer::EFFORT, jointNumber, value);
   }
+  return value;
 }
 
 void RobotStateInformer::getJointNames(std::vector<std::string>& jointNames)
 {
-  if (jointNames_.empty())
+  jointNames = boost::atomic_load(&jointLayout_)->names;
+}
+
+bool RobotStateInformer::getForwardKinematicsPose(const std::string& frameName, const std::string& baseFrame,
+                                                  Eigen::Affine3d& pose)
+{
+  std::lock_guard<std::mutex> guard(forwardKinematicsMutex_);
+  if (!forwardKinematics_)
   {
-    std::lock_guard<std::mutex> guard(currentStateMutex_);
-    jointNames_ = currentStatePtr_->name;
+    // the URDF is only parsed by nodes that query link poses, the description itself comes from the cache
+    forwardKinematics_.reset(new ForwardKinematics(rd_->getURDFModel()));
+  }
+  if (!forwardKinematics_->isValid())
+  {
+    return false;
   }
-  jointNames = jointNames_;
+  bool frameIsWorld = isWorldFrame(frameName);
+  bool baseIsWorld = isWorldFrame(baseFrame);
+  if ((!frameIsWorld && !forwardKinematics_->hasFrame(frameName)) ||
+      (!baseIsWorld && !forwardKinematics_->hasFrame(baseFrame)))
+  {
+    return false;
+  }
+
+  uint64_t updateCount = jointStateBuffer_.getUpdateCount();
+  if (updateCount == 0)
+  {
+    return false;
+  }
+  if (updateCount != fkUpdateCount_)
+  {
+    uint64_t layoutVersion = getJointLayoutVersion();
+    if (layoutVersion != fkLayoutVersion_)
+    {
+      forwardKinematics_->setJointNames(boost::atomic_load(&jointLayout_)->names);
+      fkLayoutVersion_ = layoutVersion;
+    }
+    jointStateBuffer_.read(JointStateBuffer::POSITION, fkPositions_);
+    if (layoutVersion != getJointLayoutVersion())
+    {
+      // joints changed while reading, positions may not match the names
+      return false;
+    }
+    forwardKinematics_->update(fkPositions_);
+    fkUpdateCount_ = updateCount;
+    fkRootPoseValid_ = false;
+  }
+
+  if (frameIsWorld || baseIsWorld)
+  {
+    if (!fkRootPoseValid_)
+    {
+      tf::StampedTransform rootTransform;
+      if (!lookupTransform(WORLD_TF, forwardKinematics_->getRootFrame(), rootTransform, false))
+      {
+        return false;
+      }
+      transformTFToEigen(rootTransform, fkRootPose_);
+      fkRootPoseValid_ = true;
+    }
+
+    Eigen::Affine3d framePose = Eigen::Affine3d::Identity();
+    Eigen::Affine3d basePose = Eigen::Affine3d::Identity();
+    if ((!frameIsWorld && !forwardKinematics_->getFramePose(frameName, framePose)) ||
+        (!baseIsWorld && !forwardKinematics_->getFramePose(baseFrame, basePose)))
+    {
+      return false;
+    }
+    framePose = frameIsWorld ? framePose : fkRootPose_ * framePose;
+    basePose = baseIsWorld ? basePose : fkRootPose_ * basePose;
+    pose = basePose.inverse(Eigen::Isometry) * framePose;
+    return true;
+  }
+
+  return forwardKinematics_->getRelativePose(frameName, baseFrame, pose);
 }
 
 bool RobotStateInformer::getCurrentPose(const std::string& frameName, geometry_msgs::Pose& pose,
-                                        const std::string& baseFrame)
+                                        const std::string& baseFrame, const bool wait)
 {
+  Eigen::Affine3d fkPose;
+  if (getForwardKinematicsPose(frameName, baseFrame, fkPose))
+  {
+    poseEigenToMsg(fkPose, pose);
+    return true;
+  }
+
   tf::StampedTransform origin;
-  if (getTransform(frameName, origin, baseFrame))
+  if (getTransform(frameName, origin, baseFrame, wait))
   {
     tf::pointTFToMsg(origin.getOrigin(), pose.position);
     tf::quaternionTFToMsg(origin.getRotation(), pose.orientation);
@@ -346,24 +816,57 @@ bool RobotStateInformer::getCurrentPose(const std::string& frameName, geometry_m
   }
   else
   {
-    false;
+    return false;
   }
 }
 
-bool RobotStateInformer::getTransform(const std::string& frameName, tf::StampedTransform& transform,
-                                      const std::string& baseFrame)
+bool RobotStateInformer::lookupTransform(const std::string& target_frame, const std::string& source_frame,
+                                         tf::StampedTransform& transform, const bool wait)
 {
   try
   {
-    listener_.waitForTransform(baseFrame, frameName, ros::Time(0), ros::Duration(2));
-    listener_.lookupTransform(baseFrame, frameName, ros::Time(0), transform);
+    if (wait)
+    {
+      listener_.waitForTransform(target_frame, source_frame, ros::Time(0), ros::Duration(2));
+    }
+    else if (!listener_.canTransform(target_frame, source_frame, ros::Time(0)))
+    {
+      return false;
+    }
+    listener_.lookupTransform(target_frame, source_frame, ros::Time(0), transform);
   }
   catch (tf::TransformException ex)
   {
     ROS_WARN("%s", ex.what());
-    ros::spinOnce();
+    if (wait)
+    {
+      ros::spinOnce();
+    }
+    return false;
+  }
+  return true;
+}
+
+bool RobotStateInformer::getTransform(const std::string& frameName, tf::StampedTransform& transform,
+                                      const std::string& baseFrame, const bool wait)
+{
+  return lookupTransform(baseFrame, frameName, transform, wait);
+}
+
+bool RobotStateInformer::getTransform(const std::string& frameName, Eigen::Affine3d& transform,
+                                      const std::string& baseFrame, const bool wait)
+{
+  if (getForwardKinematicsPose(frameName, baseFrame, transform))
+  {
+    return true;
+  }
+
+  tf::StampedTransform stampedTransform;
+  if (!lookupTransform(baseFrame, frameName, stampedTransform, wait))
+  {
     return false;
   }
+  transformTFToEigen(stampedTransform, transform);
   return true;
 }
 
@@ -416,17 +919,18 @@ bool RobotStateInformer::transformPoint(const geometry_msgs::PointStamped& pt_in
 }
 
 bool RobotStateInformer::transformPoint(const geometry_msgs::Point& pt_in, geometry_msgs::Point& pt_out,
-                                        const std::string& from_frame, const std::string& to_frame)
+                                        const std::string& from_frame, const std::string& to_frame, const bool wait)
 {
-  geometry_msgs::PointStamped in, out;
-  in.point = pt_in;
-  in.header.frame_id = from_frame;
-  if (transformPoint(in, out, to_frame))
+  tf::StampedTransform transform;
+  if (!lookupTransform(to_frame, from_frame, transform, wait))
   {
-    pt_out = out.point;
-    return true;
+    return false;
   }
-  return false;
+
+  tf::Point point;
+  tf::pointMsgToTF(pt_in, point);
+  tf::pointTFToMsg(transform * point, pt_out);
+  return true;
 }
 
 bool RobotStateInformer::transformPose(const geometry_msgs::PoseStamped& pose_in, geometry_msgs::PoseStamped& pose_out,
@@ -491,6 +995,74 @@ bool RobotStateInformer::transformPose(const geometry_msgs::Pose2D& pose_in, geo
   return true;
 }
 
+bool RobotStateInformer::transformPoints(const std::vector<geometry_msgs::Point>& pts_in,
+                                         std::vector<geometry_msgs::Point>& pts_out, const std::string& from_frame,
+                                         const std::string& to_frame, const bool wait)
+{
+  Eigen::Affine3d transform;
+  if (!getTransform(from_frame, transform, to_frame, wait))
+  {
+    return false;
+  }
+
+  const Eigen::Matrix3d rotation = transform.linear();
+  const Eigen::Vector3d translation = transform.translation();
+  pts_out.resize(pts_in.size());
+  for (size_t i = 0; i < pts_in.size(); ++i)
+  {
+    Eigen::Vector3d point = rotation * Eigen::Vector3d(pts_in[i].x, pts_in[i].y, pts_in[i].z) + translation;
+    pts_out[i].x = point.x();
+    pts_out[i].y = point.y();
+    pts_out[i].z = point.z();
+  }
+  return true;
+}
+
+bool RobotStateInformer::transformPoints(const Eigen::Matrix3Xd& pts_in, Eigen::Matrix3Xd& pts_out,
+                                         const std::string& from_frame, const std::string& to_frame, const bool wait)
+{
+  Eigen::Affine3d transform;
+  if (!getTransform(from_frame, transform, to_frame, wait))
+  {
+    return false;
+  }
+
+  pts_out = (transform.linear() * pts_in).colwise() + transform.translation();
+  return true;
+}
+
+bool RobotStateInformer::transformPoses(const std::vector<geometry_msgs::Pose>& poses_in,
+                                        std::vector<geometry_msgs::Pose>& poses_out, const std::string& from_frame,
+                                        const std::string& to_frame, const bool wait)
+{
+  Eigen::Affine3d transform;
+  if (!getTransform(from_frame, transform, to_frame, wait))
+  {
+    return false;
+  }
+
+  const Eigen::Matrix3d rotation = transform.linear();
+  const Eigen::Vector3d translation = transform.translation();
+  const Eigen::Quaterniond orientation(rotation);
+  poses_out.resize(poses_in.size());
+  for (size_t i = 0; i < poses_in.size(); ++i)
+  {
+    const geometry_msgs::Point& p = poses_in[i].position;
+    const geometry_msgs::Quaternion& q = poses_in[i].orientation;
+    Eigen::Vector3d position = rotation * Eigen::Vector3d(p.x, p.y, p.z) + translation;
+    Eigen::Quaterniond quaternion = orientation * Eigen::Quaterniond(q.w, q.x, q.y, q.z);
+
+    poses_out[i].position.x = position.x();
+    poses_out[i].position.y = position.y();
+    poses_out[i].position.z = position.z();
+    poses_out[i].orientation.x = quaternion.x();
+    poses_out[i].orientation.y = quaternion.y();
+    poses_out[i].orientation.z = quaternion.z();
+    poses_out[i].orientation.w = quaternion.w();
+  }
+  return true;
+}
+
 bool RobotStateInformer::transformVector(const geometry_msgs::Vector3Stamped& vec_in,
                                          geometry_msgs::Vector3Stamped& vec_out, const std::string target_frame)
 {
@@ -521,3 +1093,169 @@ bool RobotStateInformer::transformVector(const geometry_msgs::Vector3& vec_in, g
   }
   return false;
 }
+
+bool RobotStateInformer::waitForCondition(const std::function<bool()>& predicate, const ros::Duration& timeout)
+{
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point deadline = timeout >= ros::DURATION_MAX ?
+                                   Clock::time_point::max() :
+                                   Clock::now() + std::chrono::nanoseconds(timeout.toNSec());
+
+  while (ros::ok())
+  {
+    // read the counter before checking the predicate so that an update in between is not missed
+    uint64_t updateCount;
+    {
+      std::lock_guard<std::mutex> guard(stateUpdateMutex_);
+      updateCount = stateUpdateCount_;
+    }
+
+    if (predicate())
+    {
+      return true;
+    }
+    Clock::time_point now = Clock::now();
+    if (now >= deadline)
+    {
+      return false;
+    }
+
+    // process pending callbacks in case this node does not have a spinner thread
+    if (spinWhileWaiting_)
+    {
+      ros::spinOnce();
+    }
+
+    std::unique_lock<std::mutex> lock(stateUpdateMutex_);
+    Clock::time_point wakeup = deadline - now > WAIT_SLICE ? now + WAIT_SLICE : deadline;
+    stateUpdateCondition_.wait_until(lock, wakeup, [&]() { return stateUpdateCount_ != updateCount; });
+  }
+  return false;
+}
+
+bool RobotStateInformer::waitForNewJointState(const ros::Duration& timeout)
+{
+  uint64_t updateCount = jointStateBuffer_.getUpdateCount();
+  return waitForCondition([this, updateCount]() { return jointStateBuffer_.getUpdateCount() != updateCount; },
+                          timeout);
+}
+
+bool RobotStateInformer::waitForDoubleSupport(const ros::Duration& timeout)
+{
+  return waitForCondition([this]() { return isRobotInDoubleSupport(); }, timeout);
+}
+
+void RobotStateInformer::getTopicStatistics(std::vector<TopicStatisticsSummary>& statistics)
+{
+  statistics.resize(NUM_STATE_TOPICS);
+  for (size_t i = 0; i < NUM_STATE_TOPICS; ++i)
+  {
+    topicStatistics_[i].getSummary(statistics[i]);
+  }
+}
+
+bool RobotStateInformer::getTopicStatistics(const std::string& topic, TopicStatisticsSummary& statistics)
+{
+  for (size_t i = 0; i < NUM_STATE_TOPICS; ++i)
+  {
+    if (topicStatistics_[i].getTopic() == topic)
+    {
+      topicStatistics_[i].getSummary(statistics);
+      return true;
+    }
+  }
+  return false;
+}
+
+void RobotStateInformer::resetTopicStatistics()
+{
+  for (size_t i = 0; i < NUM_STATE_TOPICS; ++i)
+  {
+    topicStatistics_[i].reset();
+  }
+}
+
+void RobotStateInformer::publishDiagnostics(const ros::TimerEvent& event)
+{
+  if (diagnosticsPub_.getNumSubscribers() == 0)
+  {
+    return;
+  }
+
+  std::vector<TopicStatisticsSummary> statistics;
+  getTopicStatistics(statistics);
+
+  diagnostic_msgs::DiagnosticArray msg;
+  msg.header.stamp = ros::Time::now();
+  for (const auto& topic : statistics)
+  {
+    diagnostic_msgs::DiagnosticStatus status;
+    status.name = "RobotStateInformer: " + topic.topic;
+    status.hardware_id = robotName_;
+
+    double timeSinceLast = (msg.header.stamp - topic.lastReceiptTime).toSec();
+    if (topic.messageCount == 0)
+    {
+      status.level = diagnostic_msgs::DiagnosticStatus::STALE;
+      status.message = "No messages received";
+    }
+    else if (timeSinceLast > std::max(MIN_STALE_TIME, STALE_FACTOR * topic.interArrival.p99))
+    {
+      status.level = diagnostic_msgs::DiagnosticStatus::WARN;
+      status.message = "No message in the last " + std::to_string(timeSinceLast) + " seconds";
+    }
+    else if (topic.droppedCount > 0)
+    {
+      status.level = diagnostic_msgs::DiagnosticStatus::WARN;
+      status.message = std::to_string(topic.droppedCount) + " messages dropped";
+    }
+    else
+    {
+      status.level = diagnostic_msgs::DiagnosticStatus::OK;
+      status.message = "OK";
+    }
+
+    addDiagnosticValue(status, "Messages", topic.messageCount);
+    addDiagnosticValue(status, "Dropped", topic.droppedCount);
+    addDiagnosticValue(status, "Rate (Hz)", topic.rate);
+    addDiagnosticValue(status, "Time since last message (s)", timeSinceLast);
+    addDiagnosticValues(status, "Inter-arrival", topic.interArrival);
+    if (topic.age.count > 0)
+    {
+      addDiagnosticValues(status, "Age at receipt", topic.age);
+    }
+    addDiagnosticValues(status, "Callback duration", topic.callbackDuration);
+    msg.status.push_back(status);
+  }
+
+  std::vector<CommandLatencySummary> latencies;
+  CommandTracer::getCommandTracer()->getLatencySummaries(latencies);
+  for (const auto& command : latencies)
+  {
+    diagnostic_msgs::DiagnosticStatus status;
+    status.name = "RobotStateInformer: command latency " + command.type;
+    status.hardware_id = robotName_;
+    if (command.withoutMotion > 0)
+    {
+      status.level = diagnostic_msgs::DiagnosticStatus::WARN;
+      status.message = std::to_string(command.withoutMotion) + " commands without motion";
+    }
+    else
+    {
+      status.level = diagnostic_msgs::DiagnosticStatus::OK;
+      status.message = "OK";
+    }
+
+    addDiagnosticValue(status, "Published", command.published);
+    addDiagnosticValue(status, "Without motion", command.withoutMotion);
+    addDiagnosticValues(status, "Construction to publish", command.construction);
+    if (command.acknowledgement.count > 0)
+    {
+      addDiagnosticValues(status, "Publish to acknowledgement", command.acknowledgement);
+    }
+    addDiagnosticValues(status, "Publish to motion", command.motionOnset);
+    addDiagnosticValues(status, "Construction to motion", command.endToEnd);
+    msg.status.push_back(status);
+  }
+  diagnosticsPub_.publish(msg);
+}
@@ -0,0 +1,176 @@
+#include "tough_common/robot_state_replay.h"
+#include <rosbag/query.h>
+#include <tf2_msgs/TFMessage.h>
+
+namespace
+{
+const std::string TF_TOPIC = "/tf";
+const std::string TF_STATIC_TOPIC = "/tf_static";
+const std::string REPLAY_AUTHORITY = "robot_state_replay";
+}  // namespace
+
+RobotStateReplay::RobotStateReplay(ros::NodeHandle nh)
+{
+  stateInformer_ = RobotStateInformer::getRobotStateInformer(nh);
+  const TopicStatistics* topics = stateInformer_->topicStatistics_;
+
+  addHandler(topics[RobotStateInformer::TOPIC_JOINT_STATES].getTopic(), &RobotStateInformer::jointStateCB);
+  addHandler(topics[RobotStateInformer::TOPIC_PELVIS_IMU].getTopic(), &RobotStateInformer::pelvisImuCB);
+  addHandler(topics[RobotStateInformer::TOPIC_CENTER_OF_MASS].getTopic(), &RobotStateInformer::centerOfMassCB);
+  addHandler(topics[RobotStateInformer::TOPIC_CAPTURE_POINT].getTopic(), &RobotStateInformer::capturPointCB);
+  addHandler(topics[RobotStateInformer::TOPIC_DOUBLE_SUPPORT].getTopic(), &RobotStateInformer::doubleSupportStatusCB);
+  addHandler(topics[RobotStateInformer::TOPIC_LEFT_FOOT_FORCE_SENSOR].getTopic(),
+             &RobotStateInformer::leftFootForceSensorCB);
+  addHandler(topics[RobotStateInformer::TOPIC_RIGHT_FOOT_FORCE_SENSOR].getTopic(),
+             &RobotStateInformer::rightFootForceSensorCB);
+  addHandler(topics[RobotStateInformer::TOPIC_LEFT_WRIST_FORCE_SENSOR].getTopic(),
+             &RobotStateInformer::leftWristForceSensorCB);
+  addHandler(topics[RobotStateInformer::TOPIC_RIGHT_WRIST_FORCE_SENSOR].getTopic(),
+             &RobotStateInformer::rightWristForceSensorCB);
+  addTFHandler(TF_TOPIC, false);
+  addTFHandler(TF_STATIC_TOPIC, true);
+}
+
+template <typename M>
+void RobotStateReplay::addHandler(const std::string& topic, void (RobotStateInformer::*callback)(boost::shared_ptr<M>))
+{
+  RobotStateInformer* stateInformer = stateInformer_;
+  handlers_[topic] = [stateInformer, callback](const rosbag::MessageInstance& instance) {
+    boost::shared_ptr<M> msg = instance.instantiate<M>();
+    if (msg)
+    {
+      (stateInformer->*callback)(msg);
+    }
+  };
+}
+
+template <typename M>
+void RobotStateReplay::addHandler(const std::string& topic, void (RobotStateInformer::*callback)(const M&))
+{
+  RobotStateInformer* stateInformer = stateInformer_;
+  handlers_[topic] = [stateInformer, callback](const rosbag::MessageInstance& instance) {
+    boost::shared_ptr<M> msg = instance.instantiate<M>();
+    if (msg)
+    {
+      (stateInformer->*callback)(*msg);
+    }
+  };
+}
+
+void RobotStateReplay::addTFHandler(const std::string& topic, const bool isStatic)
+{
+  RobotStateInformer* stateInformer = stateInformer_;
+  handlers_[topic] = [stateInformer, isStatic](const rosbag::MessageInstance& instance) {
+    tf2_msgs::TFMessage::ConstPtr msg = instance.instantiate<tf2_msgs::TFMessage>();
+    if (!msg)
+    {
+      return;
+    }
+    for (const auto& transform : msg->transforms)
+    {
+      stateInformer->listener_.getTF2BufferPtr()->setTransform(transform, REPLAY_AUTHORITY, isStatic);
+    }
+  };
+}
+
+bool RobotStateReplay::open(const std::string& bagFile)
+{
+  close();
+  try
+  {
+    bag_.open(bagFile, rosbag::bagmode::Read);
+  }
+  catch (rosbag::BagException& ex)
+  {
+    ROS_ERROR("Could not open %s : %s", bagFile.c_str(), ex.what());
+    return false;
+  }
+
+  std::vector<std::string> topics;
+  for (const auto& handler : handlers_)
+  {
+    topics.push_back(handler.first);
+  }
+  view_.reset(new rosbag::View(bag_, rosbag::TopicQuery(topics)));
+  next_ = view_->begin();
+  currentTime_ = ros::Time(0);
+  ROS_INFO("Replaying %u messages from %s", view_->size(), bagFile.c_str());
+  return true;
+}
+
+void RobotStateReplay::close()
+{
+  view_.reset();
+  bag_.close();
+}
+
+bool RobotStateReplay::step()
+{
+  if (!view_ || next_ == view_->end())
+  {
+    return false;
+  }
+
+  const rosbag::MessageInstance& instance = *next_;
+  currentTime_ = instance.getTime();
+  // callbacks and getters use ros::Time::now(), replay the clock as it was while recording
+  ros::Time::setNow(currentTime_);
+
+  auto handler = handlers_.find(instance.getTopic());
+  if (handler != handlers_.end())
+  {
+    handler->second(instance);
+  }
+  ++next_;
+  return true;
+}
+
+bool RobotStateReplay::playUntil(const ros::Time& time)
+{
+  while (view_ && next_ != view_->end() && next_->getTime() <= time)
+  {
+    step();
+  }
+  return view_ && next_ != view_->end();
+}
+
+void RobotStateReplay::play(const double rate)
+{
+  if (!view_)
+  {
+    return;
+  }
+
+  ros::WallTime wallStart = ros::WallTime::now();
+  ros::Time bagStart = next_ != view_->end() ? next_->getTime() : ros::Time(0);
+  while (next_ != view_->end() && ros::ok())
+  {
+    if (rate > 0.0)
+    {
+      // sleep until the message is due at the requested rate
+      ros::WallDuration due((next_->getTime() - bagStart).toSec() / rate);
+      ros::WallDuration remaining = due - (ros::WallTime::now() - wallStart);
+      if (remaining > ros::WallDuration(0))
+      {
+        remaining.sleep();
+      }
+    }
+    step();
+  }
+}
+
+ros::Time RobotStateReplay::getCurrentTime() const
+{
+  return currentTime_;
+}
+
+bool RobotStateReplay::getTimeRange(ros::Time& start, ros::Time& end) const
+{
+  if (!view_)
+  {
+    return false;
+  }
+  start = view_->getBeginTime();
+  end = view_->getEndTime();
+  return true;
+}
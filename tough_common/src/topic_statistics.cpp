@@ -0,0 +1,217 @@
+#include "tough_common/topic_statistics.h"
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+const double MICROSECONDS_PER_SECOND = 1.0e6;
+
+inline int mostSignificantBit(const uint64_t value)
+{
+  return 63 - __builtin_clzll(value);
+}
+
+void updateMin(std::atomic<uint64_t>& target, const uint64_t value)
+{
+  uint64_t current = target.load(std::memory_order_relaxed);
+  while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+  {
+  }
+}
+
+void updateMax(std::atomic<uint64_t>& target, const uint64_t value)
+{
+  uint64_t current = target.load(std::memory_order_relaxed);
+  while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+  {
+  }
+}
+}  // namespace
+
+const size_t LatencyHistogram::NUM_BUCKETS;
+
+LatencyHistogram::LatencyHistogram()
+{
+  reset();
+}
+
+size_t LatencyHistogram::bucketIndex(const uint64_t value)
+{
+  if (value < SUB_BUCKETS)
+  {
+    return value;
+  }
+  // values in [2^msb, 2^(msb+1)) are split in SUB_BUCKETS buckets
+  int shift = mostSignificantBit(value) - SUB_BUCKET_BITS;
+  return (shift + 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::bucketValue(const size_t index)
+{
+  if (index < SUB_BUCKETS)
+  {
+    return index;
+  }
+  int shift = index / SUB_BUCKETS - 1;
+  uint64_t lower = (SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+  // middle of the bucket
+  return lower + ((uint64_t(1) << shift) >> 1);
+}
+
+void LatencyHistogram::record(const double seconds)
+{
+  const uint64_t maxValue = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+  // rounded, seconds that are a whole number of microseconds are not always exact in binary
+  double micros = std::max(0.0, seconds * MICROSECONDS_PER_SECOND + 0.5);
+  uint64_t value = micros >= maxValue ? maxValue : static_cast<uint64_t>(micros);
+
+  buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+  updateMin(min_, value);
+  updateMax(max_, value);
+}
+
+void LatencyHistogram::getSummary(HistogramSummary& summary) const
+{
+  summary = HistogramSummary();
+
+  // buckets are copied first so that the percentiles are computed from a consistent set of counts
+  uint64_t counts[NUM_BUCKETS];
+  uint64_t total = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; ++i)
+  {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0)
+  {
+    return;
+  }
+
+  summary.count = total;
+  summary.min = min_.load(std::memory_order_relaxed) / MICROSECONDS_PER_SECOND;
+  summary.max = max_.load(std::memory_order_relaxed) / MICROSECONDS_PER_SECOND;
+  summary.mean = sum_.load(std::memory_order_relaxed) / MICROSECONDS_PER_SECOND / total;
+
+  const double percentiles[] = { 0.5, 0.9, 0.99 };
+  double* results[] = { &summary.p50, &summary.p90, &summary.p99 };
+  uint64_t seen = 0;
+  size_t next = 0;
+  for (size_t i = 0; i < NUM_BUCKETS && next < 3; ++i)
+  {
+    seen += counts[i];
+    while (next < 3 && seen >= percentiles[next] * total)
+    {
+      // bucket middle can be outside the recorded range for the first and last bucket
+      double value = bucketValue(i) / MICROSECONDS_PER_SECOND;
+      *results[next] = std::min(std::max(value, summary.min), summary.max);
+      ++next;
+    }
+  }
+}
+
+void LatencyHistogram::reset()
+{
+  for (size_t i = 0; i < NUM_BUCKETS; ++i)
+  {
+    buckets_[i].store(0, std::memory_order_relaxed);
+  }
+  sum_.store(0, std::memory_order_relaxed);
+  min_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+TopicStatistics::TopicStatistics(const std::string& topic)
+  : topic_(topic), messageCount_(0), droppedCount_(0), lastReceiptNSec_(0), lastSequence_(-1)
+{
+}
+
+void TopicStatistics::setTopic(const std::string& topic)
+{
+  topic_ = topic;
+}
+
+const std::string& TopicStatistics::getTopic() const
+{
+  return topic_;
+}
+
+void TopicStatistics::recordReceipt(const ros::Time& stamp)
+{
+  ros::Time now = ros::Time::now();
+  uint64_t lastReceipt = lastReceiptNSec_.exchange(now.toNSec(), std::memory_order_relaxed);
+  if (lastReceipt != 0)
+  {
+    ros::Time last;
+    last.fromNSec(lastReceipt);
+    interArrival_.record((now - last).toSec());
+  }
+  if (!stamp.isZero())
+  {
+    age_.record((now - stamp).toSec());
+  }
+  messageCount_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TopicStatistics::recordReceipt(const std_msgs::Header& header)
+{
+  int64_t sequence = header.seq;
+  int64_t lastSequence = lastSequence_.exchange(sequence, std::memory_order_relaxed);
+  // a smaller sequence number means the publisher restarted, it is not counted as a drop
+  if (lastSequence >= 0 && sequence > lastSequence + 1)
+  {
+    droppedCount_.fetch_add(sequence - lastSequence - 1, std::memory_order_relaxed);
+  }
+  recordReceipt(header.stamp);
+}
+
+void TopicStatistics::recordReceipt()
+{
+  recordReceipt(ros::Time(0));
+}
+
+void TopicStatistics::recordCallbackDuration(const double seconds)
+{
+  callbackDuration_.record(seconds);
+}
+
+void TopicStatistics::getSummary(TopicStatisticsSummary& summary) const
+{
+  summary.topic = topic_;
+  summary.messageCount = messageCount_.load(std::memory_order_relaxed);
+  summary.droppedCount = droppedCount_.load(std::memory_order_relaxed);
+  summary.lastReceiptTime.fromNSec(lastReceiptNSec_.load(std::memory_order_relaxed));
+  interArrival_.getSummary(summary.interArrival);
+  age_.getSummary(summary.age);
+  callbackDuration_.getSummary(summary.callbackDuration);
+  summary.rate = summary.interArrival.mean > 0.0 ? 1.0 / summary.interArrival.mean : 0.0;
+}
+
+void TopicStatistics::reset()
+{
+  messageCount_.store(0, std::memory_order_relaxed);
+  droppedCount_.store(0, std::memory_order_relaxed);
+  lastReceiptNSec_.store(0, std::memory_order_relaxed);
+  lastSequence_.store(-1, std::memory_order_relaxed);
+  interArrival_.reset();
+  age_.reset();
+  callbackDuration_.reset();
+}
+
+TopicStatistics::CallbackTimer::CallbackTimer(TopicStatistics& statistics, const std_msgs::Header& header)
+  : statistics_(statistics), start_(std::chrono::steady_clock::now())
+{
+  statistics_.recordReceipt(header);
+}
+
+TopicStatistics::CallbackTimer::CallbackTimer(TopicStatistics& statistics)
+  : statistics_(statistics), start_(std::chrono::steady_clock::now())
+{
+  statistics_.recordReceipt();
+}
+
+TopicStatistics::CallbackTimer::~CallbackTimer()
+{
+  std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start_;
+  statistics_.recordCallbackDuration(duration.count());
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tough_common/joint_state_buffer.h"
+
+namespace
+{
+const size_t NUM_JOINTS = 40;
+
+// every value of update k is k, so a reader can detect values mixed from two updates
+sensor_msgs::JointState makeJointState(const uint64_t k)
+{
+  sensor_msgs::JointState msg;
+  msg.header.stamp.fromNSec(k);
+  for (size_t i = 0; i < NUM_JOINTS; ++i)
+  {
+    msg.name.push_back("joint_" + std::to_string(i));
+  }
+  msg.position.assign(NUM_JOINTS, static_cast<double>(k));
+  msg.velocity.assign(NUM_JOINTS, static_cast<double>(k));
+  msg.effort.assign(NUM_JOINTS, static_cast<double>(k));
+  return msg;
+}
+}  // namespace
+
+TEST(JointStateBufferTest, StoresLatestUpdate)
+{
+  JointStateBuffer buffer;
+  EXPECT_EQ(0u, buffer.size());
+  EXPECT_EQ(0u, buffer.getUpdateCount());
+
+  sensor_msgs::JointState msg = makeJointState(3);
+  msg.position[1] = 1.5;
+  buffer.update(msg);
+  EXPECT_EQ(NUM_JOINTS, buffer.size());
+  EXPECT_EQ(1u, buffer.getUpdateCount());
+
+  double value;
+  ASSERT_TRUE(buffer.read(JointStateBuffer::POSITION, 1, value));
+  EXPECT_DOUBLE_EQ(1.5, value);
+  EXPECT_FALSE(buffer.read(JointStateBuffer::POSITION, NUM_JOINTS, value));
+
+  std::vector<double> values;
+  ASSERT_TRUE(buffer.read(JointStateBuffer::POSITION, { 1, 0 }, values));
+  ASSERT_EQ(2u, values.size());
+  EXPECT_DOUBLE_EQ(1.5, values[0]);
+  EXPECT_DOUBLE_EQ(3.0, values[1]);
+  EXPECT_FALSE(buffer.read(JointStateBuffer::POSITION, { 0, NUM_JOINTS }, values));
+}
+
+TEST(JointStateBufferTest, MissingFieldsAreZero)
+{
+  JointStateBuffer buffer;
+  sensor_msgs::JointState msg = makeJointState(2);
+  msg.velocity.clear();
+  msg.effort.resize(1);
+  buffer.update(msg);
+
+  std::vector<double> velocities, efforts;
+  buffer.read(JointStateBuffer::VELOCITY, velocities);
+  buffer.read(JointStateBuffer::EFFORT, efforts);
+  ASSERT_EQ(NUM_JOINTS, velocities.size());
+  ASSERT_EQ(NUM_JOINTS, efforts.size());
+  EXPECT_DOUBLE_EQ(0.0, velocities[0]);
+  EXPECT_DOUBLE_EQ(2.0, efforts[0]);
+  EXPECT_DOUBLE_EQ(0.0, efforts[1]);
+}
+
+TEST(JointStateBufferTest, ReadsAreConsistentWithConcurrentWriter)
+{
+  JointStateBuffer buffer;
+  buffer.update(makeJointState(1));
+
+  const uint64_t NUM_UPDATES = 20000;
+  std::atomic<bool> done(false);
+  std::thread writer([&]() {
+    for (uint64_t k = 2; k <= NUM_UPDATES; ++k)
+    {
+      buffer.update(makeJointState(k));
+    }
+    done = true;
+  });
+
+  std::vector<double> positions, velocities, efforts;
+  uint64_t stamp;
+  uint64_t reads = 0, torn = 0, previous = 0;
+  while (!done || reads == 0)
+  {
+    buffer.readAll(positions, velocities, efforts, stamp);
+    ++reads;
+    ASSERT_EQ(NUM_JOINTS, positions.size());
+    const double k = static_cast<double>(stamp);
+    for (size_t i = 0; i < NUM_JOINTS; ++i)
+    {
+      if (positions[i] != k || velocities[i] != k || efforts[i] != k)
+      {
+        ++torn;
+      }
+    }
+    // updates are never seen out of order
+    EXPECT_GE(stamp, previous);
+    previous = stamp;
+  }
+  writer.join();
+
+  EXPECT_EQ(0u, torn);
+  EXPECT_EQ(NUM_UPDATES, buffer.getUpdateCount());
+  buffer.readAll(positions, velocities, efforts, stamp);
+  EXPECT_EQ(NUM_UPDATES, stamp);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  ros::Time::init();
+  return RUN_ALL_TESTS();
+}
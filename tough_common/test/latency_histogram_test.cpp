@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include "tough_common/topic_statistics.h"
+
+namespace
+{
+// values of a bucket are within half a sub-bucket of its middle, 1/32 of the value
+const double BUCKET_TOLERANCE = 1.0 / 16.0;
+}  // namespace
+
+TEST(LatencyHistogramTest, EmptySummaryIsZero)
+{
+  LatencyHistogram histogram;
+  HistogramSummary summary;
+  histogram.getSummary(summary);
+  EXPECT_EQ(0u, summary.count);
+  EXPECT_DOUBLE_EQ(0.0, summary.min);
+  EXPECT_DOUBLE_EQ(0.0, summary.max);
+  EXPECT_DOUBLE_EQ(0.0, summary.p99);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact)
+{
+  // values below 16 microseconds have a bucket each
+  LatencyHistogram histogram;
+  for (int micros = 1; micros <= 15; ++micros)
+  {
+    histogram.record(micros * 1e-6);
+  }
+  HistogramSummary summary;
+  histogram.getSummary(summary);
+  EXPECT_EQ(15u, summary.count);
+  EXPECT_NEAR(1e-6, summary.min, 1e-12);
+  EXPECT_NEAR(15e-6, summary.max, 1e-12);
+  EXPECT_NEAR(8e-6, summary.p50, 1e-12);
+  EXPECT_NEAR(14e-6, summary.p90, 1e-12);
+}
+
+TEST(LatencyHistogramTest, PercentilesAreClampedToRecordedRange)
+{
+  // the middle of the bucket of 1000us is 1008us
+  LatencyHistogram histogram;
+  histogram.record(0.001);
+  HistogramSummary summary;
+  histogram.getSummary(summary);
+  EXPECT_EQ(1u, summary.count);
+  EXPECT_NEAR(0.001, summary.p50, 1e-9);
+  EXPECT_NEAR(0.001, summary.p99, 1e-9);
+  EXPECT_NEAR(0.001, summary.mean, 1e-9);
+}
+
+TEST(LatencyHistogramTest, PercentilesAreWithinBucketPrecision)
+{
+  LatencyHistogram histogram;
+  for (int micros = 1; micros <= 100000; ++micros)
+  {
+    histogram.record(micros * 1e-6);
+  }
+  HistogramSummary summary;
+  histogram.getSummary(summary);
+  EXPECT_EQ(100000u, summary.count);
+  EXPECT_NEAR(0.05, summary.mean, 1e-5);
+  EXPECT_NEAR(0.05, summary.p50, 0.05 * BUCKET_TOLERANCE);
+  EXPECT_NEAR(0.09, summary.p90, 0.09 * BUCKET_TOLERANCE);
+  EXPECT_NEAR(0.099, summary.p99, 0.099 * BUCKET_TOLERANCE);
+  EXPECT_LE(summary.p99, summary.max);
+}
+
+TEST(LatencyHistogramTest, OutOfRangeValuesAreClamped)
+{
+  LatencyHistogram histogram;
+  histogram.record(-1.0);
+  histogram.record(1.0e6);
+  HistogramSummary summary;
+  histogram.getSummary(summary);
+  EXPECT_EQ(2u, summary.count);
+  EXPECT_DOUBLE_EQ(0.0, summary.min);
+  // durations are stored in 32 bits of microseconds
+  EXPECT_NEAR(4294.967295, summary.max, 1e-6);
+}
+
+TEST(LatencyHistogramTest, ResetRemovesValues)
+{
+  LatencyHistogram histogram;
+  histogram.record(0.5);
+  histogram.reset();
+  histogram.record(0.25);
+  HistogramSummary summary;
+  histogram.getSummary(summary);
+  EXPECT_EQ(1u, summary.count);
+  EXPECT_DOUBLE_EQ(0.25, summary.min);
+  EXPECT_DOUBLE_EQ(0.25, summary.max);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  ros::Time::init();
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include "tough_common/state_history.h"
+
+namespace
+{
+struct Lerp
+{
+  void operator()(const double before, const double after, const double ratio, double& result) const
+  {
+    result = before + (after - before) * ratio;
+  }
+};
+
+bool interpolateAt(const StateHistory<double>& history, const double seconds, double& result)
+{
+  return history.interpolate(ros::Time(seconds), result, Lerp());
+}
+}  // namespace
+
+TEST(StateHistoryTest, InterpolatesBetweenBracketingSamples)
+{
+  StateHistory<double> history(10);
+  history.push(ros::Time(1.0), 10.0);
+  history.push(ros::Time(2.0), 20.0);
+  history.push(ros::Time(4.0), 40.0);
+
+  double result;
+  ASSERT_TRUE(interpolateAt(history, 1.5, result));
+  EXPECT_DOUBLE_EQ(15.0, result);
+  ASSERT_TRUE(interpolateAt(history, 3.0, result));
+  EXPECT_DOUBLE_EQ(30.0, result);
+
+  // stamps of the samples return the samples themselves
+  ASSERT_TRUE(interpolateAt(history, 1.0, result));
+  EXPECT_DOUBLE_EQ(10.0, result);
+  ASSERT_TRUE(interpolateAt(history, 2.0, result));
+  EXPECT_DOUBLE_EQ(20.0, result);
+  ASSERT_TRUE(interpolateAt(history, 4.0, result));
+  EXPECT_DOUBLE_EQ(40.0, result);
+}
+
+TEST(StateHistoryTest, CopyBracketReportsRatio)
+{
+  StateHistory<double> history(10);
+  history.push(ros::Time(1.0), 10.0);
+  history.push(ros::Time(3.0), 30.0);
+
+  double before, after, ratio;
+  ASSERT_TRUE(history.copyBracket(ros::Time(2.5), before, after, ratio));
+  EXPECT_DOUBLE_EQ(10.0, before);
+  EXPECT_DOUBLE_EQ(30.0, after);
+  EXPECT_DOUBLE_EQ(0.75, ratio);
+
+  // the latest sample brackets itself
+  ASSERT_TRUE(history.copyBracket(ros::Time(3.0), before, after, ratio));
+  EXPECT_DOUBLE_EQ(30.0, before);
+  EXPECT_DOUBLE_EQ(30.0, after);
+  EXPECT_DOUBLE_EQ(0.0, ratio);
+}
+
+TEST(StateHistoryTest, RejectsTimesOutsideTheHistory)
+{
+  StateHistory<double> history(10);
+  double result = -1.0;
+  EXPECT_FALSE(interpolateAt(history, 1.0, result));
+
+  history.push(ros::Time(1.0), 10.0);
+  history.push(ros::Time(2.0), 20.0);
+  EXPECT_FALSE(interpolateAt(history, 0.5, result));
+  EXPECT_FALSE(interpolateAt(history, 2.5, result));
+  EXPECT_DOUBLE_EQ(-1.0, result);
+}
+
+TEST(StateHistoryTest, OverwritesOldestSampleWhenFull)
+{
+  StateHistory<double> history(3);
+  for (int i = 1; i <= 5; ++i)
+  {
+    history.push(ros::Time(i), i * 10.0);
+  }
+  EXPECT_EQ(3u, history.size());
+
+  ros::Time oldest, latest;
+  ASSERT_TRUE(history.getTimeRange(oldest, latest));
+  EXPECT_DOUBLE_EQ(3.0, oldest.toSec());
+  EXPECT_DOUBLE_EQ(5.0, latest.toSec());
+
+  double result;
+  EXPECT_FALSE(interpolateAt(history, 2.5, result));
+  ASSERT_TRUE(interpolateAt(history, 4.5, result));
+  EXPECT_DOUBLE_EQ(45.0, result);
+}
+
+TEST(StateHistoryTest, GrowsToCoverTheWindow)
+{
+  StateHistory<double> history(ros::Duration(1.0));
+  for (int i = 0; i <= 12; ++i)
+  {
+    history.push(ros::Time(i * 0.25), i * 10.0);
+  }
+  EXPECT_EQ(5u, history.size());
+
+  ros::Time oldest, latest;
+  ASSERT_TRUE(history.getTimeRange(oldest, latest));
+  EXPECT_DOUBLE_EQ(2.0, oldest.toSec());
+  EXPECT_DOUBLE_EQ(3.0, latest.toSec());
+
+  // a faster signal needs more samples for the same window
+  for (int i = 1; i <= 20; ++i)
+  {
+    history.push(ros::Time(3.0 + i * 0.125), 120.0 + i * 5.0);
+  }
+  EXPECT_EQ(9u, history.size());
+  double result;
+  ASSERT_TRUE(interpolateAt(history, 4.5, result));
+  EXPECT_DOUBLE_EQ(180.0, result);
+  ASSERT_TRUE(interpolateAt(history, 5.0625, result));
+  EXPECT_DOUBLE_EQ(202.5, result);
+  EXPECT_FALSE(interpolateAt(history, 4.4, result));
+}
+
+TEST(StateHistoryTest, StopsGrowingAtMaxCapacity)
+{
+  StateHistory<double> history(ros::Duration(10.0), 3);
+  for (int i = 1; i <= 5; ++i)
+  {
+    history.push(ros::Time(i), i * 10.0);
+  }
+  EXPECT_EQ(3u, history.size());
+  double result;
+  EXPECT_FALSE(interpolateAt(history, 2.5, result));
+  ASSERT_TRUE(interpolateAt(history, 4.5, result));
+  EXPECT_DOUBLE_EQ(45.0, result);
+}
+
+TEST(StateHistoryTest, OlderStampClearsHistory)
+{
+  StateHistory<double> history(10);
+  history.push(ros::Time(10.0), 100.0);
+  history.push(ros::Time(11.0), 110.0);
+
+  // e.g. simulation time was reset
+  history.push(ros::Time(1.0), 10.0);
+  EXPECT_EQ(1u, history.size());
+  double result;
+  EXPECT_FALSE(interpolateAt(history, 10.5, result));
+  ASSERT_TRUE(interpolateAt(history, 1.0, result));
+  EXPECT_DOUBLE_EQ(10.0, result);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  ros::Time::init();
+  return RUN_ALL_TESTS();
+}
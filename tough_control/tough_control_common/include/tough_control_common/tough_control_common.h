@@ -5,6 +5,7 @@
 #include <tough_controller_interface/arm_control_interface.h>
 #include <tough_controller_interface/chest_control_interface.h>
 #include <tough_controller_interface/pelvis_control_interface.h>
+#include <tough_controller_interface/command_monitor.h>
 
 class ToughControlCommon
 {
@@ -12,9 +13,12 @@ private:
   ros::NodeHandle nh_;
 
   ros::Publisher stop_traj_pub_;
+  CommandMonitor* command_monitor_;
   ArmControlInterface armTraj;
   ChestControlInterface chestTraj;
   PelvisControlInterface pelvisTraj;
+  // joints of the arms, chest and neck, the stop is complete when they are still
+  std::vector<std::string> stopped_joint_names_;
 
 public:
 
@@ -27,14 +31,21 @@ public:
   ~ToughControlCommon();
 
   /**
-   * @brief Stops all the executing trajectories on the robot.
+   * @brief Stops all the executing trajectories on the robot. Pending commands are cancelled and this blocks until
+   * the arms, the chest and the neck have stopped moving. The legs keep balancing the robot and are not waited for.
    * 
+   * @param timeout               - Maximum time to wait for the robot to stop
+   * @return true                 - When the robot stopped
+   * @return false
    */
-  void stopAllTrajectories(void);
+  bool stopAllTrajectories(const ros::Duration& timeout = ros::Duration(2.0));
 
   /**
-   * @brief Reset the robot to its Default Pose.
+   * @brief Reset the robot to its Default Pose. This blocks until all the body parts reached their default pose.
    * 
+   * @param timeout               - Maximum time to wait for all the body parts
+   * @return true                 - When the robot reached the default pose
+   * @return false
    */
-  void resetRobot();
+  bool resetRobot(const ros::Duration& timeout = ros::Duration(10.0));
 };
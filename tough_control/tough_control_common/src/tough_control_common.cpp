@@ -1,6 +1,7 @@
 #include <tough_control_common/tough_control_common.h>
 
-ToughControlCommon::ToughControlCommon(ros::NodeHandle nh) : nh_(nh), armTraj(nh), chestTraj(nh), pelvisTraj(nh)
+ToughControlCommon::ToughControlCommon(ros::NodeHandle nh)
+  : nh_(nh), command_monitor_(CommandMonitor::getCommandMonitor(nh)), armTraj(nh), chestTraj(nh), pelvisTraj(nh)
 
 {
   std::string robot_name;
@@ -11,13 +12,24 @@ ToughControlCommon::ToughControlCommon(ros::NodeHandle nh) : nh_(nh), armTraj(nh
       TOUGH_COMMON_NAMES::TOPIC_PREFIX + robot_name + TOUGH_COMMON_NAMES::CONTROL_TOPIC_PREFIX +
           TOUGH_COMMON_NAMES::STOP_ALL_TRAJECTORY_TOPIC,
       1, true);
+
+  // the legs keep balancing the robot after a stop, only the upper body is waited for
+  RobotDescription* rd = RobotDescription::getRobotDescription(nh_);
+  std::vector<std::string> joint_names;
+  rd->getLeftArmJointNames(stopped_joint_names_);
+  rd->getRightArmJointNames(joint_names);
+  stopped_joint_names_.insert(stopped_joint_names_.end(), joint_names.begin(), joint_names.end());
+  rd->getChestJointNames(joint_names);
+  stopped_joint_names_.insert(stopped_joint_names_.end(), joint_names.begin(), joint_names.end());
+  rd->getNeckJointNames(joint_names);
+  stopped_joint_names_.insert(stopped_joint_names_.end(), joint_names.begin(), joint_names.end());
 }
 
 ToughControlCommon::~ToughControlCommon()
 {
 }
 
-void ToughControlCommon::stopAllTrajectories(void)
+bool ToughControlCommon::stopAllTrajectories(const ros::Duration& timeout)
 {
   ihmc_msgs::StopAllTrajectoryRosMessage stop_msg;
   stop_msg.unique_id = -1;
@@ -25,14 +37,35 @@ void ToughControlCommon::stopAllTrajectories(void)
   // send the message
   stop_traj_pub_.publish(stop_msg);
 
-  ros::Duration(1).sleep();
+  // commands that were executing will not reach their targets
+  command_monitor_->cancelAll();
+  command_monitor_->track(stop_msg.unique_id, stopped_joint_names_, std::vector<double>(), 0.0);
+  return command_monitor_->waitForCommand(stop_msg.unique_id, timeout);
 }
 
-void ToughControlCommon::resetRobot()
+bool ToughControlCommon::resetRobot(const ros::Duration& timeout)
 {
+  std::vector<long> commands;
   armTraj.moveToDefaultPose(RobotSide::LEFT, 1.0f);
+  commands.push_back(armTraj.getLastCommandId());
   armTraj.moveToDefaultPose(RobotSide::RIGHT, 1.0f);
+  commands.push_back(armTraj.getLastCommandId());
   pelvisTraj.controlPelvisHeight(0.75f);
+  commands.push_back(pelvisTraj.getLastCommandId());
   chestTraj.resetPose(2.0f);
-  ros::Duration(2).sleep();
+  commands.push_back(chestTraj.getLastCommandId());
+
+  // all the body parts move at the same time, they share the timeout
+  const ros::WallTime start = ros::WallTime::now();
+  bool success = true;
+  for (long unique_id : commands)
+  {
+    ros::Duration remaining = timeout - ros::Duration((ros::WallTime::now() - start).toSec());
+    if (remaining < ros::Duration(0))
+    {
+      remaining = ros::Duration(0);
+    }
+    success = command_monitor_->waitForCommand(unique_id, remaining) && success;
+  }
+  return success;
 }
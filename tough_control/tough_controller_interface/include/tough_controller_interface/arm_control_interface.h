@@ -9,13 +9,18 @@
 #include <ihmc_msgs/HandTrajectoryRosMessage.h>
 #include <ihmc_msgs/SE3TrajectoryPointRosMessage.h>
 #include <ihmc_msgs/GoHomeRosMessage.h>
+#include <ihmc_msgs/StopAllTrajectoryRosMessage.h>
 #include <geometry_msgs/Pose.h>
 #include <trajectory_msgs/JointTrajectory.h>
 #include <tf/transform_listener.h>
 #include <tf/tf.h>
+#include <Eigen/Core>
+#include <memory>
 #include "tough_common/robot_state.h"
 #include "tough_common/robot_description.h"
 #include "tough_controller_interface/tough_control_interface.h"
+#include "tough_controller_interface/trajectory_streamer.h"
+#include "tough_controller_interface/hand_jogger.h"
 
 /**
  * @brief The ArmControlInterface class provides ability to move arms of humanoid robots supported by
@@ -67,6 +72,36 @@ public:
     float time;
   };
 
+  /**
+   * @brief The WristGuard struct stores the thresholds of a guarded move. Thresholds are compared to the change of the
+   * wrist wrench from the start of the move. The weight of the hand and of a grasped object is removed only while the
+   * wrist keeps the orientation it had at the start: the wrench is measured in the frame of the sensor, so rotating
+   * the wrist changes the measured weight and can trip the thresholds without contact. Raise the thresholds for moves
+   * that rotate the wrist with a heavy object. When a threshold trips the arm holds its current position. If that
+   * position cannot be read, all the trajectories of the robot are stopped.
+   */
+  struct WristGuard
+  {
+    double force_threshold = 20.0;   // N, norm of the change of the force
+    double torque_threshold = 5.0;   // Nm, norm of the change of the torque
+    double stop_time = 0.05;         // s, time given to the controller to hold the arm where it is
+    double max_wrench_age = 0.5;     // s, the move is not started without a wrench more recent than this
+  };
+
+  /**
+   * @brief The GuardedMoveResult struct reports the contact detected during a guarded move.
+   *
+   * contact is true when a threshold tripped and the arm was stopped.
+   * contact_time is the stamp of the wrench that tripped the threshold.
+   * wrench is the wrist wrench at contact, as measured by the sensor.
+   */
+  struct GuardedMoveResult
+  {
+    bool contact = false;
+    ros::Time contact_time;
+    geometry_msgs::Wrench wrench;
+  };
+
   /**
    * @brief moveToDefaultPose Moves the robot arm to default position
    *
@@ -91,6 +126,24 @@ public:
    */
   bool moveArmJoints(const RobotSide side, const std::vector<std::vector<double> >& arm_pose, const float time);
 
+  /**
+   * @brief moveArmJointsGuarded Moves arm joints like moveArmJoints and stops the arm as soon as the wrist wrench
+   * changes by more than the thresholds of the guard. Blocks until the arm stops or the command is completed, see
+   * ToughControlInterface::waitForCommand.
+   *
+   * @param side          Side of the robot. It can be RIGHT or LEFT.
+   * @param arm_pose      A vector that stores a vector with 7 values one for each joint. Number of values in the vector
+   *                      are the number of trajectory points.
+   * @param time          Total time to execute the trajectory. each trajectory point is equally spaced in time.
+   * @param guard         Force and torque thresholds
+   * @param result        [output] contact time and wrench when a threshold tripped
+   * @return true         When the arm stopped at contact or reached the target
+   * @return false        When the target was not reached, or the wrist sensor has no recent wrench and the arm was
+   *                      not moved
+   */
+  bool moveArmJointsGuarded(const RobotSide side, const std::vector<std::vector<double> >& arm_pose, const float time,
+                            const WristGuard& guard, GuardedMoveResult& result);
+
   /**
    * @brief generateArmMessage Generates ros message to be sent to the arm, but does not publish anything.
    * 
@@ -118,6 +171,24 @@ public:
                           const std::vector<ihmc_msgs::OneDoFJointTrajectoryRosMessage>& arm_trajectory,
                           ihmc_msgs::ArmTrajectoryRosMessage& msg);
 
+  /**
+   * @brief generateArmMessage Generates ros message for a complete trajectory at once, but does not publish anything.
+   * All the positions are clamped to the joint limits in one pass and the message is allocated once, which makes
+   * converting long trajectories cheap.
+   *
+   * @param side          Side of the robot. It can be RIGHT or LEFT.
+   * @param positions     Joint positions in radians, one row per trajectory point and one column per joint in the
+   * order of the arm joint names.
+   * @param times         Time of each trajectory point from the start of the trajectory in seconds.
+   * @param msg           The message is generated in this reference.
+   * @param velocities    Joint velocities with the same size as positions. Velocities are zero if it is empty.
+   *
+   * @return false if the sizes of positions, times and velocities do not match the arm.
+   */
+  bool generateArmMessage(const RobotSide side, const Eigen::MatrixXd& positions, const Eigen::VectorXd& times,
+                          ihmc_msgs::ArmTrajectoryRosMessage& msg,
+                          const Eigen::MatrixXd& velocities = Eigen::MatrixXd());
+
   /**
    * @brief moveArmJoints Moves arm joints to given joint angles. All angles in radians.
    * 
@@ -167,6 +238,23 @@ public:
   void moveArmInTaskSpace(const RobotSide side, const geometry_msgs::Pose& pose, const float time,
                           int baseForControl = TOUGH_COMMON_NAMES::PELVIS_ZUP_FRAME_HASH);
 
+  /**
+   * @brief moveArmInTaskSpaceGuarded  Moves the arm like moveArmInTaskSpace and stops the arm as soon as the wrist
+   * wrench changes by more than the thresholds of the guard. Blocks until the arm stops or the command is completed.
+   *
+   * @param side  Side of the robot. It can be RIGHT or LEFT.
+   * @param pose  The pose in task space to move the arm to.
+   * @param time  Total time to execute the trajectory.
+   * @param guard Force and torque thresholds
+   * @param result [output] contact time and wrench when a threshold tripped
+   * @param baseForControl FrameHash in which the pose is defined
+   * @return true When the arm stopped at contact or reached the target
+   * @return false When the target was not reached, or the wrist sensor has no recent wrench and the arm was not moved
+   */
+  bool moveArmInTaskSpaceGuarded(const RobotSide side, const geometry_msgs::Pose& pose, const float time,
+                                 const WristGuard& guard, GuardedMoveResult& result,
+                                 int baseForControl = TOUGH_COMMON_NAMES::PELVIS_ZUP_FRAME_HASH);
+
   /**
    * @brief moveArmInTaskSpace  Moves the arm(s) to the given position in task space (world frame).
    * 
@@ -185,6 +273,96 @@ public:
    */
   void moveArmTrajectory(const RobotSide side, const trajectory_msgs::JointTrajectory& traj);
 
+  /**
+   * @brief streamArmTrajectory Moves the arm to follow a trajectory that is sent in chunks. The first chunk is sent
+   * immediately, the following chunks are queued on the controller while the arm moves. A stream on the same side
+   * that is still running is cancelled, as it is by any other arm or hand command that overrides the arm. Every
+   * chunk is tracked by the CommandMonitor.
+   *
+   * @param side              Side of the robot. It can be RIGHT or LEFT.
+   * @param traj              Trajectory in the form of trajectory_msgs::JointTrajectory
+   * @param chunk_size        Number of trajectory points in each message
+   * @param lookahead         Time in seconds before the end of a chunk at which the next chunk is queued
+   * @return true             When the first chunk is published
+   * @return false
+   */
+  bool streamArmTrajectory(const RobotSide side, const trajectory_msgs::JointTrajectory& traj,
+                           const size_t chunk_size = 20, const double lookahead = 1.0);
+
+  /**
+   * @brief cancelArmTrajectoryStream Stops sending the remaining chunks of a stream. Chunks that were already sent are
+   * executed, use stopAllTrajectories to stop the arm immediately.
+   *
+   * @param side              Side of the robot. It can be RIGHT or LEFT.
+   */
+  void cancelArmTrajectoryStream(const RobotSide side);
+
+  /**
+   * @brief isArmTrajectoryStreaming Checks if a stream still has chunks to send
+   *
+   * @param side              Side of the robot. It can be RIGHT or LEFT.
+   * @return true             While chunks are left to send
+   * @return false
+   */
+  bool isArmTrajectoryStreaming(const RobotSide side) const;
+
+  /**
+   * @brief startHandJog Starts moving the hand with velocity commands, see jogHand. Setpoints are sent at 50Hz in the
+   * pelvis frame while the hand moves.
+   *
+   * @param side              Side of the robot. It can be RIGHT or LEFT.
+   * @return true             When jogging
+   * @return false            When the pose of the hand is not available
+   */
+  bool startHandJog(const RobotSide side);
+
+  /**
+   * @brief jogHand Sets the velocity of a jogging hand. The hand stops when it is not called for the command timeout
+   * of the jog limits.
+   *
+   * @param side              Side of the robot. It can be RIGHT or LEFT.
+   * @param velocity          Linear velocity in m/s and angular velocity in rad/s in the pelvis frame
+   * @return true             When the hand is jogging
+   * @return false
+   */
+  bool jogHand(const RobotSide side, const geometry_msgs::Twist& velocity);
+
+  /**
+   * @brief stopHandJog Stops sending setpoints. Set a zero velocity first to stop the hand smoothly.
+   *
+   * @param side              Side of the robot. It can be RIGHT or LEFT.
+   */
+  void stopHandJog(const RobotSide side);
+
+  /**
+   * @brief isHandJogging Checks if a hand is jogging
+   *
+   * @param side              Side of the robot. It can be RIGHT or LEFT.
+   * @return true
+   * @return false
+   */
+  bool isHandJogging(const RobotSide side) const;
+
+  /**
+   * @brief setHandJogLimits Sets the speed, acceleration and lead limits of the jogging hands
+   *
+   * @param limits            Limits used for both hands
+   */
+  void setHandJogLimits(const HandJogger::Limits& limits);
+
+  /**
+   * @brief generateArmMessage Generates ros message for a joint trajectory, but does not publish anything. Joints are
+   * gathered by name when the trajectory names all the arm joints, in any order and along with joints of other parts.
+   * Otherwise every point must have exactly the arm joint positions in their order.
+   *
+   * @param side              Side of the robot. It can be RIGHT or LEFT.
+   * @param traj              Trajectory in the form of trajectory_msgs::JointTrajectory
+   * @param msg               [output]
+   * @return false if the trajectory points do not match the arm.
+   */
+  bool generateArmMessage(const RobotSide side, const trajectory_msgs::JointTrajectory& traj,
+                          ihmc_msgs::ArmTrajectoryRosMessage& msg);
+
   /**
    * @brief nudgeArm Nudges the Arm in the desired direction by a given nudge step with respect
    *            to the pelvis frame of the robot.
@@ -314,19 +492,40 @@ public:
 private:
   const std::vector<double> ZERO_POSE;
   int NUM_ARM_JOINTS;
-  std::vector<std::pair<double, double> > joint_limits_left_;
-  std::vector<std::pair<double, double> > joint_limits_right_;
+  RobotType robot_type_;
+  JointChainLimits joint_limits_left_;
+  JointChainLimits joint_limits_right_;
 
   ros::Publisher armTrajectoryPublisher;
   ros::Publisher handTrajectoryPublisher;
   ros::Publisher taskSpaceTrajectoryPublisher;
   ros::Publisher homePositionPublisher;
+  ros::Publisher stopAllTrajectoriesPublisher;
   ros::Publisher markerPub_;
   ros::Subscriber armTrajectorySubscriber;
 
+  std::unique_ptr<TrajectoryStreamer> left_arm_streamer_;
+  std::unique_ptr<TrajectoryStreamer> right_arm_streamer_;
+  // expected end of the last chunk sent by each stream, only used by the publisher of its chunks
+  ros::Time left_stream_end_;
+  ros::Time right_stream_end_;
+  std::unique_ptr<HandJogger> left_hand_jogger_;
+  std::unique_ptr<HandJogger> right_hand_jogger_;
+
+  void publishArmMessage(const ihmc_msgs::ArmTrajectoryRosMessage& msg,
+                         const CommandTracer::Clock::time_point construction_time = CommandTracer::Clock::time_point());
+  void trackArmMessage(const ihmc_msgs::ArmTrajectoryRosMessage& msg, const double delay);
+  void publishHandMessage(const ihmc_msgs::HandTrajectoryRosMessage& msg);
+  void generateHandMessage(const RobotSide side, const ihmc_msgs::SE3TrajectoryPointRosMessage& point,
+                           const int baseForControl, ihmc_msgs::HandTrajectoryRosMessage& msg);
+  long publishArmTrajectoryChunk(const RobotSide side, const trajectory_msgs::JointTrajectory& chunk,
+                                 const int execution_mode, const long previous_message_id);
+  bool guardedMove(const RobotSide side, const std::function<long()>& publish, const WristGuard& guard,
+                   GuardedMoveResult& result);
   void poseToSE3TrajectoryPoint(const geometry_msgs::Pose& pose, ihmc_msgs::SE3TrajectoryPointRosMessage& point);
-  void appendTrajectoryPoint(ihmc_msgs::ArmTrajectoryRosMessage& msg,
-                             const trajectory_msgs::JointTrajectoryPoint& point);
+  bool readJogPose(const RobotSide side, geometry_msgs::Pose& pose);
+  void publishJogSetpoint(const RobotSide side, const geometry_msgs::Pose& pose, const geometry_msgs::Twist& velocity,
+                          const double time);
 };
 
 #endif  // ARM_CONTROL_INTERFACE_H
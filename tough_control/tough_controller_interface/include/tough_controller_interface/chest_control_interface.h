@@ -23,7 +23,11 @@ private:
   ros::Publisher chestTrajPublisher_;
   ros::Publisher homePositionPublisher_;
   std::vector<std::string> chestJointNames_;
-  std::vector<int> chestJointNumbers_;
+  // never read directly, the handle caches its indices and the interface can be used from several threads
+  JointGroupHandle chestJoints_;
+
+  void publishMessage(const ihmc_msgs::ChestTrajectoryRosMessage& msg,
+                      const CommandTracer::Clock::time_point construction_time);
 
 public:
   /**
@@ -0,0 +1,170 @@
+#ifndef COMMAND_MONITOR_H
+#define COMMAND_MONITOR_H
+
+#include <ros/ros.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "tough_common/robot_state.h"
+
+/**
+ * @brief Final state of a command sent to the controller
+ */
+enum class CommandStatus
+{
+  SUCCEEDED = 0,  // trajectory time elapsed and the joints converged
+  TIMED_OUT,      // joints did not converge within the timeout after the trajectory time
+  CANCELLED       // trajectories were stopped, or another command overrode the joints, before it completed
+};
+
+typedef std::shared_future<CommandStatus> CommandFuture;
+typedef std::function<void(const long unique_id, const CommandStatus status)> CommandCallback;
+
+/**
+ * @brief CommandMonitor tracks the commands sent to the controller by their unique_id and detects when they are
+ * completed. The controller does not acknowledge trajectory messages, so a command is completed when its trajectory
+ * time has elapsed and the joints it moves have converged, i.e. they are within the position tolerance of the target
+ * (when the target is known) and their velocities are below the velocity tolerance.
+ *
+ * Commands are checked from a background thread that only reads RobotStateInformer, so joint state callbacks must be
+ * processed by a spinner for futures and callbacks to complete. Use ToughControlInterface::waitForCommand in single
+ * threaded nodes.
+ */
+class CommandMonitor
+{
+public:
+  /**
+   * @brief Get the CommandMonitor object. It is shared by all the control interfaces of a node.
+   *
+   * @param nh                  nodehandle used to create the RobotStateInformer
+   * @return CommandMonitor*
+   */
+  static CommandMonitor* getCommandMonitor(ros::NodeHandle nh);
+  ~CommandMonitor();
+
+  // disable assign and copy
+  CommandMonitor(CommandMonitor const&) = delete;
+  void operator=(CommandMonitor const&) = delete;
+
+  /**
+   * @brief Start tracking a command that was just published
+   *
+   * @param unique_id           unique id of the published message
+   * @param joint_names         joints moved by the command. All the joints of the robot when it is empty.
+   * @param targets             final positions of the joints in the same order. Only the velocities are checked when
+   *                            it is empty.
+   * @param duration            trajectory time of the command in seconds
+   * @param overrides           true when the command was sent in OVERRIDE mode. Pending commands that move any of its
+   *                            joints are completed with CANCELLED status, as the controller dropped them. Commands
+   *                            tracked on all the joints do not know which joints they move and are not overridden.
+   * @return CommandFuture      future completed with the status of the command
+   */
+  CommandFuture track(const long unique_id, const std::vector<std::string>& joint_names,
+                      const std::vector<double>& targets, const double duration, const bool overrides = true);
+
+  /**
+   * @brief Get the future of a tracked command. Futures of the last few completed commands are kept.
+   *
+   * @param unique_id           unique id of the command
+   * @param future              [output]
+   * @return true               when the command is known
+   * @return false
+   */
+  bool getFuture(const long unique_id, CommandFuture& future) const;
+
+  /**
+   * @brief Call a function when a command is completed. It is called from the monitor thread, or immediately when the
+   * command is already completed.
+   *
+   * @param unique_id           unique id of the command
+   * @param callback            function called with the status of the command
+   * @return true               when the command is known
+   * @return false
+   */
+  bool addCallback(const long unique_id, const CommandCallback& callback);
+
+  /**
+   * @brief Block until a command is completed. Callbacks are processed from this call when there is no spinner
+   * thread, see RobotStateInformer::waitForCondition.
+   *
+   * @param unique_id           unique id of the command
+   * @param timeout             maximum time to wait
+   * @return true               when the command succeeded
+   * @return false              when it timed out, was cancelled or is not tracked
+   */
+  bool waitForCommand(const long unique_id, const ros::Duration& timeout);
+
+  /**
+   * @brief Complete a pending command with CANCELLED status. Used when a command is interrupted by another one.
+   *
+   * @param unique_id           unique id of the command
+   * @return true               when the command was pending
+   * @return false
+   */
+  bool cancel(const long unique_id);
+
+  /**
+   * @brief Complete all the pending commands with CANCELLED status. Used when the trajectories are stopped.
+   */
+  void cancelAll();
+
+  /**
+   * @brief Set the tolerances used to decide that the joints converged
+   *
+   * @param position_tolerance  maximum distance from the target in radians
+   * @param velocity_tolerance  maximum joint velocity in radians per second
+   */
+  void setTolerances(const double position_tolerance, const double velocity_tolerance);
+
+  /**
+   * @brief Set the time allowed for the joints to converge after the trajectory time has elapsed
+   *
+   * @param timeout             time in seconds
+   */
+  void setTimeout(const double timeout);
+
+private:
+  explicit CommandMonitor(ros::NodeHandle nh);
+  static CommandMonitor* currentObject_;
+
+  struct Command
+  {
+    long unique_id;
+    JointGroupHandle joints;
+    bool all_joints;  // joints moved by the command are not known
+    std::vector<double> targets;
+    ros::Time end_time;
+    std::promise<CommandStatus> promise;
+    CommandFuture future;
+    std::vector<CommandCallback> callbacks;
+  };
+  typedef std::shared_ptr<Command> CommandPtr;
+
+  RobotStateInformer* state_informer_;
+  double position_tolerance_;
+  double velocity_tolerance_;
+  double timeout_;
+
+  std::map<long, CommandPtr> pending_;
+  // futures of the last completed commands, oldest first in completed_order_
+  std::map<long, CommandFuture> completed_;
+  std::deque<long> completed_order_;
+  mutable std::mutex mutex_;
+
+  bool running_;
+  std::condition_variable stop_condition_;
+  std::thread thread_;
+
+  void monitorCommands();
+  bool hasConverged(const Command& command) const;
+  bool sharesJoints(const Command& first, const Command& second) const;
+  void complete(const CommandPtr& command, const CommandStatus status);
+};
+
+#endif  // COMMAND_MONITOR_H
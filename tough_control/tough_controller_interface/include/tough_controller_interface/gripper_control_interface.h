@@ -6,6 +6,7 @@
 #include "ihmc_msgs/HandDesiredConfigurationRosMessage.h"
 #include <tough_common/robot_description.h>
 #include "tough_controller_interface/tough_control_interface.h"
+#include "tough_controller_interface/gripper_monitor.h"
 #include <map>
 
 // Note: HOOK Mode doesn't work. Tested on actual robotiq gripper
@@ -18,6 +19,7 @@ class GripperControlInterface : public ToughControlInterface
 {
 private:
   ros::Publisher gripperPublisher_;
+  GripperMonitor* gripper_monitor_;
 
 public:
   /**
@@ -135,9 +137,35 @@ public:
   std::string getModeName(const GRIPPER_MODES mode) const;
 
   /**
-   * @brief Get the Joint Position for the joint of jointName. The order for
-   * the Joints' Names, Numbers, Positions, Velocities and Efforts in their
-   * vectors are same.
+   * @brief Get the state of the gripper detected from its finger joints, see GripperMonitor
+   *
+   * @param side              Side of the Robot. it can be LEFT or RIGHT
+   * @return GripperState
+   */
+  GripperState getGripperState(const RobotSide side) const;
+
+  /**
+   * @brief Block until the gripper has grasped an object or closed empty. Use it after closing the gripper to
+   * continue as soon as the grasp is confirmed.
+   *
+   * @param side              Side of the Robot. it can be LEFT or RIGHT
+   * @param timeout           Maximum time to wait
+   * @return true             When an object is grasped
+   * @return false            When the gripper closed empty or the timeout expired
+   */
+  bool waitForGrasp(const RobotSide side, const ros::Duration& timeout = ros::Duration(5.0));
+
+  /**
+   * @brief Get the GripperMonitor used by this interface, e.g. to add callbacks on state changes
+   *
+   * @return GripperMonitor*
+   */
+  GripperMonitor* getGripperMonitor() const;
+
+  /**
+   * @brief Get the positions of the finger joints of the gripper, in the order of
+   * GripperMonitor::getFingerJointNames. When the gripper is not monitored, it is the position of the joint named
+   * after the end effector frame.
    *
    * @param joints            [output]
    * @param side              Side of the Robot. it can be LEFT or RIGHT
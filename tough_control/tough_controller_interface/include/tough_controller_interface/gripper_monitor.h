@@ -0,0 +1,204 @@
+#ifndef GRIPPER_MONITOR_H
+#define GRIPPER_MONITOR_H
+
+#include <ros/ros.h>
+#include <sensor_msgs/JointState.h>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "tough_common/robot_state.h"
+#include "tough_common/robot_description.h"
+#include "tough_common/callback_list.h"
+
+/**
+ * @brief State of a gripper detected from the positions, velocities and efforts of its finger joints
+ */
+enum class GripperState
+{
+  UNKNOWN = 0,   // finger joints are not available
+  MOVING,        // fingers are moving without load
+  OPEN,          // fingers are still and not closed
+  CLOSED_EMPTY,  // fingers are still and closed without load, nothing was grasped
+  GRASPED,       // fingers are still and loaded by an object
+  SLIPPING       // fingers of a grasp are closing further, the object is slipping out of the hand
+};
+
+typedef std::function<void(const RobotSide side, const GripperState previous, const GripperState state)>
+    GripperStateCallback;
+
+/**
+ * @brief GripperMonitor classifies the state of both grippers from every joint state message. The finger joints are
+ * read from the left_gripper_joint_names and right_gripper_joint_names parameters of the robot. Without the
+ * parameters, they are the movable joints below the palm frames in the URDF.
+ *
+ * The closure of a gripper is the mean absolute position of its finger joints, which are assumed to be at zero when
+ * the gripper is open. The load is the mean absolute effort of the finger joints. A gripper is grasping when its
+ * fingers are still and loaded, and slipping when the fingers of a grasp close further than the slip distance. A new
+ * state is reported after it was classified for a few consecutive joint states, so effort noise does not trigger
+ * events.
+ */
+class GripperMonitor
+{
+public:
+  struct Thresholds
+  {
+    double closed_position = 0.8;     // rad, closure above which still fingers are closed
+    double grasp_effort = 0.5;        // Nm, load above which still fingers are grasping
+    double settled_velocity = 0.05;   // rad/s, fingers are still below this joint speed
+    double slip_position = 0.1;       // rad, closure past the grasp that is reported as slipping
+    int confirm_samples = 3;          // joint states with the same classification before the state changes
+  };
+
+  /**
+   * @brief Get the GripperMonitor object. It is shared by all the gripper interfaces of a node.
+   *
+   * @param nh                  nodehandle used to read the parameters and create the RobotStateInformer
+   * @return GripperMonitor*
+   */
+  static GripperMonitor* getGripperMonitor(ros::NodeHandle nh);
+  ~GripperMonitor();
+
+  // disable assign and copy
+  GripperMonitor(GripperMonitor const&) = delete;
+  void operator=(GripperMonitor const&) = delete;
+
+  /**
+   * @brief Get the current state of a gripper
+   *
+   * @param side                Side of the robot. It can be RIGHT or LEFT.
+   * @return GripperState
+   */
+  GripperState getState(const RobotSide side) const;
+
+  /**
+   * @brief Get the name of a state, e.g. "GRASPED"
+   *
+   * @param state
+   * @return std::string
+   */
+  static std::string getStateName(const GripperState state);
+
+  /**
+   * @brief Get the names of the finger joints of a gripper
+   *
+   * @param side                Side of the robot. It can be RIGHT or LEFT.
+   * @return const std::vector<std::string>&  empty when the gripper is not monitored
+   */
+  const std::vector<std::string>& getFingerJointNames(const RobotSide side) const;
+
+  /**
+   * @brief Get the finger positions of the last joint state, in the order of getFingerJointNames
+   *
+   * @param side                Side of the robot. It can be RIGHT or LEFT.
+   * @param positions           [output]
+   * @return true               when the finger joints are available
+   * @return false
+   */
+  bool getFingerPositions(const RobotSide side, std::vector<double>& positions) const;
+
+  /**
+   * @brief Get the finger efforts of the last joint state, in the order of getFingerJointNames
+   *
+   * @param side                Side of the robot. It can be RIGHT or LEFT.
+   * @param efforts             [output]
+   * @return true               when the finger joints are available
+   * @return false
+   */
+  bool getFingerEfforts(const RobotSide side, std::vector<double>& efforts) const;
+
+  /**
+   * @brief Call a function every time the state of a gripper changes. It is called from the joint state callback and
+   * must return quickly.
+   *
+   * @param callback            function called with the side, the previous state and the new state
+   * @return int                handle used to remove the callback
+   */
+  int addCallback(const GripperStateCallback& callback);
+
+  /**
+   * @brief Remove a callback added with addCallback
+   *
+   * @param handle              handle returned by addCallback
+   */
+  void removeCallback(const int handle);
+
+  /**
+   * @brief Block until a gripper is in a state. Callbacks are processed from this call when there is no spinner
+   * thread, see RobotStateInformer::waitForCondition.
+   *
+   * @param side                Side of the robot. It can be RIGHT or LEFT.
+   * @param state               state to wait for
+   * @param timeout             maximum time to wait
+   * @return true               when the gripper is in the state
+   * @return false              when the timeout expired
+   */
+  bool waitForState(const RobotSide side, const GripperState state, const ros::Duration& timeout);
+
+  /**
+   * @brief Block until a closing gripper has grasped an object or closed empty
+   *
+   * @param side                Side of the robot. It can be RIGHT or LEFT.
+   * @param timeout             maximum time to wait
+   * @return true               when the object is grasped
+   * @return false              when the gripper closed empty or the timeout expired
+   */
+  bool waitForGrasp(const RobotSide side, const ros::Duration& timeout);
+
+  /**
+   * @brief Set the thresholds used to classify the state of the grippers
+   *
+   * @param thresholds
+   */
+  void setThresholds(const Thresholds& thresholds);
+
+  /**
+   * @brief Get the thresholds used to classify the state of the grippers
+   *
+   * @return Thresholds
+   */
+  Thresholds getThresholds() const;
+
+  /**
+   * @brief Classify the state of a gripper from one joint state. The state only changes after it was classified for
+   * confirm_samples consecutive joint states.
+   *
+   * @param state               current state of the gripper
+   * @param grasp_closure       closure when the current grasp was detected
+   * @param thresholds          thresholds of the classification
+   * @param closure             mean absolute position of the finger joints
+   * @param load                mean absolute effort of the finger joints
+   * @param speed               maximum absolute velocity of the finger joints
+   * @return GripperState
+   */
+  static GripperState classify(const GripperState state, const double grasp_closure, const Thresholds& thresholds,
+                               const double closure, const double load, const double speed);
+
+private:
+  explicit GripperMonitor(ros::NodeHandle nh);
+  static GripperMonitor* currentObject_;
+
+  struct Gripper
+  {
+    JointGroupHandle joints;
+    std::vector<double> positions;
+    std::vector<double> velocities;
+    std::vector<double> efforts;
+    GripperState state = GripperState::UNKNOWN;
+    GripperState candidate = GripperState::UNKNOWN;
+    int candidate_samples = 0;
+    double grasp_closure = 0.0;  // closure when the grasp was detected
+  };
+
+  RobotStateInformer* state_informer_;
+  Gripper grippers_[2];  // indexed by RobotSide
+  Thresholds thresholds_;
+  mutable std::mutex mutex_;
+  int joint_state_callback_;
+  CallbackList<const RobotSide, const GripperState, const GripperState> callbacks_;
+
+  void jointStateCB(const sensor_msgs::JointState& msg);
+  bool update(Gripper& gripper, GripperState& previous);
+};
+
+#endif  // GRIPPER_MONITOR_H
@@ -0,0 +1,142 @@
+#ifndef HAND_JOGGER_H
+#define HAND_JOGGER_H
+
+#include <ros/ros.h>
+#include <geometry_msgs/Pose.h>
+#include <geometry_msgs/Twist.h>
+#include <Eigen/Geometry>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief HandJogger moves a hand continuously with velocity commands, e.g. while an operator holds a key. A loop at a
+ * fixed rate integrates the commanded velocity into a setpoint and publishes it as a short trajectory that ends at
+ * the setpoint expected after the horizon, so consecutive messages blend into a smooth motion.
+ *
+ * The commanded velocity is limited in speed and acceleration. The setpoint never leads the measured hand pose by
+ * more than the lead limits, so it stops at the edge of the workspace instead of running away from the hand. The hand
+ * stops when no velocity is commanded for the command timeout. The setpoint starts again from the measured hand every
+ * time the hand starts moving, as other commands may have moved the arm while it was still.
+ */
+class HandJogger
+{
+public:
+  /**
+   * @brief Reads the measured pose of the hand
+   *
+   * @param pose                [output] pose of the hand in the frame of the setpoints
+   * @return true               when the pose is available
+   */
+  typedef std::function<bool(geometry_msgs::Pose& pose)> PoseReader;
+
+  /**
+   * @brief Publishes one setpoint of the hand
+   *
+   * @param pose                pose to reach at the end of the horizon
+   * @param velocity            velocity of the hand at the end of the horizon
+   * @param time                horizon in seconds
+   */
+  typedef std::function<void(const geometry_msgs::Pose& pose, const geometry_msgs::Twist& velocity, const double time)>
+      SetpointPublisher;
+
+  struct Limits
+  {
+    double max_linear_speed = 0.15;          // m/s
+    double max_angular_speed = 0.5;          // rad/s
+    double max_linear_acceleration = 0.5;    // m/s^2
+    double max_angular_acceleration = 2.0;   // rad/s^2
+    double max_linear_lead = 0.05;           // m between the setpoint and the measured hand
+    double max_angular_lead = 0.2;           // rad between the setpoint and the measured hand
+    double command_timeout = 1.0;            // s without velocity command before the hand stops
+  };
+
+  /**
+   * @brief Construct a new HandJogger
+   *
+   * @param reader              reads the measured pose of the hand
+   * @param publisher           publishes the setpoints
+   * @param rate                rate of the loop in Hz
+   * @param horizon             time in seconds to reach each setpoint, longer than the period of the loop
+   */
+  HandJogger(PoseReader reader, SetpointPublisher publisher, const double rate = 50.0, const double horizon = 0.1);
+  ~HandJogger();
+
+  // disable assign and copy
+  HandJogger(HandJogger const&) = delete;
+  void operator=(HandJogger const&) = delete;
+
+  /**
+   * @brief Start jogging from the measured pose of the hand. Does nothing when already jogging.
+   *
+   * @return true               when jogging
+   * @return false              when the pose of the hand is not available
+   */
+  bool start();
+
+  /**
+   * @brief Stop the loop. A moving hand is sent to the current setpoint with zero velocity.
+   */
+  void stop();
+
+  /**
+   * @brief Check if the loop is running
+   *
+   * @return true
+   * @return false
+   */
+  bool isJogging() const;
+
+  /**
+   * @brief Set the velocity of the hand. It is clamped to the speed limits and reached with the acceleration limits.
+   *
+   * @param velocity            linear velocity in m/s and angular velocity in rad/s, in the frame of the setpoints
+   */
+  void setVelocity(const geometry_msgs::Twist& velocity);
+
+  /**
+   * @brief Set the limits of the motion
+   *
+   * @param limits
+   */
+  void setLimits(const Limits& limits);
+
+  /**
+   * @brief Get the limits of the motion
+   *
+   * @return Limits
+   */
+  Limits getLimits() const;
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  PoseReader reader_;
+  SetpointPublisher publisher_;
+  const std::chrono::nanoseconds period_;
+  const double horizon_;
+
+  Limits limits_;
+  Eigen::Vector3d commanded_linear_;
+  Eigen::Vector3d commanded_angular_;
+  Clock::time_point command_time_;
+  bool running_;
+  mutable std::mutex mutex_;
+  std::condition_variable stop_condition_;
+  std::thread thread_;
+
+  // state of the loop, only used by its thread
+  Eigen::Vector3d setpoint_position_;
+  Eigen::Quaterniond setpoint_orientation_;
+  Eigen::Vector3d linear_;
+  Eigen::Vector3d angular_;
+
+  void jog();
+  void step(const double dt);
+  bool readSetpoint();
+  void publishSetpoint(const Eigen::Vector3d& position, const Eigen::Quaterniond& orientation);
+};
+
+#endif  // HAND_JOGGER_H
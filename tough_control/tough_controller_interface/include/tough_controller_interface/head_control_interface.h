@@ -12,6 +12,11 @@
 #include <geometry_msgs/Quaternion.h>
 #include <geometry_msgs/QuaternionStamped.h>
 #include <geometry_msgs/Vector3.h>
+#include <geometry_msgs/PointStamped.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
 #include <tough_common/robot_state.h>
 #include "tough_common/robot_description.h"
 #include "tough_controller_interface/tough_control_interface.h"
@@ -24,11 +29,31 @@ class HeadControlInterface : public ToughControlInterface
 {
 private:
   int NUM_NECK_JOINTS;
+  RobotType robot_type_;
 
   ros::Publisher headTrajPublisher;
   ros::Publisher neckTrajPublisher;
   void appendNeckTrajectoryPoint(ihmc_msgs::NeckTrajectoryRosMessage& msg, float time, std::vector<float> pos);
 
+  // range of the head yaw and pitch relative to the chest allowed by the neck joints in the URDF, as lower and upper
+  // limits. Unbounded when the neck is not found in the URDF.
+  std::pair<double, double> neck_yaw_limits_;
+  std::pair<double, double> neck_pitch_limits_;
+  void loadNeckLimits();
+
+  // look at target, a point or the origin of a frame that is followed
+  geometry_msgs::PointStamped look_at_target_;
+  double look_at_rate_;
+  double look_at_deadband_;
+  double look_at_time_;
+  bool look_at_running_;
+  mutable std::mutex look_at_mutex_;
+  std::condition_variable look_at_condition_;
+  std::thread look_at_thread_;
+
+  void trackLookAtTarget();
+  void publishHeadOrientation(const geometry_msgs::Quaternion& orientation, const float time, const int frame_hash);
+
   // protected:
   //    ros::NodeHandle nh_;
   //    static int id_;
@@ -68,6 +93,57 @@ public:
    */
   void moveHead(const std::vector<std::vector<float> >& trajectory_points, const float time = 4.0f);
 
+  /**
+   * @brief getLookAtOrientation Computes the orientation of the head that points it at a point, without roll
+   * relative to the chest. Yaw and pitch are limited to the range of the neck joints, a warning is printed when the
+   * point is out of that range.
+   * @param target            The point to look at, in any frame known to TF
+   * @param orientation       [output] Orientation of the head in world frame
+   * @return true             When the point, the head and the chest could be located
+   */
+  bool getLookAtOrientation(const geometry_msgs::PointStamped& target, geometry_msgs::Quaternion& orientation);
+
+  /**
+   * @brief lookAt Moves the head once to look at a point
+   * @param target            The point to look at, in any frame known to TF
+   * @param time              The time it takes to move to the orientation. Default is 1.0
+   * @return true             When the message is published
+   */
+  bool lookAt(const geometry_msgs::PointStamped& target, const float time = 1.0f);
+
+  /**
+   * @brief startLookAt Keeps the head pointed at a point. The point is located again at every update, so a point
+   * given in a moving frame, e.g. a hand or a marker, is followed. Orientations that differ from the last one sent by
+   * less than the deadband are not sent. A tracking that is running is replaced.
+   * @param target            The point to look at, in any frame known to TF
+   * @param rate              Rate of the updates in Hz
+   * @param deadband          Minimum change of the orientation in radians to send an update
+   * @param time              Time of each head trajectory in seconds
+   */
+  void startLookAt(const geometry_msgs::PointStamped& target, const double rate = 10.0, const double deadband = 0.02,
+                   const double time = 0.5);
+
+  /**
+   * @brief startLookAt Keeps the head pointed at the origin of a frame, see startLookAt for a point
+   * @param frame             The frame to look at, e.g. a hand or a marker frame
+   * @param rate              Rate of the updates in Hz
+   * @param deadband          Minimum change of the orientation in radians to send an update
+   * @param time              Time of each head trajectory in seconds
+   */
+  void startLookAt(const std::string& frame, const double rate = 10.0, const double deadband = 0.02,
+                   const double time = 0.5);
+
+  /**
+   * @brief stopLookAt Stops the updates. The head stays at the last orientation sent.
+   */
+  void stopLookAt();
+
+  /**
+   * @brief isLookingAt Checks if the head is tracking a target
+   * @return true             While the updates are sent
+   */
+  bool isLookingAt() const;
+
   /**
    * @brief getNumNeckJoints Gives back the number of neck joints for Valkyrie R5
    * @return The number of neck joints.
@@ -19,6 +19,7 @@ class PelvisControlInterface : public ToughControlInterface
 private:
   ros::Publisher pelvisHeightPublisher_;
   ros::Publisher homePositionPublisher_;
+  std::vector<std::string> leg_joint_names_;
 
 public:
   /**
@@ -43,7 +44,7 @@ public:
    *
    * @param msg                   Executes the IHMC message to control the pelvis.
    */
-  void publishPelvisMessage(const ihmc_msgs::PelvisHeightTrajectoryRosMessage& msg) const;
+  void publishPelvisMessage(const ihmc_msgs::PelvisHeightTrajectoryRosMessage& msg);
 
   /**
    * @brief Resets the Pelvis pose and height
@@ -2,21 +2,54 @@
 #define TOUGHCONTROLINTERFACE_H
 
 #include <ros/ros.h>
+#include <atomic>
 #include <tf/transform_listener.h>
 #include <ihmc_msgs/WholeBodyTrajectoryRosMessage.h>
 #include "tough_common/robot_state.h"
 #include "tough_common/robot_description.h"
+#include "tough_controller_interface/command_monitor.h"
+#include "tough_common/command_tracer.h"
+#include "tough_controller_interface/trajectory_decimation.h"
 
 class ToughControlInterface
 {
 protected:
   ros::NodeHandle nh_;
-  static long id_;
+  // shared by all the interfaces, messages can be built from several threads
+  static std::atomic<long> id_;
   RobotStateInformer* state_informer_;
   RobotDescription* rd_;
   std::string control_topic_prefix_;
   std::string output_topic_prefix_;
   std::string robot_name_;
+  double trajectory_decimation_tolerance_;
+  CommandMonitor* command_monitor_;
+  CommandTracer* command_tracer_;
+  // commands can be sent from several threads
+  std::atomic<long> last_command_id_;
+
+  /**
+   * @brief Start tracking a command that was just published, see CommandMonitor::track
+   *
+   * @param unique_id         unique id of the published message
+   * @param joint_names       joints moved by the command. All the joints of the robot when it is empty.
+   * @param targets           final positions of the joints. Only the velocities are checked when it is empty.
+   * @param duration          trajectory time of the command in seconds
+   * @param overrides         true when the command was sent in OVERRIDE mode
+   * @return CommandFuture
+   */
+  CommandFuture trackCommand(const long unique_id, const std::vector<std::string>& joint_names,
+                             const std::vector<double>& targets, const double duration, const bool overrides = true);
+
+  /**
+   * @brief Decimate a trajectory with the tolerance set by setTrajectoryDecimationTolerance
+   *
+   * @param traj              trajectory to send to the controller
+   * @param decimated         [output] storage of the decimated trajectory, not used when decimation is disabled
+   * @return const trajectory_msgs::JointTrajectory&  decimated, or traj when decimation is disabled
+   */
+  const trajectory_msgs::JointTrajectory& decimate(const trajectory_msgs::JointTrajectory& traj,
+                                                   trajectory_msgs::JointTrajectory& decimated) const;
 
 public:
   ToughControlInterface(ros::NodeHandle nh);
@@ -24,6 +57,72 @@ public:
 
   virtual bool getJointSpaceState(std::vector<double>& joints, RobotSide side) = 0;
   virtual bool getTaskSpaceState(geometry_msgs::Pose& pose, RobotSide side, std::string fixedFrame) = 0;
+
+  /**
+   * @brief Set the tolerance used to remove waypoints of joint trajectories before they are sent to the controller.
+   * Waypoints that are within tolerance of the path through the remaining waypoints are removed, see
+   * decimateTrajectory. Decimation is disabled by default.
+   *
+   * @param tolerance         maximum deviation of any joint in radians. 0 disables decimation.
+   */
+  void setTrajectoryDecimationTolerance(const double tolerance);
+
+  /**
+   * @brief Get the tolerance used to remove waypoints of joint trajectories
+   *
+   * @return double           0 when decimation is disabled
+   */
+  double getTrajectoryDecimationTolerance() const;
+
+  /**
+   * @brief Get the unique id of the last command sent by this interface
+   *
+   * @return long             0 when no command was sent
+   */
+  long getLastCommandId() const;
+
+  /**
+   * @brief Get a future that is completed when a command is completed, i.e. its trajectory time has elapsed and the
+   * joints it moves have converged. Joint state callbacks must be processed by a spinner for the future to complete,
+   * use waitForCommand in single threaded nodes.
+   *
+   * @param unique_id         unique id of the command, see getLastCommandId
+   * @param future            [output]
+   * @return true             when the command is tracked
+   * @return false
+   */
+  bool getCommandFuture(const long unique_id, CommandFuture& future) const;
+
+  /**
+   * @brief Call a function when a command is completed. It is called from a background thread, or immediately when
+   * the command is already completed.
+   *
+   * @param unique_id         unique id of the command, see getLastCommandId
+   * @param callback          function called with the unique id and the status of the command
+   * @return true             when the command is tracked
+   * @return false
+   */
+  bool addCommandCallback(const long unique_id, const CommandCallback& callback);
+
+  /**
+   * @brief Block until a command is completed. Callbacks are processed from this call when there is no spinner
+   * thread.
+   *
+   * @param unique_id         unique id of the command, see getLastCommandId
+   * @param timeout           maximum time to wait
+   * @return true             when the command succeeded
+   * @return false            when it timed out, was cancelled or is not tracked
+   */
+  bool waitForCommand(const long unique_id, const ros::Duration& timeout = ros::DURATION_MAX);
+
+  /**
+   * @brief Block until the last command sent by this interface is completed
+   *
+   * @param timeout           maximum time to wait
+   * @return true             when the command succeeded
+   * @return false
+   */
+  bool waitForLastCommand(const ros::Duration& timeout = ros::DURATION_MAX);
 };
 
 #endif  // TOUGHCONTROLINTERFACE_H
@@ -0,0 +1,26 @@
+#ifndef TRAJECTORY_DECIMATION_H
+#define TRAJECTORY_DECIMATION_H
+
+#include <trajectory_msgs/JointTrajectory.h>
+
+/**
+ * @brief Remove the waypoints of a joint trajectory that are within a tolerance of the path through the remaining
+ * waypoints, using Ramer-Douglas-Peucker in joint space.
+ *
+ * The path through the kept waypoints is interpolated the way the controller does, with a cubic Hermite segment
+ * between two kept waypoints using their positions and velocities (zero when a waypoint has no velocities). Every
+ * removed waypoint is within tolerance of that path for every joint, so the deviation from the original path is
+ * bounded at the original waypoints; between them it is only bounded as far as the original path is smooth. A
+ * trajectory that is not time parameterized has no segment durations, its path is interpolated linearly in waypoint
+ * index instead. The first and the last waypoint are always kept, and the kept waypoints are copied unchanged,
+ * including their velocities and accelerations.
+ *
+ * @param traj              trajectory to decimate
+ * @param tolerance         maximum deviation of any joint in radians (meters for prismatic joints)
+ * @param result            [output] decimated trajectory. It must not be the same object as traj.
+ * @return size_t           number of removed waypoints
+ */
+size_t decimateTrajectory(const trajectory_msgs::JointTrajectory& traj, const double tolerance,
+                          trajectory_msgs::JointTrajectory& result);
+
+#endif  // TRAJECTORY_DECIMATION_H
@@ -0,0 +1,93 @@
+#ifndef TRAJECTORY_STREAMER_H
+#define TRAJECTORY_STREAMER_H
+
+#include <ros/ros.h>
+#include <trajectory_msgs/JointTrajectory.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief TrajectoryStreamer sends a long joint trajectory to the controller in chunks. The first chunk is published
+ * immediately with OVERRIDE execution mode, so the robot starts moving before the rest of the trajectory is
+ * converted. Every following chunk is published with QUEUE execution mode, chained to the previous chunk with its
+ * unique id, shortly before the previous chunk is expected to finish. The stream can be cancelled at any time, chunks
+ * that were not published yet are dropped.
+ *
+ * Times of the queued chunks are relative to the end of the previous chunk, as expected by the IHMC controller.
+ */
+class TrajectoryStreamer
+{
+public:
+  /**
+   * @brief Converts and publishes one chunk of the trajectory
+   *
+   * @param chunk               points of the chunk, times are relative to the start of the chunk
+   * @param execution_mode      OVERRIDE for the first chunk, QUEUE for the others
+   * @param previous_message_id unique id returned for the previous chunk, 0 for the first chunk
+   * @return long               unique id of the published message, 0 if it was not published
+   */
+  typedef std::function<long(const trajectory_msgs::JointTrajectory& chunk, const int execution_mode,
+                             const long previous_message_id)>
+      ChunkPublisher;
+
+  // execution modes, same values in all the IHMC trajectory messages
+  static const int OVERRIDE = 0;
+  static const int QUEUE = 1;
+
+  explicit TrajectoryStreamer(ChunkPublisher publisher);
+  ~TrajectoryStreamer();
+
+  // disable assign and copy
+  TrajectoryStreamer(TrajectoryStreamer const&) = delete;
+  void operator=(TrajectoryStreamer const&) = delete;
+
+  /**
+   * @brief Start streaming a trajectory. The first chunk is published before this returns. A stream that is still
+   * running is cancelled first.
+   *
+   * @param traj                trajectory to stream, times are from the start of the trajectory
+   * @param chunk_size          number of points in each chunk
+   * @param lookahead           time in seconds before the end of a chunk at which the next chunk is published
+   * @return true               when the first chunk was published
+   * @return false
+   */
+  bool start(const trajectory_msgs::JointTrajectory& traj, const size_t chunk_size, const double lookahead = 1.0);
+
+  /**
+   * @brief Stop publishing the remaining chunks. Chunks that were already published are executed by the controller,
+   * stop the trajectories on the controller to stop the robot immediately. Must not be called from the chunk
+   * publisher.
+   */
+  void cancel();
+
+  /**
+   * @brief Check if there are chunks left to publish
+   *
+   * @return true               while the stream is running
+   * @return false
+   */
+  bool isStreaming() const;
+
+private:
+  ChunkPublisher publisher_;
+  trajectory_msgs::JointTrajectory trajectory_;
+  std::vector<size_t> chunk_starts_;
+  double lookahead_;
+  bool cancelled_;
+  bool streaming_;
+  mutable std::mutex mutex_;
+  std::condition_variable cancel_condition_;
+  std::thread thread_;
+  // start and cancel can be called from different threads, e.g. a sensor callback that stops the robot
+  std::mutex control_mutex_;
+
+  void stop();
+
+  void getChunk(const size_t chunk, trajectory_msgs::JointTrajectory& result) const;
+  void streamChunks(const ros::Time start_time, long previous_message_id);
+};
+
+#endif  // TRAJECTORY_STREAMER_H
@@ -7,12 +7,15 @@
 
 #include <ihmc_msgs/WholeBodyTrajectoryRosMessage.h>
 #include <ihmc_msgs/SO3TrajectoryPointRosMessage.h>
+#include <memory>
+#include <mutex>
 
 #include "tough_common/robot_description.h"
 #include "tough_common/robot_state.h"
 #include "tough_controller_interface/arm_control_interface.h"
 #include "tough_controller_interface/chest_control_interface.h"
 #include "tough_controller_interface/tough_control_interface.h"
+#include "tough_controller_interface/trajectory_streamer.h"
 
 /**
  * @brief  The WholebodyControlInterface class provides ability to control whole body of humanoid robots supported by
@@ -22,6 +25,34 @@
 class WholebodyControlInterface : public ToughControlInterface
 {
 public:
+  /**
+   * @brief Targets of the parts of the robot moved together by moveCoordinated. Parts that are not set are not moved.
+   * An arm is moved in joint space when its joint positions are set, otherwise its hand is moved in task space when
+   * the hand pose is set.
+   */
+  struct CoordinatedMotion
+  {
+    std::vector<double> left_arm_joints;   // positions in the order of the left arm joints
+    std::vector<double> right_arm_joints;  // positions in the order of the right arm joints
+
+    bool move_left_hand = false;
+    bool move_right_hand = false;
+    geometry_msgs::Pose left_hand_pose;   // pose of the palm in hand_frame_hash
+    geometry_msgs::Pose right_hand_pose;  // pose of the palm in hand_frame_hash
+    int hand_frame_hash = TOUGH_COMMON_NAMES::PELVIS_ZUP_FRAME_HASH;
+
+    bool move_chest = false;
+    geometry_msgs::Quaternion chest_orientation;  // orientation in the pelvis zup frame
+
+    bool move_pelvis = false;
+    geometry_msgs::Pose pelvis_pose;  // pose in the world frame
+
+    bool move_left_foot = false;
+    bool move_right_foot = false;
+    geometry_msgs::Pose left_foot_pose;   // pose in the world frame
+    geometry_msgs::Pose right_foot_pose;  // pose in the world frame
+  };
+
   /**
    * @brief The WholebodyControlInterface class provides ability to control whole body of humanoid robots supported by
    * open-humanoids-software
@@ -29,9 +60,11 @@ public:
    * @param nh    nodehandle to which subscribers and publishers are attached.
    */
   explicit WholebodyControlInterface(ros::NodeHandle& nh);
+  ~WholebodyControlInterface();
 
   /**
-   * @brief This method executes the trajectory on the Robot
+   * @brief This method executes the trajectory on the Robot. A running stream is cancelled, as the trajectory
+   * overrides it.
    *
    * @param traj                      JointTrajectory message to be executed on the robot.
    */
@@ -44,6 +77,58 @@ public:
    */
   void executeTrajectory(const moveit_msgs::RobotTrajectory& traj);
 
+  /**
+   * @brief Moves several parts of the robot with a single wholebody message. All the parts start in the same
+   * controller tick and reach their targets at the same time.
+   *
+   * @param motion                    Targets of the parts to move
+   * @param time                      Time in seconds to reach the targets
+   * @return true                     When the message is published
+   * @return false                    When no part is moved or an arm has the wrong number of joints
+   */
+  bool moveCoordinated(const CoordinatedMotion& motion, const float time);
+
+  /**
+   * @brief Generates the wholebody message of a coordinated motion. This does not publish anything.
+   *
+   * @param motion                    Targets of the parts to move
+   * @param time                      Time in seconds to reach the targets
+   * @param wholeBodyMsg              [output]
+   * @return true                     When at least one part is moved
+   * @return false
+   */
+  bool generateCoordinatedMessage(const CoordinatedMotion& motion, const float time,
+                                  ihmc_msgs::WholeBodyTrajectoryRosMessage& wholeBodyMsg);
+
+  /**
+   * @brief This method executes the trajectory on the Robot in chunks. The first chunk is sent immediately and the
+   * following chunks are queued on the controller while the robot moves. A stream that is still running is cancelled.
+   * Every chunk is tracked by the CommandMonitor, wait for getLastCommandId after the stream ended to wait for the
+   * whole trajectory.
+   *
+   * @param traj                      JointTrajectory message to be executed on the robot.
+   * @param chunk_size                Number of trajectory points in each message
+   * @param lookahead                 Time in seconds before the end of a chunk at which the next chunk is queued
+   * @return true                     When the first chunk is published
+   * @return false
+   */
+  bool streamTrajectory(const trajectory_msgs::JointTrajectory& traj, const size_t chunk_size = 20,
+                        const double lookahead = 1.0);
+
+  /**
+   * @brief Stops sending the remaining chunks of a stream. Chunks that were already sent are executed, use
+   * stopAllTrajectories to stop the robot immediately.
+   */
+  void cancelTrajectoryStream();
+
+  /**
+   * @brief Checks if a stream still has chunks to send
+   *
+   * @return true                     While chunks are left to send
+   * @return false
+   */
+  bool isTrajectoryStreaming() const;
+
   /**
    * @brief Get the current positions of all joints of the side of the chest.
    * Ordering is based on the order in the JointNames vector. The order for the Joints' Names, Numbers,
@@ -80,23 +165,56 @@ private:
   std::vector<std::string> left_arm_joint_names_;
   std::vector<std::string> right_arm_joint_names_;
   std::vector<std::string> chest_joint_names_;
+  std::vector<std::string> left_leg_joint_names_;
+  std::vector<std::string> right_leg_joint_names_;
 
   std::vector<std::pair<double, double>> left_arm_joint_limits_;
   std::vector<std::pair<double, double>> right_arm_joint_limits_;
 
+  std::unique_ptr<TrajectoryStreamer> streamer_;
+  // ids of the parts of the last chunk sent by the stream, used to chain the next chunk
+  long stream_chest_id_ = 0;
+  long stream_left_arm_id_ = 0;
+  long stream_right_arm_id_ = 0;
+  // expected end of the last chunk sent by the stream
+  ros::Time stream_end_;
+  // the stream publishes from its own thread, messages of the stream and of the other methods are not interleaved
+  std::mutex publish_mutex_;
+
+  long publishTrajectoryChunk(const trajectory_msgs::JointTrajectory& chunk, const int execution_mode,
+                              const long previous_message_id);
+
+  /**
+   * @brief Columns of the trajectory joints that are sent to each part of the wholebody message, in the order of the
+   * joints of the part. A part is empty when the trajectory does not contain its joints.
+   */
+  struct JointLayoutPlan
+  {
+    std::vector<std::string> joint_names;
+    bool valid;
+    std::vector<size_t> chest;
+    std::vector<size_t> left_arm;
+    std::vector<size_t> right_arm;
+  };
+  typedef std::shared_ptr<const JointLayoutPlan> JointLayoutPlanConstPtr;
+  // plan of the last joint names parsed, trajectories of a planner usually share the same joints
+  JointLayoutPlanConstPtr layout_plan_;
+
   void initializeWholebodyMessage(ihmc_msgs::WholeBodyTrajectoryRosMessage& wholeBodyMsg);
   void parseTrajectory(const trajectory_msgs::JointTrajectory& traj,
                        ihmc_msgs::WholeBodyTrajectoryRosMessage& wholeBodyMsg);
-  bool validateJointSequenceInTrajectory(const std::vector<std::string>& traj_joint_names,
-                                         const std::vector<std::string>& joint_names, long start);
+  JointLayoutPlanConstPtr getJointLayoutPlan(const std::vector<std::string>& joint_names);
+  bool planJointColumns(const std::vector<std::string>& traj_joint_names,
+                        const std::vector<std::string>& joint_names, std::vector<size_t>& columns) const;
 
-  inline void createChestQuaternion(const long start, const trajectory_msgs::JointTrajectoryPoint& traj_point,
+  inline void createChestQuaternion(const std::vector<size_t>& columns,
+                                    const trajectory_msgs::JointTrajectoryPoint& traj_point,
                                     geometry_msgs::Quaternion& quat_msg)
   {
     // chest can only have 3 joints
-    double back_bkz = traj_point.positions[start];
-    double back_bky = traj_point.positions[start + 1];
-    double back_bkx = traj_point.positions[start + 2];
+    double back_bkz = traj_point.positions[columns[0]];
+    double back_bky = traj_point.positions[columns[1]];
+    double back_bkx = traj_point.positions[columns[2]];
     tf::Quaternion quat;
     quat.setRPY(back_bkx, back_bky, back_bkz);
     tf::quaternionTFToMsg(quat, quat_msg);
@@ -1,36 +1,106 @@
 #include <tough_controller_interface/arm_control_interface.h>
+#include <algorithm>
 #include <stdlib.h>
 #include <visualization_msgs/Marker.h>
 #include <tf/tf.h>
+#include <functional>
+
+namespace
+{
+/**
+ * @brief Appends a trajectory point clamped to the joint limits to every joint of an arm message. For robots known at
+ * compile time the positions are clamped in fixed size vectors and the loop is unrolled.
+ */
+struct AppendArmTrajectoryPoint
+{
+  ihmc_msgs::ArmTrajectoryRosMessage& armMsg;
+  const float time;
+  const std::vector<double>& pos;
+  const JointChainLimits& limits;
+  std::atomic<long>& unique_id;
+
+  template <typename Traits>
+  void operator()(Traits) const
+  {
+    typedef typename Traits::ArmVector ArmVector;
+    const int size = pos.size();
+    const ArmVector position = Eigen::Map<const ArmVector>(pos.data(), size)
+                                   .cwiseMax(Eigen::Map<const ArmVector>(limits.lower.data(), size))
+                                   .cwiseMin(Eigen::Map<const ArmVector>(limits.upper.data(), size));
+    // reserve the ids of all the points at once, other threads may be building messages
+    const long id = unique_id.fetch_add(size);
+
+    for (int i = 0; i < size; i++)
+    {
+      ihmc_msgs::TrajectoryPoint1DRosMessage p;
+      p.time = time;
+      p.position = position[i];
+      p.velocity = 0;
+      p.unique_id = id + i;
+
+      armMsg.joint_trajectory_messages[i].trajectory_points.push_back(p);
+      armMsg.joint_trajectory_messages[i].unique_id = id;
+      // weight should be set to NAN so the optimizer can use its predefined weights.
+      armMsg.joint_trajectory_messages[i].weight = std::nan("");
+    }
+  }
+};
+}  // namespace
 
 // add default pose for both arms. the values of joints are different.
 ArmControlInterface::ArmControlInterface(ros::NodeHandle nh)
   : ToughControlInterface(nh), ZERO_POSE{ 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f }
 {
   id_++;
+  // messages for both the arms are published back to back, a queue of 1 would drop the first one
   armTrajectoryPublisher = nh_.advertise<ihmc_msgs::ArmTrajectoryRosMessage>(
-      control_topic_prefix_ + TOUGH_COMMON_NAMES::ARM_TRAJECTORY_TOPIC, 1, true);
+      control_topic_prefix_ + TOUGH_COMMON_NAMES::ARM_TRAJECTORY_TOPIC, 10, true);
   taskSpaceTrajectoryPublisher = nh_.advertise<ihmc_msgs::HandTrajectoryRosMessage>(
-      control_topic_prefix_ + TOUGH_COMMON_NAMES::HAND_TRAJECTORY_TOPIC, 1, true);
+      control_topic_prefix_ + TOUGH_COMMON_NAMES::HAND_TRAJECTORY_TOPIC, 10, true);
   homePositionPublisher =
-      nh_.advertise<ihmc_msgs::GoHomeRosMessage>(control_topic_prefix_ + TOUGH_COMMON_NAMES::GO_HOME_TOPIC, 1, true);
+      nh_.advertise<ihmc_msgs::GoHomeRosMessage>(control_topic_prefix_ + TOUGH_COMMON_NAMES::GO_HOME_TOPIC, 10, true);
+  stopAllTrajectoriesPublisher = nh_.advertise<ihmc_msgs::StopAllTrajectoryRosMessage>(
+      control_topic_prefix_ + TOUGH_COMMON_NAMES::STOP_ALL_TRAJECTORY_TOPIC, 1, true);
   markerPub_ = nh_.advertise<visualization_msgs::Marker>(TOUGH_COMMON_NAMES::MARKER_TOPIC, 1, true);
 
-  rd_->getLeftArmJointLimits(joint_limits_left_);
-  rd_->getRightArmJointLimits(joint_limits_right_);
+  joint_limits_left_ = rd_->getJointChainLimits(JointChain::LEFT_ARM);
+  joint_limits_right_ = rd_->getJointChainLimits(JointChain::RIGHT_ARM);
 
   // reduce the joint limits by 1cm to avoid excceeding limits at higher precision of float
-  for (size_t i = 0; i < joint_limits_left_.size(); i++)
+  joint_limits_left_.lower.array() += 0.01;
+  joint_limits_left_.upper.array() -= 0.01;
+  joint_limits_right_.lower.array() += 0.01;
+  joint_limits_right_.upper.array() -= 0.01;
+
+  NUM_ARM_JOINTS = joint_limits_left_.lower.size();
+
+  // compile time joint counts are only used when they match the robot description
+  robot_type_ = rd_->getRobotType();
+  if (getRobotConstants(robot_type_).num_arm_joints != NUM_ARM_JOINTS)
   {
-    joint_limits_left_[i] = { joint_limits_left_[i].first + 0.01, joint_limits_left_[i].second - 0.01 };
-    joint_limits_right_[i] = { joint_limits_right_[i].first + 0.01, joint_limits_right_[i].second - 0.01 };
+    robot_type_ = RobotType::UNKNOWN;
   }
 
-  NUM_ARM_JOINTS = joint_limits_left_.size();
+  using namespace std::placeholders;
+  left_arm_streamer_.reset(new TrajectoryStreamer(
+      std::bind(&ArmControlInterface::publishArmTrajectoryChunk, this, LEFT, _1, _2, _3)));
+  right_arm_streamer_.reset(new TrajectoryStreamer(
+      std::bind(&ArmControlInterface::publishArmTrajectoryChunk, this, RIGHT, _1, _2, _3)));
+  left_hand_jogger_.reset(
+      new HandJogger(std::bind(&ArmControlInterface::readJogPose, this, LEFT, _1),
+                     std::bind(&ArmControlInterface::publishJogSetpoint, this, LEFT, _1, _2, _3)));
+  right_hand_jogger_.reset(
+      new HandJogger(std::bind(&ArmControlInterface::readJogPose, this, RIGHT, _1),
+                     std::bind(&ArmControlInterface::publishJogSetpoint, this, RIGHT, _1, _2, _3)));
 }
 
 ArmControlInterface::~ArmControlInterface()
 {
+  // streams and jogs publish from their own threads, stop them before the publishers are destroyed
+  left_arm_streamer_.reset();
+  right_arm_streamer_.reset();
+  left_hand_jogger_.reset();
+  right_hand_jogger_.reset();
   armTrajectorySubscriber.shutdown();
 }
 
@@ -55,9 +125,7 @@ ArmControlInterface::~ArmControlInterface()
 void ArmControlInterface::appendTrajectoryPoint(ihmc_msgs::ArmTrajectoryRosMessage& armMsg, const float time,
                                                 const std::vector<double>& pos)
 {
-  std::vector<std::pair<double, double>>* joint_limits_;
-  joint_limits_ = armMsg.robot_side == LEFT ? &joint_limits_left_ : &joint_limits_right_;
-  int id = ArmControlInterface::id_;
+  const JointChainLimits& joint_limits_ = armMsg.robot_side == LEFT ? joint_limits_left_ : joint_limits_right_;
 
   if (pos.size() != NUM_ARM_JOINTS)
   {
@@ -65,25 +133,8 @@ void ArmControlInterface::appendTrajectoryPoint(ihmc_msgs::ArmTrajectoryRosMessa
     return;
   }
   // checking if all the joints are within joint limits
-  for (int i = 0; i < NUM_ARM_JOINTS; i++)
-  {
-    ihmc_msgs::TrajectoryPoint1DRosMessage p;
-
-    // checking if the position is within joint limits
-    float position = pos[i];
-    position = pos[i] < joint_limits_->at(i).first ? joint_limits_->at(i).first : pos[i];
-    position = pos[i] > joint_limits_->at(i).second ? joint_limits_->at(i).second : pos[i];
-
-    p.time = time;
-    p.position = position;
-    p.velocity = 0;
-    p.unique_id = id_++;
-
-    armMsg.joint_trajectory_messages[i].trajectory_points.push_back(p);
-    armMsg.joint_trajectory_messages[i].unique_id = id;
-    // weight should be set to NAN so the optimizer can use its predefined weights.
-    armMsg.joint_trajectory_messages[i].weight = std::nan("");
-  }
+  dispatchRobotTraits(robot_type_,
+                      AppendArmTrajectoryPoint{ armMsg, time, pos, joint_limits_, ArmControlInterface::id_ });
 
   return;
 }
@@ -100,8 +151,12 @@ void ArmControlInterface::moveToDefaultPose(RobotSide side, float time)
   go_home.trajectory_time = time;
   go_home.unique_id = ArmControlInterface::id_++;
 
+  cancelArmTrajectoryStream(side);
   homePositionPublisher.publish(go_home);
-  ros::Duration(0.5).sleep();
+  const std::vector<std::string>& joint_names =
+      rd_->getJointChainNames(side == LEFT ? JointChain::LEFT_ARM : JointChain::RIGHT_ARM);
+  command_tracer_->recordPublish("go_home", go_home.unique_id, joint_names);
+  trackCommand(go_home.unique_id, joint_names, std::vector<double>(), time);
 }
 
 /**
@@ -110,6 +165,7 @@ void ArmControlInterface::moveToDefaultPose(RobotSide side, float time)
  */
 void ArmControlInterface::moveToZeroPose(const RobotSide side, const float time)
 {
+  const CommandTracer::Clock::time_point start = CommandTracer::Clock::now();
   ihmc_msgs::ArmTrajectoryRosMessage arm_traj;
   arm_traj.joint_trajectory_messages.clear();
 
@@ -122,7 +178,7 @@ void ArmControlInterface::moveToZeroPose(const RobotSide side, const float time)
   else
     appendTrajectoryPoint(arm_traj, time, ZERO_POSE);
 
-  armTrajectoryPublisher.publish(arm_traj);
+  publishArmMessage(arm_traj, start);
 }
 
 /**
@@ -134,21 +190,39 @@ void ArmControlInterface::moveToZeroPose(const RobotSide side, const float time)
 bool ArmControlInterface::moveArmJoints(const RobotSide side, const std::vector<std::vector<double>>& arm_pose,
                                         const float time)
 {
+  const CommandTracer::Clock::time_point start = CommandTracer::Clock::now();
   ihmc_msgs::ArmTrajectoryRosMessage arm_traj;
   if (generateArmMessage(side, arm_pose, time, arm_traj))
   {
-    armTrajectoryPublisher.publish(arm_traj);
+    publishArmMessage(arm_traj, start);
     return true;
   }
   return false;
 }
 
+bool ArmControlInterface::moveArmJointsGuarded(const RobotSide side, const std::vector<std::vector<double>>& arm_pose,
+                                               const float time, const WristGuard& guard, GuardedMoveResult& result)
+{
+  auto publish = [&]() -> long {
+    const CommandTracer::Clock::time_point start = CommandTracer::Clock::now();
+    ihmc_msgs::ArmTrajectoryRosMessage arm_traj;
+    if (!generateArmMessage(side, arm_pose, time, arm_traj))
+    {
+      return 0;
+    }
+    publishArmMessage(arm_traj, start);
+    return arm_traj.unique_id;
+  };
+  return guardedMove(side, publish, guard, result);
+}
+
 bool ArmControlInterface::setupArmMessage(const RobotSide side, ihmc_msgs::ArmTrajectoryRosMessage& msg)
 {
   msg.joint_trajectory_messages.clear();
   msg.joint_trajectory_messages.resize(NUM_ARM_JOINTS);
   msg.robot_side = side;
   msg.unique_id = id_++;
+  return true;
 }
 
 bool ArmControlInterface::generateArmMessage(const RobotSide side, const std::vector<std::vector<double>>& arm_pose,
@@ -177,6 +251,55 @@ void ArmControlInterface::generateArmMessage(
   msg.unique_id = id_++;
 }
 
+bool ArmControlInterface::generateArmMessage(const RobotSide side, const Eigen::MatrixXd& positions,
+                                             const Eigen::VectorXd& times, ihmc_msgs::ArmTrajectoryRosMessage& msg,
+                                             const Eigen::MatrixXd& velocities)
+{
+  const int num_points = positions.rows();
+  if (positions.cols() != NUM_ARM_JOINTS || times.size() != num_points ||
+      (velocities.size() != 0 && (velocities.rows() != num_points || velocities.cols() != NUM_ARM_JOINTS)))
+  {
+    ROS_WARN("Check number of trajectory points. Recieved %d x %d positions, %d times, expected %d joints", num_points,
+             (int)positions.cols(), (int)times.size(), NUM_ARM_JOINTS);
+    return false;
+  }
+
+  // columns are contiguous, every joint is clamped for all the points in one vectorized pass
+  const JointChainLimits& joint_limits = side == LEFT ? joint_limits_left_ : joint_limits_right_;
+  Eigen::MatrixXd clamped(num_points, NUM_ARM_JOINTS);
+  for (int j = 0; j < NUM_ARM_JOINTS; j++)
+  {
+    clamped.col(j) = positions.col(j).array().max(joint_limits.lower[j]).min(joint_limits.upper[j]);
+  }
+  const long num_clamped = (clamped.array() != positions.array()).count();
+  if (num_clamped > 0)
+  {
+    ROS_WARN("Clamped %ld of %d trajectory positions to the joint limits", num_clamped, num_points * NUM_ARM_JOINTS);
+  }
+
+  setupArmMessage(side, msg);
+  msg.execution_mode = ihmc_msgs::ArmTrajectoryRosMessage::OVERRIDE;
+  // reserve the ids of all the points at once, other threads may be building messages
+  const long base_id = id_.fetch_add(static_cast<long>(num_points) * NUM_ARM_JOINTS);
+  for (int j = 0; j < NUM_ARM_JOINTS; j++)
+  {
+    ihmc_msgs::OneDoFJointTrajectoryRosMessage& joint_trajectory = msg.joint_trajectory_messages[j];
+    joint_trajectory.unique_id = msg.unique_id;
+    // weight should be set to NAN so the optimizer can use its predefined weights.
+    joint_trajectory.weight = std::nan("");
+    joint_trajectory.trajectory_points.resize(num_points);
+    for (int i = 0; i < num_points; i++)
+    {
+      ihmc_msgs::TrajectoryPoint1DRosMessage& p = joint_trajectory.trajectory_points[i];
+      p.time = times[i];
+      p.position = clamped(i, j);
+      p.velocity = velocities.size() == 0 ? 0.0 : velocities(i, j);
+      p.unique_id = base_id + j * num_points + i;
+    }
+  }
+  return true;
+}
+
 /// TODO: It might be a good idea to shift this to whole body control message
 /**
  * @brief ArmControlInterface::moveArmJoints moves both the arms together.
@@ -184,6 +307,7 @@ void ArmControlInterface::generateArmMessage(
  */
 bool ArmControlInterface::moveArmJoints(const std::vector<ArmJointData>& arm_data)
 {
+  const CommandTracer::Clock::time_point start = CommandTracer::Clock::now();
   ihmc_msgs::ArmTrajectoryRosMessage arm_traj_r;
   ihmc_msgs::ArmTrajectoryRosMessage arm_traj_l;
   bool right = false, left = false;
@@ -221,10 +345,9 @@ bool ArmControlInterface::moveArmJoints(const std::vector<ArmJointData>& arm_dat
   }
 
   if (right)
-    armTrajectoryPublisher.publish(arm_traj_r);
-  ros::Duration(0.02).sleep();  /// TODO: Might have to increase time for safety when executing on hardware.
+    publishArmMessage(arm_traj_r, start);
   if (left)
-    armTrajectoryPublisher.publish(arm_traj_l);
+    publishArmMessage(arm_traj_l, start);
 
   return true;
 }
@@ -235,7 +358,7 @@ bool ArmControlInterface::moveArmJoints(const std::vector<ArmJointData>& arm_dat
  */
 void ArmControlInterface::moveArmMessage(const ihmc_msgs::ArmTrajectoryRosMessage& msg)
 {
-  this->armTrajectoryPublisher.publish(msg);
+  publishArmMessage(msg);
 }
 
 /**
@@ -248,74 +371,184 @@ int ArmControlInterface::getnumArmJoints() const
 }
 
 /**
- * @brief ArmControlInterface::appendTrajectoryPoint will append a joint trajectory point
- * @param msg is the reference of the current msg where point is to be appended.
- * @param point is the joint trajectory point.
+ * @brief ArmControlInterface::moveArmTrajectory  moves the arm based on joint trajectory (mainly used with MOVEIT)
+ * @param side is the side of the arm
+ * @param traj is the trajectory message
  */
-void ArmControlInterface::appendTrajectoryPoint(ihmc_msgs::ArmTrajectoryRosMessage& msg,
-                                                const trajectory_msgs::JointTrajectoryPoint& point)
+void ArmControlInterface::moveArmTrajectory(const RobotSide side, const trajectory_msgs::JointTrajectory& traj)
 {
-  if (point.positions.size() != NUM_ARM_JOINTS)
-  {
-    ROS_WARN("Check number of trajectory points. Recieved %d expected %d", (int)point.positions.size(), NUM_ARM_JOINTS);
-    return;
-  }
+  const CommandTracer::Clock::time_point start = CommandTracer::Clock::now();
+  trajectory_msgs::JointTrajectory decimated;
+  const trajectory_msgs::JointTrajectory& waypoints = decimate(traj, decimated);
 
-  std::vector<std::pair<double, double>> joint_limits_;
-  joint_limits_ = msg.robot_side == LEFT ? joint_limits_left_ : joint_limits_right_;
-  std::vector<std::string> joint_names;
-  rd_->getLeftArmJointNames(joint_names);
-  for (int i = 0; i < NUM_ARM_JOINTS; i++)
+  ihmc_msgs::ArmTrajectoryRosMessage arm_traj;
+  if (generateArmMessage(side, waypoints, arm_traj))
   {
-    ihmc_msgs::TrajectoryPoint1DRosMessage p;
-    ROS_INFO("Joint : %s - theta : %0.8f limits - <%0.3f %0.3f>", joint_names[i].c_str(), point.positions[i],
-             joint_limits_[i].first, joint_limits_[i].second);
-    //        point.positions[i] = point.positions[i] <= joint_limits_[i].first  ? joint_limits_[i].first :
-    //        point.positions[i];
-    //        point.positions[i] = point.positions[i] >= joint_limits_[i].second ? joint_limits_[i].second :
-    //        point.positions[i];
-    float position = point.positions[i];
-    if (point.positions[i] <= joint_limits_[i].first)
-    {
-      std::cout << "wrapped lower point " << point.positions[i] << "\n";
-      position = joint_limits_[i].first;
-    }
-    else if (point.positions[i] >= joint_limits_[i].second)
-    {
-      std::cout << "wrapped upper point " << point.positions[i] << "\n";
-      position = joint_limits_[i].second;
-    }
-    p.time = point.time_from_start.toSec();
-    p.position = position;
-    p.velocity = point.velocities[i];
-    p.unique_id = id_++;
-    msg.joint_trajectory_messages[i].trajectory_points.push_back(p);
+    ROS_INFO("Publishing Arm Trajectory");
+    publishArmMessage(arm_traj, start);
   }
-
-  return;
 }
 
 /**
- * @brief ArmControlInterface::moveArmTrajectory  moves the arm based on joint trajectory (mainly used with MOVEIT)
+ * @brief ArmControlInterface::streamArmTrajectory moves the arm based on joint trajectory, sending it in chunks so
+ * the arm starts moving before the whole trajectory is converted
  * @param side is the side of the arm
  * @param traj is the trajectory message
+ * @param chunk_size is the number of trajectory points in each message
+ * @param lookahead is the time before the end of a chunk at which the next one is queued
  */
-void ArmControlInterface::moveArmTrajectory(const RobotSide side, const trajectory_msgs::JointTrajectory& traj)
+bool ArmControlInterface::streamArmTrajectory(const RobotSide side, const trajectory_msgs::JointTrajectory& traj,
+                                              const size_t chunk_size, const double lookahead)
 {
-  ihmc_msgs::ArmTrajectoryRosMessage arm_traj;
-  arm_traj.joint_trajectory_messages.clear();
+  trajectory_msgs::JointTrajectory decimated;
+  const trajectory_msgs::JointTrajectory& waypoints = decimate(traj, decimated);
 
-  //    arm_traj.joint_trajectory_messages.resize(NUM_ARM_JOINTS); old /// resolve size issue
-  arm_traj.joint_trajectory_messages.resize(traj.points.size());  /// resolve size issue
-  arm_traj.robot_side = side;
-  arm_traj.unique_id = ArmControlInterface::id_++;
+  return (side == LEFT ? left_arm_streamer_ : right_arm_streamer_)->start(waypoints, chunk_size, lookahead);
+}
+
+void ArmControlInterface::cancelArmTrajectoryStream(const RobotSide side)
+{
+  (side == LEFT ? left_arm_streamer_ : right_arm_streamer_)->cancel();
+}
+
+bool ArmControlInterface::isArmTrajectoryStreaming(const RobotSide side) const
+{
+  return (side == LEFT ? left_arm_streamer_ : right_arm_streamer_)->isStreaming();
+}
+
+bool ArmControlInterface::startHandJog(const RobotSide side)
+{
+  return (side == LEFT ? left_hand_jogger_ : right_hand_jogger_)->start();
+}
+
+bool ArmControlInterface::jogHand(const RobotSide side, const geometry_msgs::Twist& velocity)
+{
+  HandJogger& jogger = *(side == LEFT ? left_hand_jogger_ : right_hand_jogger_);
+  if (!jogger.isJogging())
+  {
+    return false;
+  }
+  jogger.setVelocity(velocity);
+  return true;
+}
+
+void ArmControlInterface::stopHandJog(const RobotSide side)
+{
+  (side == LEFT ? left_hand_jogger_ : right_hand_jogger_)->stop();
+}
+
+bool ArmControlInterface::isHandJogging(const RobotSide side) const
+{
+  return (side == LEFT ? left_hand_jogger_ : right_hand_jogger_)->isJogging();
+}
+
+void ArmControlInterface::setHandJogLimits(const HandJogger::Limits& limits)
+{
+  left_hand_jogger_->setLimits(limits);
+  right_hand_jogger_->setLimits(limits);
+}
 
-  for (auto i = traj.points.begin(); i < traj.points.end(); i++)
+bool ArmControlInterface::readJogPose(const RobotSide side, geometry_msgs::Pose& pose)
+{
+  // the hand frames are links of the robot, their pose is computed from the joint state without waiting for TF
+  return state_informer_->getCurrentPose(side == LEFT ? rd_->getLeftEEFrame() : rd_->getRightEEFrame(), pose,
+                                         rd_->getPelvisFrame());
+}
+
+void ArmControlInterface::publishJogSetpoint(const RobotSide side, const geometry_msgs::Pose& pose,
+                                             const geometry_msgs::Twist& velocity, const double time)
+{
+  ihmc_msgs::HandTrajectoryRosMessage msg;
+  msg.robot_side = side;
+  msg.frame_information.trajectory_reference_frame_id = rd_->getPelvisFrameHash();
+  msg.frame_information.data_reference_frame_id = rd_->getPelvisFrameHash();
+  msg.execution_mode = ihmc_msgs::HandTrajectoryRosMessage::OVERRIDE;
+
+  ihmc_msgs::SE3TrajectoryPointRosMessage point;
+  poseToSE3TrajectoryPoint(pose, point);
+  point.linear_velocity = velocity.linear;
+  point.angular_velocity = velocity.angular;
+  point.time = time;
+  msg.taskspace_trajectory_points.push_back(point);
+  msg.unique_id = ArmControlInterface::id_++;
+
+  // setpoints are not tracked, each one is replaced by the next one a period later
+  taskSpaceTrajectoryPublisher.publish(msg);
+}
+
+long ArmControlInterface::publishArmTrajectoryChunk(const RobotSide side, const trajectory_msgs::JointTrajectory& chunk,
+                                                    const int execution_mode, const long previous_message_id)
+{
+  ihmc_msgs::ArmTrajectoryRosMessage arm_traj;
+  if (!generateArmMessage(side, chunk, arm_traj))
   {
-    appendTrajectoryPoint(arm_traj, *i);
+    return 0;
   }
-  ROS_INFO("Publishing Arm Trajectory");
+  arm_traj.execution_mode = execution_mode;
+  arm_traj.previous_message_id = previous_message_id;
   armTrajectoryPublisher.publish(arm_traj);
+
+  // queued chunks start while the arm is already moving, only the first one has a motion onset
+  const ros::Time now = ros::Time::now();
+  ros::Time& stream_end = side == LEFT ? left_stream_end_ : right_stream_end_;
+  if (execution_mode == TrajectoryStreamer::OVERRIDE)
+  {
+    command_tracer_->recordPublish("arm_trajectory", arm_traj.unique_id);
+    stream_end = now;
+  }
+  // a queued chunk starts when the previous one ends
+  const double delay = std::max(0.0, (stream_end - now).toSec());
+  trackArmMessage(arm_traj, delay);
+  stream_end = now + ros::Duration(delay + chunk.points.back().time_from_start.toSec());
+  return arm_traj.unique_id;
+}
+
+bool ArmControlInterface::generateArmMessage(const RobotSide side, const trajectory_msgs::JointTrajectory& traj,
+                                             ihmc_msgs::ArmTrajectoryRosMessage& msg)
+{
+  // the arm joints are gathered by name when the trajectory names all of them, it can contain other joints as well.
+  // Otherwise the positions are the arm joints in their order.
+  std::vector<int> columns;
+  size_t num_columns = traj.joint_names.size();
+  if (!rd_->getJointStateIndices(side == LEFT ? JointChain::LEFT_ARM : JointChain::RIGHT_ARM, traj.joint_names,
+                                 columns))
+  {
+    columns.resize(NUM_ARM_JOINTS);
+    for (int j = 0; j < NUM_ARM_JOINTS; j++)
+    {
+      columns[j] = j;
+    }
+    num_columns = NUM_ARM_JOINTS;
+  }
+
+  const int num_points = traj.points.size();
+  Eigen::MatrixXd positions(num_points, NUM_ARM_JOINTS);
+  Eigen::MatrixXd velocities = Eigen::MatrixXd::Zero(num_points, NUM_ARM_JOINTS);
+  Eigen::VectorXd times(num_points);
+  for (int i = 0; i < num_points; i++)
+  {
+    const trajectory_msgs::JointTrajectoryPoint& point = traj.points[i];
+    if (point.positions.size() != num_columns)
+    {
+      ROS_WARN("Trajectory does not contain the %s arm joints. Recieved %d positions expected %d",
+               side == LEFT ? "left" : "right", (int)point.positions.size(), (int)num_columns);
+      return false;
+    }
+    for (int j = 0; j < NUM_ARM_JOINTS; j++)
+    {
+      positions(i, j) = point.positions[columns[j]];
+    }
+    if (point.velocities.size() == point.positions.size())
+    {
+      for (int j = 0; j < NUM_ARM_JOINTS; j++)
+      {
+        velocities(i, j) = point.velocities[columns[j]];
+      }
+    }
+    times[i] = point.time_from_start.toSec();
+  }
+
+  return generateArmMessage(side, positions, times, msg, velocities);
 }
 
 // *******
@@ -382,8 +615,162 @@ bool ArmControlInterface::moveArmJoint(const RobotSide side, int jointNumber, co
   return false;
 }
 
+void ArmControlInterface::publishArmMessage(const ihmc_msgs::ArmTrajectoryRosMessage& msg,
+                                            const CommandTracer::Clock::time_point construction_time)
+{
+  // chunks of a running stream would be queued after a message that was overridden
+  if (msg.execution_mode == ihmc_msgs::ArmTrajectoryRosMessage::OVERRIDE)
+  {
+    cancelArmTrajectoryStream(msg.robot_side == LEFT ? LEFT : RIGHT);
+  }
+  armTrajectoryPublisher.publish(msg);
+  const JointChain chain = msg.robot_side == LEFT ? JointChain::LEFT_ARM : JointChain::RIGHT_ARM;
+  command_tracer_->recordPublish("arm_trajectory", msg.unique_id, rd_->getJointChainNames(chain), construction_time);
+  trackArmMessage(msg, 0.0);
+}
+
+void ArmControlInterface::trackArmMessage(const ihmc_msgs::ArmTrajectoryRosMessage& msg, const double delay)
+{
+  // the last point of every joint is the target, the joint that finishes last sets the duration
+  std::vector<double> targets;
+  double duration = 0.0;
+  for (const auto& joint_trajectory : msg.joint_trajectory_messages)
+  {
+    if (!joint_trajectory.trajectory_points.empty())
+    {
+      targets.push_back(joint_trajectory.trajectory_points.back().position);
+      duration = std::max(duration, joint_trajectory.trajectory_points.back().time);
+    }
+  }
+  const JointChain chain = msg.robot_side == LEFT ? JointChain::LEFT_ARM : JointChain::RIGHT_ARM;
+  trackCommand(msg.unique_id, rd_->getJointChainNames(chain), targets, delay + duration,
+               msg.execution_mode == ihmc_msgs::ArmTrajectoryRosMessage::OVERRIDE);
+}
+
+bool ArmControlInterface::guardedMove(const RobotSide side, const std::function<long()>& publish,
+                                      const WristGuard& guard, GuardedMoveResult& result)
+{
+  // state shared with the sensor callback, which may still run after it is removed
+  struct Contact
+  {
+    std::atomic<bool> tripped;
+    std::mutex mutex;
+    geometry_msgs::WrenchStamped wrench;
+  };
+  std::shared_ptr<Contact> contact = std::make_shared<Contact>();
+  contact->tripped = false;
+  result = GuardedMoveResult();
+
+  const JointChain chain = side == LEFT ? JointChain::LEFT_ARM : JointChain::RIGHT_ARM;
+  const JointGroupHandle joints = state_informer_->getJointGroupHandle(rd_->getJointChainNames(chain));
+  // the wrench at the start of the move is the baseline, a missing or stale one would trip on the first message
+  geometry_msgs::Wrench baseline;
+  ros::Time baseline_stamp;
+  if (!state_informer_->getWristWrench(side, baseline, baseline_stamp) ||
+      ros::Time::now() - baseline_stamp > ros::Duration(guard.max_wrench_age))
+  {
+    ROS_ERROR("Guarded move not started, no recent wrench from the wrist sensor");
+    return false;
+  }
+
+  const long unique_id = publish();
+  CommandFuture future;
+  if (unique_id == 0 || !command_monitor_->getFuture(unique_id, future))
+  {
+    return false;
+  }
+
+  // the arm is stopped from the sensor callback, waiting for this thread to be scheduled would add to the distance
+  // travelled after contact
+  auto checkWrench = [this, side, guard, baseline, joints, contact](const RobotSide wrench_side,
+                                                                    const geometry_msgs::WrenchStamped& wrench) {
+    if (wrench_side != side || contact->tripped)
+    {
+      return;
+    }
+    const Eigen::Vector3d force(wrench.wrench.force.x - baseline.force.x, wrench.wrench.force.y - baseline.force.y,
+                                wrench.wrench.force.z - baseline.force.z);
+    const Eigen::Vector3d torque(wrench.wrench.torque.x - baseline.torque.x,
+                                 wrench.wrench.torque.y - baseline.torque.y,
+                                 wrench.wrench.torque.z - baseline.torque.z);
+    if (force.norm() < guard.force_threshold && torque.norm() < guard.torque_threshold)
+    {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(contact->mutex);
+    if (contact->tripped)
+    {
+      return;
+    }
+
+    // hold the arm where it is, other limbs keep executing their trajectories. Without the positions of the arm
+    // everything is stopped, the arm must not keep pushing.
+    std::vector<double> positions;
+    if (joints.getPositions(positions) && positions.size() == NUM_ARM_JOINTS)
+    {
+      ihmc_msgs::ArmTrajectoryRosMessage hold;
+      setupArmMessage(side, hold);
+      hold.execution_mode = ihmc_msgs::ArmTrajectoryRosMessage::OVERRIDE;
+      appendTrajectoryPoint(hold, guard.stop_time, positions);
+      cancelArmTrajectoryStream(side);
+      armTrajectoryPublisher.publish(hold);
+    }
+    else
+    {
+      ROS_WARN("Positions of the %s arm are not available, stopping all trajectories", side == LEFT ? "left" : "right");
+      cancelArmTrajectoryStream(side);
+      ihmc_msgs::StopAllTrajectoryRosMessage stop;
+      stop.unique_id = ArmControlInterface::id_++;
+      stopAllTrajectoriesPublisher.publish(stop);
+      // commands of the other limbs will not reach their targets either
+      command_monitor_->cancelAll();
+    }
+    contact->wrench = wrench;
+    contact->tripped = true;
+  };
+  const int handle = state_informer_->addWristWrenchCallback(checkWrench);
+
+  auto isDone = [&]() {
+    return contact->tripped || future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+  };
+  state_informer_->waitForCondition(isDone, ros::DURATION_MAX);
+  state_informer_->removeWristWrenchCallback(handle);
+
+  if (contact->tripped)
+  {
+    // the hold message overrides the move, it would otherwise time out in the monitor
+    command_monitor_->cancel(unique_id);
+    std::lock_guard<std::mutex> lock(contact->mutex);
+    result.contact = true;
+    result.contact_time = contact->wrench.header.stamp;
+    result.wrench = contact->wrench.wrench;
+    ROS_INFO("Guarded move stopped at contact, force %.2f %.2f %.2f", result.wrench.force.x, result.wrench.force.y,
+             result.wrench.force.z);
+    return true;
+  }
+  return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+         future.get() == CommandStatus::SUCCEEDED;
+}
+
 // ************ Mesages using HandTrajectoryRosMessage  ******************** //
 
+void ArmControlInterface::publishHandMessage(const ihmc_msgs::HandTrajectoryRosMessage& msg)
+{
+  if (msg.execution_mode == ihmc_msgs::HandTrajectoryRosMessage::OVERRIDE)
+  {
+    cancelArmTrajectoryStream(msg.robot_side == LEFT ? LEFT : RIGHT);
+  }
+  taskSpaceTrajectoryPublisher.publish(msg);
+  const JointChain chain = msg.robot_side == LEFT ? JointChain::LEFT_ARM : JointChain::RIGHT_ARM;
+  command_tracer_->recordPublish("hand_trajectory", msg.unique_id, rd_->getJointChainNames(chain));
+
+  // targets are in task space, completion is detected when the arm stops
+  const double duration =
+      msg.taskspace_trajectory_points.empty() ? 0.0 : msg.taskspace_trajectory_points.back().time;
+  trackCommand(msg.unique_id, rd_->getJointChainNames(chain), std::vector<double>(), duration,
+               msg.execution_mode == ihmc_msgs::HandTrajectoryRosMessage::OVERRIDE);
+}
+
 void ArmControlInterface::poseToSE3TrajectoryPoint(const geometry_msgs::Pose& pose,
                                                    ihmc_msgs::SE3TrajectoryPointRosMessage& point)
 {
@@ -590,11 +977,35 @@ void ArmControlInterface::moveArmInTaskSpace(const RobotSide side, const geometr
   this->moveArmInTaskSpaceMessage(side, point, baseForControl);
 }
 
+bool ArmControlInterface::moveArmInTaskSpaceGuarded(const RobotSide side, const geometry_msgs::Pose& pose,
+                                                    const float time, const WristGuard& guard,
+                                                    GuardedMoveResult& result, int baseForControl)
+{
+  auto publish = [&]() -> long {
+    ihmc_msgs::SE3TrajectoryPointRosMessage point;
+    poseToSE3TrajectoryPoint(pose, point);
+    point.time = time;
+    ihmc_msgs::HandTrajectoryRosMessage msg;
+    generateHandMessage(side, point, baseForControl, msg);
+    publishHandMessage(msg);
+    return msg.unique_id;
+  };
+  return guardedMove(side, publish, guard, result);
+}
+
 void ArmControlInterface::moveArmInTaskSpaceMessage(const RobotSide side,
                                                     const ihmc_msgs::SE3TrajectoryPointRosMessage& point,
                                                     int baseForControl)
 {
   ihmc_msgs::HandTrajectoryRosMessage msg;
+  generateHandMessage(side, point, baseForControl, msg);
+  publishHandMessage(msg);
+}
+
+void ArmControlInterface::generateHandMessage(const RobotSide side,
+                                              const ihmc_msgs::SE3TrajectoryPointRosMessage& point,
+                                              const int baseForControl, ihmc_msgs::HandTrajectoryRosMessage& msg)
+{
   ihmc_msgs::FrameInformationRosMessage reference_frame;
 
   reference_frame.data_reference_frame_id = baseForControl;
@@ -606,7 +1017,6 @@ void ArmControlInterface::moveArmInTaskSpaceMessage(const RobotSide side,
   msg.execution_mode = msg.OVERRIDE;
 
   msg.unique_id = ArmControlInterface::id_++;
-  taskSpaceTrajectoryPublisher.publish(msg);
 }
 
 void ArmControlInterface::moveArmInTaskSpace(const std::vector<ArmTaskSpaceData>& arm_data, const int baseForControl)
@@ -650,7 +1060,8 @@ void ArmControlInterface::moveArmInTaskSpace(const std::vector<ArmTaskSpaceData>
     }
   }
 
-  taskSpaceTrajectoryPublisher.publish(msg_r);
-  ros::Duration(0.02).sleep();
-  taskSpaceTrajectoryPublisher.publish(msg_l);
+  if (!msg_r.taskspace_trajectory_points.empty())
+    publishHandMessage(msg_r);
+  if (!msg_l.taskspace_trajectory_points.empty())
+    publishHandMessage(msg_l);
 }
@@ -9,11 +9,7 @@ ChestControlInterface::ChestControlInterface(ros::NodeHandle nh) : ToughControlI
   homePositionPublisher_ =
       nh_.advertise<ihmc_msgs::GoHomeRosMessage>(control_topic_prefix_ + TOUGH_COMMON_NAMES::GO_HOME_TOPIC, 1, true);
   rd_->getChestJointNames(chestJointNames_);
-  chestJointNumbers_.resize(chestJointNames_.size());
-  for (auto&& joint : chestJointNames_)
-  {
-    chestJointNumbers_.push_back(state_informer_->getJointNumber(joint));
-  }
+  chestJoints_ = state_informer_->getJointGroupHandle(chestJointNames_);
 }
 
 ChestControlInterface::~ChestControlInterface()
@@ -33,16 +29,31 @@ void ChestControlInterface::controlChest(const float roll, const float pitch, co
 
 void ChestControlInterface::controlChest(const geometry_msgs::Quaternion quat, const float time, int execution_mode)
 {
+  const CommandTracer::Clock::time_point start = CommandTracer::Clock::now();
   ihmc_msgs::ChestTrajectoryRosMessage msg;
   generateMessage(quat, time, execution_mode, msg);
 
   // publish the message
-  chestTrajPublisher_.publish(msg);
+  publishMessage(msg, start);
 }
 
 void ChestControlInterface::executeMessage(const ihmc_msgs::ChestTrajectoryRosMessage& msg)
+{
+  // the message was built by the caller, its construction is not traced
+  publishMessage(msg, CommandTracer::Clock::time_point());
+}
+
+void ChestControlInterface::publishMessage(const ihmc_msgs::ChestTrajectoryRosMessage& msg,
+                                           const CommandTracer::Clock::time_point construction_time)
 {
   chestTrajPublisher_.publish(msg);
+  command_tracer_->recordPublish("chest_trajectory", msg.unique_id, chestJointNames_, construction_time);
+
+  // targets are orientations, completion is detected when the chest stops
+  const double duration =
+      msg.taskspace_trajectory_points.empty() ? 0.0 : msg.taskspace_trajectory_points.back().time;
+  trackCommand(msg.unique_id, chestJointNames_, std::vector<double>(), duration,
+               msg.execution_mode == ihmc_msgs::ChestTrajectoryRosMessage::OVERRIDE);
 }
 
 void ChestControlInterface::setupFrameAndMode(ihmc_msgs::ChestTrajectoryRosMessage& msg, const int mode,
@@ -107,16 +118,15 @@ void ChestControlInterface::resetPose(float time)
   go_home.trajectory_time = time;
   go_home.unique_id = ChestControlInterface::id_++;
   homePositionPublisher_.publish(go_home);
-  ros::Duration(0.5).sleep();
+  command_tracer_->recordPublish("go_home", go_home.unique_id, chestJointNames_);
+  trackCommand(go_home.unique_id, chestJointNames_, std::vector<double>(), time);
 }
 
 bool ChestControlInterface::getJointSpaceState(std::vector<double>& joints, RobotSide side)
 {
-  joints.resize(chestJointNames_.size());
-  for (auto&& jointNumber : chestJointNumbers_)
-  {
-    joints.push_back(state_informer_->getJointPosition(jointNumber));
-  }
+  // a copy per call, resolving the indices of the shared handle from concurrent calls would race
+  const JointGroupHandle chest_joints = chestJoints_;
+  return chest_joints.getPositions(joints);
 }
 
 bool ChestControlInterface::getTaskSpaceState(geometry_msgs::Pose& pose, RobotSide side, std::string fixedFrame)
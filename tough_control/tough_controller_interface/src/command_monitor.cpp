@@ -0,0 +1,335 @@
+#include "tough_controller_interface/command_monitor.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+CommandMonitor* CommandMonitor::currentObject_ = nullptr;
+
+namespace
+{
+const std::chrono::milliseconds CHECK_PERIOD(10);
+const size_t MAX_COMPLETED_COMMANDS = 100;
+}  // namespace
+
+CommandMonitor* CommandMonitor::getCommandMonitor(ros::NodeHandle nh)
+{
+  // check if an object of this class already exists, if not create one
+  if (CommandMonitor::currentObject_ == nullptr)
+  {
+    static CommandMonitor obj(nh);
+    currentObject_ = &obj;
+  }
+  return currentObject_;
+}
+
+CommandMonitor::CommandMonitor(ros::NodeHandle nh)
+  : state_informer_(RobotStateInformer::getRobotStateInformer(nh))
+  , position_tolerance_(0.05)
+  , velocity_tolerance_(0.05)
+  , timeout_(5.0)
+  , running_(true)
+{
+  thread_ = std::thread(&CommandMonitor::monitorCommands, this);
+}
+
+CommandMonitor::~CommandMonitor()
+{
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    running_ = false;
+  }
+  stop_condition_.notify_all();
+  if (thread_.joinable())
+  {
+    thread_.join();
+  }
+}
+
+CommandFuture CommandMonitor::track(const long unique_id, const std::vector<std::string>& joint_names,
+                                    const std::vector<double>& targets, const double duration,
+                                    const bool overrides)
+{
+  CommandPtr command = std::make_shared<Command>();
+  command->unique_id = unique_id;
+  command->all_joints = joint_names.empty();
+  if (joint_names.empty())
+  {
+    std::vector<std::string> all_joints;
+    state_informer_->getJointNames(all_joints);
+    command->joints = state_informer_->getJointGroupHandle(all_joints);
+  }
+  else
+  {
+    command->joints = state_informer_->getJointGroupHandle(joint_names);
+  }
+  if (targets.size() == command->joints.size())
+  {
+    command->targets = targets;
+  }
+  command->end_time = ros::Time::now() + ros::Duration(std::max(0.0, duration));
+  command->future = command->promise.get_future().share();
+
+  // a command sent again with the same id replaces the previous one, an override replaces the commands on its joints
+  std::vector<CommandPtr> replaced;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (auto& pending : pending_)
+    {
+      if (pending.first == unique_id || (overrides && sharesJoints(*pending.second, *command)))
+      {
+        replaced.push_back(pending.second);
+      }
+    }
+  }
+  for (auto& previous : replaced)
+  {
+    if (previous->unique_id != unique_id)
+    {
+      ROS_DEBUG("Command %ld was overridden by command %ld", previous->unique_id, unique_id);
+    }
+    complete(previous, CommandStatus::CANCELLED);
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  pending_[unique_id] = command;
+  return command->future;
+}
+
+bool CommandMonitor::getFuture(const long unique_id, CommandFuture& future) const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto pending = pending_.find(unique_id);
+  if (pending != pending_.end())
+  {
+    future = pending->second->future;
+    return true;
+  }
+  auto completed = completed_.find(unique_id);
+  if (completed != completed_.end())
+  {
+    future = completed->second;
+    return true;
+  }
+  return false;
+}
+
+bool CommandMonitor::addCallback(const long unique_id, const CommandCallback& callback)
+{
+  CommandFuture future;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto pending = pending_.find(unique_id);
+    if (pending != pending_.end())
+    {
+      pending->second->callbacks.push_back(callback);
+      return true;
+    }
+    auto completed = completed_.find(unique_id);
+    if (completed == completed_.end())
+    {
+      return false;
+    }
+    future = completed->second;
+  }
+  callback(unique_id, future.get());
+  return true;
+}
+
+bool CommandMonitor::waitForCommand(const long unique_id, const ros::Duration& timeout)
+{
+  CommandFuture future;
+  if (!getFuture(unique_id, future))
+  {
+    return false;
+  }
+  auto isReady = [&future]() { return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; };
+  return state_informer_->waitForCondition(isReady, timeout) && future.get() == CommandStatus::SUCCEEDED;
+}
+
+bool CommandMonitor::cancel(const long unique_id)
+{
+  CommandPtr command;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = pending_.find(unique_id);
+    if (it == pending_.end())
+    {
+      return false;
+    }
+    command = it->second;
+  }
+  complete(command, CommandStatus::CANCELLED);
+  return true;
+}
+
+void CommandMonitor::cancelAll()
+{
+  std::vector<CommandPtr> cancelled;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (auto& pending : pending_)
+    {
+      cancelled.push_back(pending.second);
+    }
+  }
+  for (auto& command : cancelled)
+  {
+    complete(command, CommandStatus::CANCELLED);
+  }
+}
+
+void CommandMonitor::setTolerances(const double position_tolerance, const double velocity_tolerance)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  position_tolerance_ = std::fabs(position_tolerance);
+  velocity_tolerance_ = std::fabs(velocity_tolerance);
+}
+
+void CommandMonitor::setTimeout(const double timeout)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  timeout_ = std::max(0.0, timeout);
+}
+
+void CommandMonitor::monitorCommands()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (running_)
+  {
+    stop_condition_.wait_for(lock, CHECK_PERIOD);
+    if (!running_ || pending_.empty())
+    {
+      continue;
+    }
+
+    // joint state is read without holding the lock, commands can be tracked in the meantime
+    std::vector<CommandPtr> commands;
+    for (auto& pending : pending_)
+    {
+      commands.push_back(pending.second);
+    }
+    const ros::Duration timeout(timeout_);
+    lock.unlock();
+
+    const ros::Time now = ros::Time::now();
+    std::vector<std::pair<CommandPtr, CommandStatus> > finished;
+    for (auto& command : commands)
+    {
+      if (now < command->end_time)
+      {
+        continue;
+      }
+      if (hasConverged(*command))
+      {
+        finished.push_back(std::make_pair(command, CommandStatus::SUCCEEDED));
+      }
+      else if (now > command->end_time + timeout)
+      {
+        ROS_WARN("Command %ld did not converge %.1f seconds after its trajectory time", command->unique_id,
+                 timeout.toSec());
+        finished.push_back(std::make_pair(command, CommandStatus::TIMED_OUT));
+      }
+    }
+
+    for (auto& command : finished)
+    {
+      complete(command.first, command.second);
+    }
+    lock.lock();
+  }
+}
+
+bool CommandMonitor::hasConverged(const Command& command) const
+{
+  std::vector<double> velocities;
+  if (!command.joints.getVelocities(velocities))
+  {
+    return false;
+  }
+
+  double position_tolerance, velocity_tolerance;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    position_tolerance = position_tolerance_;
+    velocity_tolerance = velocity_tolerance_;
+  }
+
+  for (double velocity : velocities)
+  {
+    if (std::fabs(velocity) > velocity_tolerance)
+    {
+      return false;
+    }
+  }
+
+  if (command.targets.empty())
+  {
+    return true;
+  }
+  std::vector<double> positions;
+  if (!command.joints.getPositions(positions))
+  {
+    return false;
+  }
+  for (size_t i = 0; i < positions.size(); ++i)
+  {
+    if (std::fabs(positions[i] - command.targets[i]) > position_tolerance)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CommandMonitor::sharesJoints(const Command& first, const Command& second) const
+{
+  if (first.all_joints || second.all_joints)
+  {
+    return false;
+  }
+  const std::vector<std::string>& names = second.joints.getNames();
+  for (const std::string& name : first.joints.getNames())
+  {
+    if (std::find(names.begin(), names.end(), name) != names.end())
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void CommandMonitor::complete(const CommandPtr& command, const CommandStatus status)
+{
+  std::vector<CommandCallback> callbacks;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = pending_.find(command->unique_id);
+    if (it == pending_.end() || it->second != command)
+    {
+      // already completed, e.g. cancelled while its joints were checked
+      return;
+    }
+    pending_.erase(it);
+    callbacks.swap(command->callbacks);
+    completed_[command->unique_id] = command->future;
+    completed_order_.push_back(command->unique_id);
+    if (completed_order_.size() > MAX_COMPLETED_COMMANDS)
+    {
+      // ids can be completed again when they are reused, only erase the entry of the oldest one
+      const long oldest = completed_order_.front();
+      completed_order_.pop_front();
+      if (std::find(completed_order_.begin(), completed_order_.end(), oldest) == completed_order_.end())
+      {
+        completed_.erase(oldest);
+      }
+    }
+  }
+
+  command->promise.set_value(status);
+  for (auto& callback : callbacks)
+  {
+    callback(command->unique_id, status);
+  }
+  // waitForCommand waits on the state updates of the informer
+  state_informer_->notifyStateUpdate();
+}
@@ -2,7 +2,8 @@
 #include <tf/transform_listener.h>
 #include <map>
 
-GripperControlInterface::GripperControlInterface(ros::NodeHandle nh) : ToughControlInterface(nh)
+GripperControlInterface::GripperControlInterface(ros::NodeHandle nh)
+  : ToughControlInterface(nh), gripper_monitor_(GripperMonitor::getGripperMonitor(nh))
 {
   gripperPublisher_ = nh_.advertise<ihmc_msgs::HandDesiredConfigurationRosMessage>(
       control_topic_prefix_ + TOUGH_COMMON_NAMES::HAND_DESIRED_CONFIG_TOPIC, 1, true);
@@ -45,6 +46,12 @@ bool GripperControlInterface::getTaskSpaceState(geometry_msgs::Pose& pose, Robot
 
 bool GripperControlInterface::getJointSpaceState(std::vector<double>& joints, RobotSide side)
 {
+  if (!gripper_monitor_->getFingerJointNames(side).empty())
+  {
+    return gripper_monitor_->getFingerPositions(side, joints);
+  }
+
+  // without finger joints, the state of the gripper is the joint of the end effector frame
   joints.clear();
   double jointPosition =
       state_informer_->getJointPosition(side == RobotSide::LEFT ? rd_->getLeftEEFrame() : rd_->getRightEEFrame());
@@ -52,6 +59,21 @@ bool GripperControlInterface::getJointSpaceState(std::vector<double>& joints, Ro
   return true;
 }
 
+GripperState GripperControlInterface::getGripperState(const RobotSide side) const
+{
+  return gripper_monitor_->getState(side);
+}
+
+bool GripperControlInterface::waitForGrasp(const RobotSide side, const ros::Duration& timeout)
+{
+  return gripper_monitor_->waitForGrasp(side, timeout);
+}
+
+GripperMonitor* GripperControlInterface::getGripperMonitor() const
+{
+  return gripper_monitor_;
+}
+
 void GripperControlInterface::setMode(const RobotSide side, const GRIPPER_MODES mode)
 {
   controlGripper(side, mode);
@@ -0,0 +1,302 @@
+#include "tough_controller_interface/gripper_monitor.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+
+GripperMonitor* GripperMonitor::currentObject_ = nullptr;
+
+namespace
+{
+inline double meanAbsolute(const std::vector<double>& values)
+{
+  double sum = 0.0;
+  for (const double value : values)
+  {
+    sum += std::fabs(value);
+  }
+  return values.empty() ? 0.0 : sum / values.size();
+}
+
+inline double maxAbsolute(const std::vector<double>& values)
+{
+  double result = 0.0;
+  for (const double value : values)
+  {
+    result = std::max(result, std::fabs(value));
+  }
+  return result;
+}
+
+// movable joints of the subtree below a link, in breadth first order
+void getMovableJointsBelow(const urdf::Model& model, const std::string& link_name, std::vector<std::string>& names)
+{
+  names.clear();
+  urdf::LinkConstSharedPtr root = model.getLink(link_name);
+  if (!root)
+  {
+    return;
+  }
+  std::deque<urdf::LinkConstSharedPtr> queue(1, root);
+  while (!queue.empty())
+  {
+    urdf::LinkConstSharedPtr link = queue.front();
+    queue.pop_front();
+    for (const auto& joint : link->child_joints)
+    {
+      if (joint->type == urdf::Joint::REVOLUTE || joint->type == urdf::Joint::CONTINUOUS ||
+          joint->type == urdf::Joint::PRISMATIC)
+      {
+        names.push_back(joint->name);
+      }
+      urdf::LinkConstSharedPtr child = model.getLink(joint->child_link_name);
+      if (child)
+      {
+        queue.push_back(child);
+      }
+    }
+  }
+}
+}  // namespace
+
+GripperMonitor* GripperMonitor::getGripperMonitor(ros::NodeHandle nh)
+{
+  // check if an object of this class already exists, if not create one
+  if (GripperMonitor::currentObject_ == nullptr)
+  {
+    static GripperMonitor obj(nh);
+    currentObject_ = &obj;
+  }
+  return currentObject_;
+}
+
+GripperMonitor::GripperMonitor(ros::NodeHandle nh) : state_informer_(RobotStateInformer::getRobotStateInformer(nh))
+{
+  std::string robot_name;
+  if (!nh.getParam(TOUGH_COMMON_NAMES::ROBOT_NAME_PARAM, robot_name))
+  {
+    ROS_ERROR("%s parameter is not on the server. Using valkyrie by default",
+              TOUGH_COMMON_NAMES::ROBOT_NAME_PARAM.c_str());
+    robot_name = "valkyrie";
+  }
+  const std::string prefix = TOUGH_COMMON_NAMES::TOPIC_PREFIX + robot_name + "/";
+
+  const std::string params[2] = { prefix + TOUGH_COMMON_NAMES::LEFT_GRIPPER_JOINT_NAMES_PARAM,
+                                  prefix + TOUGH_COMMON_NAMES::RIGHT_GRIPPER_JOINT_NAMES_PARAM };
+  RobotDescription* rd = RobotDescription::getRobotDescription(nh);
+  const std::string palms[2] = { rd->getLeftPalmFrame(), rd->getRightPalmFrame() };
+  for (int side = LEFT; side <= RIGHT; ++side)
+  {
+    std::vector<std::string> joint_names;
+    if (!nh.getParam(params[side], joint_names))
+    {
+      // the fingers are the movable joints attached below the palm
+      getMovableJointsBelow(rd->getURDFModel(), palms[side], joint_names);
+      if (joint_names.empty())
+      {
+        ROS_WARN("%s parameter is not on the server and there are no joints below %s. The state of the gripper is not "
+                 "monitored",
+                 params[side].c_str(), palms[side].c_str());
+      }
+    }
+    grippers_[side].joints = state_informer_->getJointGroupHandle(joint_names);
+  }
+
+  joint_state_callback_ =
+      state_informer_->addJointStateCallback(std::bind(&GripperMonitor::jointStateCB, this, std::placeholders::_1));
+}
+
+GripperMonitor::~GripperMonitor()
+{
+  state_informer_->removeJointStateCallback(joint_state_callback_);
+}
+
+GripperState GripperMonitor::getState(const RobotSide side) const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return grippers_[side].state;
+}
+
+std::string GripperMonitor::getStateName(const GripperState state)
+{
+  switch (state)
+  {
+    case GripperState::MOVING:
+      return "MOVING";
+    case GripperState::OPEN:
+      return "OPEN";
+    case GripperState::CLOSED_EMPTY:
+      return "CLOSED_EMPTY";
+    case GripperState::GRASPED:
+      return "GRASPED";
+    case GripperState::SLIPPING:
+      return "SLIPPING";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+const std::vector<std::string>& GripperMonitor::getFingerJointNames(const RobotSide side) const
+{
+  // names are set in the constructor and never change
+  return grippers_[side].joints.getNames();
+}
+
+bool GripperMonitor::getFingerPositions(const RobotSide side, std::vector<double>& positions) const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  positions = grippers_[side].positions;
+  return grippers_[side].state != GripperState::UNKNOWN;
+}
+
+bool GripperMonitor::getFingerEfforts(const RobotSide side, std::vector<double>& efforts) const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  efforts = grippers_[side].efforts;
+  return grippers_[side].state != GripperState::UNKNOWN;
+}
+
+int GripperMonitor::addCallback(const GripperStateCallback& callback)
+{
+  return callbacks_.add(callback);
+}
+
+void GripperMonitor::removeCallback(const int handle)
+{
+  callbacks_.remove(handle);
+}
+
+bool GripperMonitor::waitForState(const RobotSide side, const GripperState state, const ros::Duration& timeout)
+{
+  return state_informer_->waitForCondition([this, side, state]() { return getState(side) == state; }, timeout);
+}
+
+bool GripperMonitor::waitForGrasp(const RobotSide side, const ros::Duration& timeout)
+{
+  // the gripper may still be in the state of a previous grasp when this is called, so only a change of state ends the
+  // wait, unless an object is already grasped
+  std::shared_ptr<std::atomic<int> > result = std::make_shared<std::atomic<int> >(-1);
+  const int handle = addCallback([side, result](const RobotSide changed_side, const GripperState,
+                                                const GripperState state) {
+    if (changed_side == side && (state == GripperState::GRASPED || state == GripperState::CLOSED_EMPTY))
+    {
+      *result = static_cast<int>(state);
+    }
+  });
+  if (getState(side) == GripperState::GRASPED)
+  {
+    *result = static_cast<int>(GripperState::GRASPED);
+  }
+
+  state_informer_->waitForCondition([&result]() { return *result >= 0; }, timeout);
+  removeCallback(handle);
+  return *result == static_cast<int>(GripperState::GRASPED);
+}
+
+void GripperMonitor::setThresholds(const Thresholds& thresholds)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  thresholds_ = thresholds;
+  thresholds_.confirm_samples = std::max(1, thresholds_.confirm_samples);
+}
+
+GripperMonitor::Thresholds GripperMonitor::getThresholds() const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return thresholds_;
+}
+
+void GripperMonitor::jointStateCB(const sensor_msgs::JointState& msg)
+{
+  // the joint handles read the state that RobotStateInformer just updated from msg
+  GripperState previous[2] = { GripperState::UNKNOWN, GripperState::UNKNOWN };
+  GripperState current[2];
+  bool changed[2];
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (int side = LEFT; side <= RIGHT; ++side)
+    {
+      changed[side] = update(grippers_[side], previous[side]);
+      current[side] = grippers_[side].state;
+    }
+  }
+
+  // callbacks are called without the lock, they can query the monitor
+  for (int side = LEFT; side <= RIGHT; ++side)
+  {
+    if (changed[side])
+    {
+      callbacks_.call(static_cast<RobotSide>(side), previous[side], current[side]);
+    }
+  }
+}
+
+bool GripperMonitor::update(Gripper& gripper, GripperState& previous)
+{
+  if (gripper.joints.size() == 0)
+  {
+    return false;
+  }
+
+  previous = gripper.state;
+  if (!gripper.joints.getPositions(gripper.positions) || !gripper.joints.getEfforts(gripper.efforts))
+  {
+    gripper.state = GripperState::UNKNOWN;
+    gripper.candidate_samples = 0;
+    return previous != GripperState::UNKNOWN;
+  }
+  if (!gripper.joints.getVelocities(gripper.velocities))
+  {
+    gripper.velocities.assign(gripper.positions.size(), 0.0);
+  }
+
+  const double closure = meanAbsolute(gripper.positions);
+  const GripperState state = classify(gripper.state, gripper.grasp_closure, thresholds_, closure,
+                                      meanAbsolute(gripper.efforts), maxAbsolute(gripper.velocities));
+  if (state == gripper.state)
+  {
+    gripper.candidate_samples = 0;
+    return false;
+  }
+  if (state != gripper.candidate)
+  {
+    gripper.candidate = state;
+    gripper.candidate_samples = 0;
+  }
+  if (++gripper.candidate_samples < thresholds_.confirm_samples)
+  {
+    return false;
+  }
+
+  gripper.state = state;
+  gripper.candidate_samples = 0;
+  if (state == GripperState::GRASPED)
+  {
+    gripper.grasp_closure = closure;
+  }
+  return true;
+}
+
+GripperState GripperMonitor::classify(const GripperState state, const double grasp_closure,
+                                      const Thresholds& thresholds, const double closure, const double load,
+                                      const double speed)
+{
+  const bool held = state == GripperState::GRASPED || state == GripperState::SLIPPING;
+  const bool moving = speed > thresholds.settled_velocity;
+  const bool loaded = load >= thresholds.grasp_effort;
+
+  if (held && moving && closure > grasp_closure + thresholds.slip_position)
+  {
+    return GripperState::SLIPPING;
+  }
+  if (moving)
+  {
+    // fingers of a grasp move a little while they squeeze the object
+    return held && loaded ? state : GripperState::MOVING;
+  }
+  if (loaded)
+  {
+    return GripperState::GRASPED;
+  }
+  return closure >= thresholds.closed_position ? GripperState::CLOSED_EMPTY : GripperState::OPEN;
+}
@@ -0,0 +1,236 @@
+#include "tough_controller_interface/hand_jogger.h"
+#include <algorithm>
+
+namespace
+{
+// scales a vector down to a maximum norm
+inline Eigen::Vector3d clampNorm(const Eigen::Vector3d& vector, const double max_norm)
+{
+  const double norm = vector.norm();
+  return norm > max_norm ? Eigen::Vector3d(vector * (max_norm / norm)) : vector;
+}
+
+// rotation of angular_velocity * dt as a quaternion
+inline Eigen::Quaterniond integrateRotation(const Eigen::Vector3d& angular_velocity, const double dt)
+{
+  const double angle = angular_velocity.norm() * dt;
+  if (angle < 1e-12)
+  {
+    return Eigen::Quaterniond::Identity();
+  }
+  return Eigen::Quaterniond(Eigen::AngleAxisd(angle, angular_velocity.normalized()));
+}
+}  // namespace
+
+HandJogger::HandJogger(PoseReader reader, SetpointPublisher publisher, const double rate, const double horizon)
+  : reader_(reader)
+  , publisher_(publisher)
+  , period_(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(1.0 / rate)))
+  , horizon_(std::max(horizon, 1.0 / rate))
+  , commanded_linear_(Eigen::Vector3d::Zero())
+  , commanded_angular_(Eigen::Vector3d::Zero())
+  , running_(false)
+{
+}
+
+HandJogger::~HandJogger()
+{
+  stop();
+}
+
+bool HandJogger::start()
+{
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (running_)
+    {
+      return true;
+    }
+  }
+  // the previous loop was stopped, it only has to be joined
+  if (thread_.joinable())
+  {
+    thread_.join();
+  }
+
+  if (!readSetpoint())
+  {
+    ROS_WARN("Cannot jog, the pose of the hand is not available");
+    return false;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  linear_.setZero();
+  angular_.setZero();
+  commanded_linear_.setZero();
+  commanded_angular_.setZero();
+  running_ = true;
+  thread_ = std::thread(&HandJogger::jog, this);
+  return true;
+}
+
+void HandJogger::stop()
+{
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    running_ = false;
+  }
+  stop_condition_.notify_all();
+  if (!thread_.joinable())
+  {
+    return;
+  }
+  thread_.join();
+
+  // the last message ends a horizon ahead of the setpoint with the hand still moving
+  if (!linear_.isZero() || !angular_.isZero())
+  {
+    linear_.setZero();
+    angular_.setZero();
+    publishSetpoint(setpoint_position_, setpoint_orientation_);
+  }
+}
+
+bool HandJogger::isJogging() const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return running_;
+}
+
+void HandJogger::setVelocity(const geometry_msgs::Twist& velocity)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  commanded_linear_ = clampNorm(Eigen::Vector3d(velocity.linear.x, velocity.linear.y, velocity.linear.z),
+                                limits_.max_linear_speed);
+  commanded_angular_ = clampNorm(Eigen::Vector3d(velocity.angular.x, velocity.angular.y, velocity.angular.z),
+                                 limits_.max_angular_speed);
+  command_time_ = Clock::now();
+}
+
+void HandJogger::setLimits(const Limits& limits)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  limits_ = limits;
+  commanded_linear_ = clampNorm(commanded_linear_, limits_.max_linear_speed);
+  commanded_angular_ = clampNorm(commanded_angular_, limits_.max_angular_speed);
+}
+
+HandJogger::Limits HandJogger::getLimits() const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return limits_;
+}
+
+void HandJogger::jog()
+{
+  const double dt = std::chrono::duration<double>(period_).count();
+  Clock::time_point next = Clock::now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (running_)
+  {
+    next += period_;
+    if (stop_condition_.wait_until(lock, next, [this]() { return !running_; }))
+    {
+      break;
+    }
+    // the hand is read and the setpoint published without holding the lock
+    lock.unlock();
+    step(dt);
+    // ticks that were missed are skipped instead of being sent in a burst
+    next = std::max(next, Clock::now() - period_);
+    lock.lock();
+  }
+}
+
+void HandJogger::step(const double dt)
+{
+  Limits limits;
+  Eigen::Vector3d target_linear, target_angular;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    limits = limits_;
+    const bool expired =
+        std::chrono::duration<double>(Clock::now() - command_time_).count() > limits_.command_timeout;
+    target_linear = expired ? Eigen::Vector3d::Zero() : commanded_linear_;
+    target_angular = expired ? Eigen::Vector3d::Zero() : commanded_angular_;
+  }
+
+  // nothing to send while the hand stays at the last setpoint
+  const bool was_moving = !linear_.isZero() || !angular_.isZero();
+  if (!was_moving && target_linear.isZero() && target_angular.isZero())
+  {
+    return;
+  }
+  if (!was_moving && !readSetpoint())
+  {
+    return;
+  }
+
+  linear_ += clampNorm(target_linear - linear_, limits.max_linear_acceleration * dt);
+  angular_ += clampNorm(target_angular - angular_, limits.max_angular_acceleration * dt);
+  setpoint_position_ += linear_ * dt;
+  setpoint_orientation_ = (integrateRotation(angular_, dt) * setpoint_orientation_).normalized();
+
+  // the setpoint is kept close to the hand, it does not keep going when the arm cannot reach it
+  geometry_msgs::Pose measured;
+  if (reader_(measured))
+  {
+    const Eigen::Vector3d position(measured.position.x, measured.position.y, measured.position.z);
+    const Eigen::Vector3d lead = setpoint_position_ - position;
+    if (lead.norm() > limits.max_linear_lead)
+    {
+      setpoint_position_ = position + clampNorm(lead, limits.max_linear_lead);
+      linear_.setZero();
+    }
+
+    const Eigen::Quaterniond orientation =
+        Eigen::Quaterniond(measured.orientation.w, measured.orientation.x, measured.orientation.y,
+                           measured.orientation.z)
+            .normalized();
+    const double angle = orientation.angularDistance(setpoint_orientation_);
+    if (angle > limits.max_angular_lead)
+    {
+      setpoint_orientation_ = orientation.slerp(limits.max_angular_lead / angle, setpoint_orientation_);
+      angular_.setZero();
+    }
+  }
+
+  // the target is where the setpoint will be at the end of the horizon
+  publishSetpoint(setpoint_position_ + linear_ * horizon_,
+                  (integrateRotation(angular_, horizon_) * setpoint_orientation_).normalized());
+}
+
+bool HandJogger::readSetpoint()
+{
+  geometry_msgs::Pose pose;
+  if (!reader_(pose))
+  {
+    return false;
+  }
+  setpoint_position_ = Eigen::Vector3d(pose.position.x, pose.position.y, pose.position.z);
+  setpoint_orientation_ =
+      Eigen::Quaterniond(pose.orientation.w, pose.orientation.x, pose.orientation.y, pose.orientation.z).normalized();
+  return true;
+}
+
+void HandJogger::publishSetpoint(const Eigen::Vector3d& position, const Eigen::Quaterniond& orientation)
+{
+  geometry_msgs::Pose pose;
+  pose.position.x = position.x();
+  pose.position.y = position.y();
+  pose.position.z = position.z();
+  pose.orientation.w = orientation.w();
+  pose.orientation.x = orientation.x();
+  pose.orientation.y = orientation.y();
+  pose.orientation.z = orientation.z();
+
+  geometry_msgs::Twist velocity;
+  velocity.linear.x = linear_.x();
+  velocity.linear.y = linear_.y();
+  velocity.linear.z = linear_.z();
+  velocity.angular.x = angular_.x();
+  velocity.angular.y = angular_.y();
+  velocity.angular.z = angular_.z();
+
+  publisher_(pose, velocity, horizon_);
+}
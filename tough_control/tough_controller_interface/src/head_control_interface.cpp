@@ -1,36 +1,142 @@
 #include <tough_controller_interface/head_control_interface.h>
 #include <tf/transform_listener.h>
 #include <tough_common/robot_state.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
 
-HeadControlInterface::HeadControlInterface(ros::NodeHandle nh) : ToughControlInterface(nh)
+namespace
+{
+/**
+ * @brief Appends a trajectory point to every joint of a neck message. For robots known at compile time the number of
+ * neck joints is a constant and the loop is unrolled.
+ */
+struct AppendNeckTrajectoryPoint
+{
+  ihmc_msgs::NeckTrajectoryRosMessage& msg;
+  const float time;
+  const std::vector<float>& pos;
+
+  template <typename Traits>
+  void operator()(Traits) const
+  {
+    const int size = Traits::NUM_NECK_JOINTS == Eigen::Dynamic ? pos.size() : Traits::NUM_NECK_JOINTS;
+    for (int i = 0; i < size; i++)
+    {
+      ihmc_msgs::TrajectoryPoint1DRosMessage p;
+      ihmc_msgs::OneDoFJointTrajectoryRosMessage t;
+
+      p.time = time;
+      p.position = pos[i];
+      p.unique_id = msg.unique_id;
+      t.trajectory_points.push_back(p);
+      t.unique_id = msg.unique_id;
+      msg.joint_trajectory_messages.push_back(t);
+    }
+  }
+};
+
+// URDF link names have no leading slash
+std::string getLinkName(const std::string& frame)
+{
+  return !frame.empty() && frame[0] == '/' ? frame.substr(1) : frame;
+}
+}  // namespace
+
+HeadControlInterface::HeadControlInterface(ros::NodeHandle nh)
+  : ToughControlInterface(nh), look_at_rate_(10.0), look_at_deadband_(0.02), look_at_time_(0.5), look_at_running_(false)
 {
   neckTrajPublisher = nh_.advertise<ihmc_msgs::NeckTrajectoryRosMessage>(
       control_topic_prefix_ + TOUGH_COMMON_NAMES::NECK_TRAJECTORY_TOPIC, 1, true);
   headTrajPublisher = nh_.advertise<ihmc_msgs::HeadTrajectoryRosMessage>(
       control_topic_prefix_ + TOUGH_COMMON_NAMES::HEAD_TRAJECTORY_TOPIC, 1, true);
   NUM_NECK_JOINTS = rd_->getNumberOfNeckJoints();
+
+  // compile time joint counts are only used when they match the robot description
+  robot_type_ = rd_->getRobotType();
+  if (getRobotConstants(robot_type_).num_neck_joints != NUM_NECK_JOINTS)
+  {
+    robot_type_ = RobotType::UNKNOWN;
+  }
+  loadNeckLimits();
 }
 
 HeadControlInterface::~HeadControlInterface()
 {
+  // updates are published from their own thread, stop it before the publisher is destroyed
+  stopLookAt();
+}
+
+void HeadControlInterface::loadNeckLimits()
+{
+  const double inf = std::numeric_limits<double>::infinity();
+  neck_yaw_limits_ = std::make_pair(-inf, inf);
+  neck_pitch_limits_ = std::make_pair(-inf, inf);
+
+  // the neck joints are the joints from the head up to the chest, the ranges of joints about the same axis add up
+  const urdf::Model& model = rd_->getURDFModel();
+  const std::string chest = getLinkName(rd_->getTorsoFrame());
+  std::pair<double, double> yaw(0.0, 0.0);
+  std::pair<double, double> pitch(0.0, 0.0);
+  urdf::LinkConstSharedPtr link = model.getLink(getLinkName(TOUGH_COMMON_NAMES::ROBOT_HEAD_FRAME_TF));
+  while (link && link->name != chest)
+  {
+    urdf::JointConstSharedPtr joint = link->parent_joint;
+    if (!joint)
+    {
+      link.reset();
+      break;
+    }
+    if (joint->type == urdf::Joint::REVOLUTE || joint->type == urdf::Joint::CONTINUOUS)
+    {
+      double lower = -inf;
+      double upper = inf;
+      if (joint->type == urdf::Joint::REVOLUTE && joint->limits)
+      {
+        lower = joint->limits->lower;
+        upper = joint->limits->upper;
+      }
+      std::pair<double, double>* range = nullptr;
+      double direction = 0.0;
+      if (std::fabs(joint->axis.z) > 0.9)
+      {
+        range = &yaw;
+        direction = joint->axis.z;
+      }
+      else if (std::fabs(joint->axis.y) > 0.9)
+      {
+        range = &pitch;
+        direction = joint->axis.y;
+      }
+      if (range != nullptr)
+      {
+        range->first += direction > 0.0 ? lower : -upper;
+        range->second += direction > 0.0 ? upper : -lower;
+      }
+    }
+    link = model.getLink(joint->parent_link_name);
+  }
+
+  if (!link)
+  {
+    ROS_WARN("Neck joints between %s and %s are not in the URDF, look at orientations are not limited",
+             chest.c_str(), TOUGH_COMMON_NAMES::ROBOT_HEAD_FRAME_TF.c_str());
+    return;
+  }
+  neck_yaw_limits_ = yaw;
+  neck_pitch_limits_ = pitch;
 }
 
 void HeadControlInterface::appendNeckTrajectoryPoint(ihmc_msgs::NeckTrajectoryRosMessage& msg, float time,
                                                      std::vector<float> pos)
 {
-  for (int i = 0; i < NUM_NECK_JOINTS; i++)
+  if (pos.size() != NUM_NECK_JOINTS)
   {
-    ihmc_msgs::TrajectoryPoint1DRosMessage p;
-    ihmc_msgs::OneDoFJointTrajectoryRosMessage t;
-    t.trajectory_points.clear();
-
-    p.time = time;
-    p.position = pos[i];
-    p.unique_id = HeadControlInterface::id_;
-    t.trajectory_points.push_back(p);
-    t.unique_id = HeadControlInterface::id_;
-    msg.joint_trajectory_messages.push_back(t);
+    ROS_WARN("Check number of trajectory points");
+    return;
   }
+  dispatchRobotTraits(robot_type_, AppendNeckTrajectoryPoint{ msg, time, pos });
 }
 
 void HeadControlInterface::moveHead(const float roll, const float pitch, const float yaw, const float time)
@@ -54,8 +160,7 @@ void HeadControlInterface::moveHead(const geometry_msgs::Quaternion& quaternion,
 
   data.orientation = quaternion;
 
-  HeadControlInterface::id_++;
-  msg.unique_id = HeadControlInterface::id_;
+  msg.unique_id = ++HeadControlInterface::id_;
   msg.execution_mode = msg.OVERRIDE;
 
   msg.taskspace_trajectory_points.clear();
@@ -75,8 +180,7 @@ void HeadControlInterface::moveHead(const std::vector<std::vector<float> >& traj
   reference_frame.data_reference_frame_id = rd_->getPelvisZUPFrameHash();        // Pelvis frame
   msg.frame_information = reference_frame;
 
-  HeadControlInterface::id_++;
-  msg.unique_id = HeadControlInterface::id_;
+  msg.unique_id = ++HeadControlInterface::id_;
   msg.execution_mode = msg.OVERRIDE;
 
   msg.taskspace_trajectory_points.clear();
@@ -106,8 +210,7 @@ void HeadControlInterface::moveNeckJoints(const std::vector<std::vector<float> >
 {
   ihmc_msgs::NeckTrajectoryRosMessage msg;
 
-  HeadControlInterface::id_++;
-  msg.unique_id = HeadControlInterface::id_;
+  msg.unique_id = ++HeadControlInterface::id_;
 
   // Add all neck trajectory points to the trajectory message
   for (int i = 0; i < neck_pose.size(); i++)
@@ -134,3 +237,157 @@ int HeadControlInterface::getNumNeckJoints() const
 {
   return NUM_NECK_JOINTS;
 }
+
+bool HeadControlInterface::getLookAtOrientation(const geometry_msgs::PointStamped& target,
+                                                geometry_msgs::Quaternion& orientation)
+{
+  geometry_msgs::PointStamped target_world;
+  geometry_msgs::Pose head_pose;
+  geometry_msgs::Pose chest_pose;
+  if (!state_informer_->transformPoint(target, target_world, TOUGH_COMMON_NAMES::WORLD_TF) ||
+      !state_informer_->getCurrentPose(TOUGH_COMMON_NAMES::ROBOT_HEAD_FRAME_TF, head_pose) ||
+      !state_informer_->getCurrentPose(rd_->getTorsoFrame(), chest_pose))
+  {
+    return false;
+  }
+
+  // the neck limits are relative to the chest, the direction of the target is expressed in the chest frame
+  tf::Quaternion chest;
+  tf::quaternionMsgToTF(chest_pose.orientation, chest);
+  const tf::Vector3 direction =
+      tf::quatRotate(chest.inverse(), tf::Vector3(target_world.point.x - head_pose.position.x,
+                                                  target_world.point.y - head_pose.position.y,
+                                                  target_world.point.z - head_pose.position.z));
+  const double horizontal = std::sqrt(direction.x() * direction.x() + direction.y() * direction.y());
+  if (horizontal < 1e-6 && std::fabs(direction.z()) < 1e-6)
+  {
+    return false;
+  }
+
+  // x axis of the head points at the target, positive pitch looks down
+  const double yaw = std::atan2(direction.y(), direction.x());
+  const double pitch = std::atan2(-direction.z(), horizontal);
+  const double reachable_yaw = std::min(std::max(yaw, neck_yaw_limits_.first), neck_yaw_limits_.second);
+  const double reachable_pitch = std::min(std::max(pitch, neck_pitch_limits_.first), neck_pitch_limits_.second);
+  if (reachable_yaw != yaw || reachable_pitch != pitch)
+  {
+    ROS_WARN_THROTTLE(1.0, "Look at target is out of the range of the neck. Yaw %.2f and pitch %.2f are limited to "
+                           "%.2f and %.2f",
+                      yaw, pitch, reachable_yaw, reachable_pitch);
+  }
+
+  tf::Quaternion q;
+  q.setRPY(0.0, reachable_pitch, reachable_yaw);
+  tf::quaternionTFToMsg(chest * q, orientation);
+  return true;
+}
+
+bool HeadControlInterface::lookAt(const geometry_msgs::PointStamped& target, const float time)
+{
+  geometry_msgs::Quaternion orientation;
+  if (!getLookAtOrientation(target, orientation))
+  {
+    ROS_WARN("Cannot look at the point, it could not be located in %s frame", target.header.frame_id.c_str());
+    return false;
+  }
+  publishHeadOrientation(orientation, time, rd_->getWorldFrameHash());
+  return true;
+}
+
+void HeadControlInterface::startLookAt(const geometry_msgs::PointStamped& target, const double rate,
+                                       const double deadband, const double time)
+{
+  stopLookAt();
+
+  std::lock_guard<std::mutex> guard(look_at_mutex_);
+  look_at_target_ = target;
+  look_at_rate_ = rate > 0.0 ? rate : 10.0;
+  look_at_deadband_ = std::fabs(deadband);
+  look_at_time_ = std::max(time, 1.0 / look_at_rate_);
+  look_at_running_ = true;
+  look_at_thread_ = std::thread(&HeadControlInterface::trackLookAtTarget, this);
+}
+
+void HeadControlInterface::startLookAt(const std::string& frame, const double rate, const double deadband,
+                                       const double time)
+{
+  geometry_msgs::PointStamped origin;
+  origin.header.frame_id = frame;
+  startLookAt(origin, rate, deadband, time);
+}
+
+void HeadControlInterface::stopLookAt()
+{
+  {
+    std::lock_guard<std::mutex> guard(look_at_mutex_);
+    look_at_running_ = false;
+  }
+  look_at_condition_.notify_all();
+  if (look_at_thread_.joinable())
+  {
+    look_at_thread_.join();
+  }
+}
+
+bool HeadControlInterface::isLookingAt() const
+{
+  std::lock_guard<std::mutex> guard(look_at_mutex_);
+  return look_at_running_;
+}
+
+void HeadControlInterface::trackLookAtTarget()
+{
+  std::unique_lock<std::mutex> lock(look_at_mutex_);
+  const geometry_msgs::PointStamped target = look_at_target_;
+  const std::chrono::nanoseconds period =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(1.0 / look_at_rate_));
+  const double deadband = look_at_deadband_;
+  const float time = look_at_time_;
+  const int frame_hash = rd_->getWorldFrameHash();
+
+  bool sent = false;
+  tf::Quaternion last_sent;
+  std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+  while (look_at_running_)
+  {
+    // the target and the head are located without holding the lock
+    lock.unlock();
+    geometry_msgs::Quaternion orientation;
+    if (getLookAtOrientation(target, orientation))
+    {
+      tf::Quaternion q;
+      tf::quaternionMsgToTF(orientation, q);
+      if (!sent || last_sent.angleShortestPath(q) > deadband)
+      {
+        publishHeadOrientation(orientation, time, frame_hash);
+        last_sent = q;
+        sent = true;
+      }
+    }
+    else
+    {
+      ROS_WARN_THROTTLE(1.0, "Cannot locate the look at target in %s frame", target.header.frame_id.c_str());
+    }
+    lock.lock();
+
+    next = std::max(next + period, std::chrono::steady_clock::now());
+    look_at_condition_.wait_until(lock, next, [this]() { return !look_at_running_; });
+  }
+}
+
+void HeadControlInterface::publishHeadOrientation(const geometry_msgs::Quaternion& orientation, const float time,
+                                                  const int frame_hash)
+{
+  ihmc_msgs::HeadTrajectoryRosMessage msg;
+  msg.frame_information.trajectory_reference_frame_id = frame_hash;
+  msg.frame_information.data_reference_frame_id = frame_hash;
+
+  ihmc_msgs::SO3TrajectoryPointRosMessage data;
+  data.orientation = orientation;
+  data.time = time;
+  msg.taskspace_trajectory_points.push_back(data);
+
+  msg.unique_id = ++HeadControlInterface::id_;
+  msg.execution_mode = msg.OVERRIDE;
+  headTrajPublisher.publish(msg);
+}
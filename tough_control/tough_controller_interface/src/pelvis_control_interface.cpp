@@ -7,6 +7,12 @@ PelvisControlInterface::PelvisControlInterface(ros::NodeHandle nh) : ToughContro
 
   homePositionPublisher_ =
       nh_.advertise<ihmc_msgs::GoHomeRosMessage>(control_topic_prefix_ + TOUGH_COMMON_NAMES::GO_HOME_TOPIC, 1, true);
+
+  // the pelvis is moved by both legs
+  std::vector<std::string> right_leg_joint_names;
+  rd_->getLegJointNames(LEFT, leg_joint_names_);
+  rd_->getLegJointNames(RIGHT, right_leg_joint_names);
+  leg_joint_names_.insert(leg_joint_names_.end(), right_leg_joint_names.begin(), right_leg_joint_names.end());
 }
 
 PelvisControlInterface::~PelvisControlInterface()
@@ -43,9 +49,15 @@ void PelvisControlInterface::controlPelvisHeight(float height, float duration)
   publishPelvisMessage(msg);
 }
 
-void PelvisControlInterface::publishPelvisMessage(const ihmc_msgs::PelvisHeightTrajectoryRosMessage& msg) const
+void PelvisControlInterface::publishPelvisMessage(const ihmc_msgs::PelvisHeightTrajectoryRosMessage& msg)
 {
   this->pelvisHeightPublisher_.publish(msg);
+  command_tracer_->recordPublish("pelvis_height", msg.unique_id);
+
+  // pelvis height is reached by moving the legs, completion is detected when the legs stop
+  const double duration =
+      msg.taskspace_trajectory_points.empty() ? 0.0 : msg.taskspace_trajectory_points.back().time;
+  trackCommand(msg.unique_id, leg_joint_names_, std::vector<double>(), duration);
 }
 
 void PelvisControlInterface::resetPose(float time)
@@ -57,6 +69,8 @@ void PelvisControlInterface::resetPose(float time)
   go_home.unique_id = PelvisControlInterface::id_++;
 
   homePositionPublisher_.publish(go_home);
+  command_tracer_->recordPublish("go_home", go_home.unique_id);
+  trackCommand(go_home.unique_id, leg_joint_names_, std::vector<double>(), time);
 }
 
 bool PelvisControlInterface::getJointSpaceState(std::vector<double>& joints, RobotSide side)
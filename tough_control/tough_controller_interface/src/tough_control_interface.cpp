@@ -1,8 +1,10 @@
 #include "tough_controller_interface/tough_control_interface.h"
+#include <algorithm>
 
-long ToughControlInterface::id_ = 1;
+std::atomic<long> ToughControlInterface::id_(1);
 
-ToughControlInterface::ToughControlInterface(ros::NodeHandle nh): nh_(nh)
+ToughControlInterface::ToughControlInterface(ros::NodeHandle nh)
+  : nh_(nh), trajectory_decimation_tolerance_(0.0), last_command_id_(0)
 {
   if (!nh.getParam(TOUGH_COMMON_NAMES::ROBOT_NAME_PARAM, robot_name_))
   {
@@ -16,8 +18,65 @@ ToughControlInterface::ToughControlInterface(ros::NodeHandle nh): nh_(nh)
 
   state_informer_ = RobotStateInformer::getRobotStateInformer(nh_);
   rd_ = RobotDescription::getRobotDescription(nh_);
+  command_monitor_ = CommandMonitor::getCommandMonitor(nh_);
+  command_tracer_ = CommandTracer::getCommandTracer();
 }
 
 ToughControlInterface::~ToughControlInterface()
 {
 }
+
+void ToughControlInterface::setTrajectoryDecimationTolerance(const double tolerance)
+{
+  trajectory_decimation_tolerance_ = std::max(0.0, tolerance);
+}
+
+double ToughControlInterface::getTrajectoryDecimationTolerance() const
+{
+  return trajectory_decimation_tolerance_;
+}
+
+CommandFuture ToughControlInterface::trackCommand(const long unique_id, const std::vector<std::string>& joint_names,
+                                                  const std::vector<double>& targets, const double duration,
+                                                  const bool overrides)
+{
+  last_command_id_ = unique_id;
+  return command_monitor_->track(unique_id, joint_names, targets, duration, overrides);
+}
+
+const trajectory_msgs::JointTrajectory& ToughControlInterface::decimate(const trajectory_msgs::JointTrajectory& traj,
+                                                                       trajectory_msgs::JointTrajectory& decimated) const
+{
+  if (trajectory_decimation_tolerance_ <= 0.0)
+  {
+    return traj;
+  }
+  size_t removed = decimateTrajectory(traj, trajectory_decimation_tolerance_, decimated);
+  ROS_INFO("Removed %lu of %lu trajectory points", removed, traj.points.size());
+  return decimated;
+}
+
+long ToughControlInterface::getLastCommandId() const
+{
+  return last_command_id_.load();
+}
+
+bool ToughControlInterface::getCommandFuture(const long unique_id, CommandFuture& future) const
+{
+  return command_monitor_->getFuture(unique_id, future);
+}
+
+bool ToughControlInterface::addCommandCallback(const long unique_id, const CommandCallback& callback)
+{
+  return command_monitor_->addCallback(unique_id, callback);
+}
+
+bool ToughControlInterface::waitForCommand(const long unique_id, const ros::Duration& timeout)
+{
+  return command_monitor_->waitForCommand(unique_id, timeout);
+}
+
+bool ToughControlInterface::waitForLastCommand(const ros::Duration& timeout)
+{
+  return waitForCommand(last_command_id_.load(), timeout);
+}
@@ -0,0 +1,139 @@
+#include "tough_controller_interface/trajectory_decimation.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace
+{
+/**
+ * @brief Parameter used to interpolate between waypoints, time_from_start when it is strictly increasing and the
+ * waypoint index otherwise.
+ *
+ * @param timed             [output] true when the parameter is time_from_start
+ */
+std::vector<double> getInterpolationParameter(const trajectory_msgs::JointTrajectory& traj, bool& timed)
+{
+  std::vector<double> parameter(traj.points.size());
+  bool increasing = true;
+  for (size_t i = 0; i < traj.points.size(); ++i)
+  {
+    parameter[i] = traj.points[i].time_from_start.toSec();
+    increasing = increasing && (i == 0 || parameter[i] > parameter[i - 1]);
+  }
+  if (!increasing)
+  {
+    for (size_t i = 0; i < parameter.size(); ++i)
+    {
+      parameter[i] = i;
+    }
+  }
+  timed = increasing;
+  return parameter;
+}
+
+inline double getVelocity(const trajectory_msgs::JointTrajectoryPoint& point, const size_t joint)
+{
+  return point.velocities.size() == point.positions.size() ? point.velocities[joint] : 0.0;
+}
+
+/**
+ * @brief Largest deviation of any joint of the waypoints between first and last from the segment between first and
+ * last, a cubic Hermite segment when timed and a line otherwise
+ *
+ * @param farthest          [output] index of the waypoint with the largest deviation
+ */
+double getMaxDeviation(const trajectory_msgs::JointTrajectory& traj, const std::vector<double>& parameter,
+                       const bool timed, const size_t first, const size_t last, size_t& farthest)
+{
+  const trajectory_msgs::JointTrajectoryPoint& start = traj.points[first];
+  const trajectory_msgs::JointTrajectoryPoint& end = traj.points[last];
+  const double span = parameter[last] - parameter[first];
+
+  double max_deviation = 0.0;
+  farthest = first;
+  for (size_t i = first + 1; i < last; ++i)
+  {
+    const std::vector<double>& positions = traj.points[i].positions;
+    const double s = (parameter[i] - parameter[first]) / span;
+    const double s2 = s * s, s3 = s2 * s;
+    // Hermite basis, the velocity terms are scaled by the duration of the segment
+    const double h00 = timed ? 2 * s3 - 3 * s2 + 1 : 1.0 - s;
+    const double h01 = timed ? -2 * s3 + 3 * s2 : s;
+    const double h10 = timed ? (s3 - 2 * s2 + s) * span : 0.0;
+    const double h11 = timed ? (s3 - s2) * span : 0.0;
+    for (size_t j = 0; j < positions.size(); ++j)
+    {
+      const double interpolated = h00 * start.positions[j] + h01 * end.positions[j] + h10 * getVelocity(start, j) +
+                                  h11 * getVelocity(end, j);
+      double deviation = std::fabs(positions[j] - interpolated);
+      if (deviation > max_deviation)
+      {
+        max_deviation = deviation;
+        farthest = i;
+      }
+    }
+  }
+  return max_deviation;
+}
+}  // namespace
+
+size_t decimateTrajectory(const trajectory_msgs::JointTrajectory& traj, const double tolerance,
+                          trajectory_msgs::JointTrajectory& result)
+{
+  result.header = traj.header;
+  result.joint_names = traj.joint_names;
+  result.points.clear();
+
+  const size_t num_points = traj.points.size();
+  const size_t num_joints = traj.joint_names.size();
+  bool valid = num_points > 2;
+  for (size_t i = 0; i < num_points && valid; ++i)
+  {
+    valid = traj.points[i].positions.size() == num_joints;
+  }
+  if (!valid)
+  {
+    // nothing to remove, or positions that can not be compared
+    result.points = traj.points;
+    return 0;
+  }
+
+  bool timed;
+  const std::vector<double> parameter = getInterpolationParameter(traj, timed);
+  std::vector<bool> keep(num_points, false);
+  keep.front() = true;
+  keep.back() = true;
+
+  // explicit stack instead of recursion, dense cartesian paths can have thousands of waypoints
+  std::vector<std::pair<size_t, size_t> > segments;
+  segments.push_back(std::make_pair(0, num_points - 1));
+  while (!segments.empty())
+  {
+    const size_t first = segments.back().first;
+    const size_t last = segments.back().second;
+    segments.pop_back();
+    if (last - first < 2)
+    {
+      continue;
+    }
+
+    size_t farthest;
+    if (getMaxDeviation(traj, parameter, timed, first, last, farthest) > tolerance)
+    {
+      keep[farthest] = true;
+      segments.push_back(std::make_pair(first, farthest));
+      segments.push_back(std::make_pair(farthest, last));
+    }
+  }
+
+  result.points.reserve(std::count(keep.begin(), keep.end(), true));
+  for (size_t i = 0; i < num_points; ++i)
+  {
+    if (keep[i])
+    {
+      result.points.push_back(traj.points[i]);
+    }
+  }
+  return num_points - result.points.size();
+}
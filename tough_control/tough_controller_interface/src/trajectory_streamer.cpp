@@ -0,0 +1,139 @@
+#include "tough_controller_interface/trajectory_streamer.h"
+#include <chrono>
+
+namespace
+{
+// ros::Time may be simulated, the stream checks the time in small slices instead of sleeping until the deadline
+const std::chrono::milliseconds WAIT_SLICE(10);
+}  // namespace
+
+const int TrajectoryStreamer::OVERRIDE;
+const int TrajectoryStreamer::QUEUE;
+
+TrajectoryStreamer::TrajectoryStreamer(ChunkPublisher publisher)
+  : publisher_(publisher), lookahead_(1.0), cancelled_(false), streaming_(false)
+{
+}
+
+TrajectoryStreamer::~TrajectoryStreamer()
+{
+  cancel();
+}
+
+bool TrajectoryStreamer::start(const trajectory_msgs::JointTrajectory& traj, const size_t chunk_size,
+                               const double lookahead)
+{
+  std::lock_guard<std::mutex> control(control_mutex_);
+  stop();
+  if (traj.points.empty() || chunk_size == 0)
+  {
+    ROS_WARN("Nothing to stream, the trajectory is empty or chunk size is zero");
+    return false;
+  }
+
+  trajectory_ = traj;
+  lookahead_ = lookahead;
+  chunk_starts_.clear();
+  for (size_t start = 0; start < traj.points.size(); start += chunk_size)
+  {
+    chunk_starts_.push_back(start);
+  }
+
+  trajectory_msgs::JointTrajectory chunk;
+  getChunk(0, chunk);
+  const ros::Time start_time = ros::Time::now();
+  long message_id = publisher_(chunk, OVERRIDE, 0);
+  if (message_id == 0)
+  {
+    return false;
+  }
+
+  if (chunk_starts_.size() > 1)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    cancelled_ = false;
+    streaming_ = true;
+    thread_ = std::thread(&TrajectoryStreamer::streamChunks, this, start_time, message_id);
+  }
+  ROS_INFO("Streaming %lu trajectory points in %lu chunks", traj.points.size(), chunk_starts_.size());
+  return true;
+}
+
+void TrajectoryStreamer::cancel()
+{
+  std::lock_guard<std::mutex> control(control_mutex_);
+  stop();
+}
+
+void TrajectoryStreamer::stop()
+{
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    cancelled_ = true;
+  }
+  cancel_condition_.notify_all();
+  if (thread_.joinable())
+  {
+    thread_.join();
+  }
+}
+
+bool TrajectoryStreamer::isStreaming() const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return streaming_;
+}
+
+void TrajectoryStreamer::getChunk(const size_t chunk, trajectory_msgs::JointTrajectory& result) const
+{
+  const size_t first = chunk_starts_[chunk];
+  const size_t last = chunk + 1 < chunk_starts_.size() ? chunk_starts_[chunk + 1] : trajectory_.points.size();
+
+  result.header = trajectory_.header;
+  result.joint_names = trajectory_.joint_names;
+  result.points.assign(trajectory_.points.begin() + first, trajectory_.points.begin() + last);
+
+  // queued chunks start when the previous chunk ends
+  if (first > 0)
+  {
+    const ros::Duration previous_end = trajectory_.points[first - 1].time_from_start;
+    for (auto& point : result.points)
+    {
+      point.time_from_start -= previous_end;
+    }
+  }
+}
+
+void TrajectoryStreamer::streamChunks(const ros::Time start_time, long previous_message_id)
+{
+  for (size_t chunk = 1; chunk < chunk_starts_.size(); ++chunk)
+  {
+    // publish the chunk lookahead seconds before the previous one ends
+    const ros::Time due =
+        start_time + trajectory_.points[chunk_starts_[chunk] - 1].time_from_start - ros::Duration(lookahead_);
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (!cancelled_ && ros::ok() && ros::Time::now() < due)
+      {
+        cancel_condition_.wait_for(lock, WAIT_SLICE);
+      }
+      if (cancelled_ || !ros::ok())
+      {
+        ROS_INFO("Trajectory stream cancelled, %lu of %lu chunks were sent", chunk, chunk_starts_.size());
+        break;
+      }
+    }
+
+    trajectory_msgs::JointTrajectory points;
+    getChunk(chunk, points);
+    previous_message_id = publisher_(points, QUEUE, previous_message_id);
+    if (previous_message_id == 0)
+    {
+      ROS_ERROR("Could not publish chunk %lu of the trajectory stream", chunk);
+      break;
+    }
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  streaming_ = false;
+}
@@ -1,4 +1,26 @@
 #include "tough_controller_interface/wholebody_control_interface.h"
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+void poseToSE3TrajectoryPoint(const geometry_msgs::Pose& pose, const float time, const long unique_id,
+                              ihmc_msgs::SE3TrajectoryPointRosMessage& point)
+{
+  point.position.x = pose.position.x;
+  point.position.y = pose.position.y;
+  point.position.z = pose.position.z;
+  point.orientation = pose.orientation;
+  point.time = time;
+  point.unique_id = unique_id;
+}
+
+void setFrameInformation(const int frame_hash, ihmc_msgs::FrameInformationRosMessage& frame_information)
+{
+  frame_information.trajectory_reference_frame_id = frame_hash;
+  frame_information.data_reference_frame_id = frame_hash;
+}
+}  // namespace
 
 WholebodyControlInterface::WholebodyControlInterface(ros::NodeHandle& nh)
   : ToughControlInterface(nh), chestController_(nh), armController_(nh)
@@ -9,6 +31,18 @@ WholebodyControlInterface::WholebodyControlInterface(ros::NodeHandle& nh)
   rd_->getLeftArmJointNames(left_arm_joint_names_);
   rd_->getRightArmJointNames(right_arm_joint_names_);
   rd_->getChestJointNames(chest_joint_names_);
+  rd_->getLegJointNames(LEFT, left_leg_joint_names_);
+  rd_->getLegJointNames(RIGHT, right_leg_joint_names_);
+
+  using namespace std::placeholders;
+  streamer_.reset(new TrajectoryStreamer(
+      std::bind(&WholebodyControlInterface::publishTrajectoryChunk, this, _1, _2, _3)));
+}
+
+WholebodyControlInterface::~WholebodyControlInterface()
+{
+  // the stream publishes from its own thread, stop it before the publisher is destroyed
+  streamer_.reset();
 }
 
 bool WholebodyControlInterface::getJointSpaceState(std::vector<double>& joints, RobotSide side)
@@ -31,18 +65,222 @@ void WholebodyControlInterface::executeTrajectory(const moveit_msgs::RobotTrajec
 
 void WholebodyControlInterface::executeTrajectory(const trajectory_msgs::JointTrajectory& traj)
 {
+  const CommandTracer::Clock::time_point start = CommandTracer::Clock::now();
+  // chunks queued after this trajectory would be chained to messages it overrode
+  streamer_->cancel();
+
   ihmc_msgs::WholeBodyTrajectoryRosMessage wholeBodyMsg;
+  initializeWholebodyMessage(wholeBodyMsg);
+  trajectory_msgs::JointTrajectory decimated;
+  parseTrajectory(decimate(traj, decimated), wholeBodyMsg);
+
+  std::lock_guard<std::mutex> guard(publish_mutex_);
+  m_wholebodyPub.publish(wholeBodyMsg);
+  command_tracer_->recordPublish("whole_body_trajectory", wholeBodyMsg.unique_id, traj.joint_names, start);
+
+  if (!traj.points.empty())
+  {
+    trackCommand(wholeBodyMsg.unique_id, traj.joint_names, traj.points.back().positions,
+                 traj.points.back().time_from_start.toSec());
+  }
+}
+
+bool WholebodyControlInterface::moveCoordinated(const CoordinatedMotion& motion, const float time)
+{
+  const CommandTracer::Clock::time_point start = CommandTracer::Clock::now();
+  ihmc_msgs::WholeBodyTrajectoryRosMessage wholeBodyMsg;
+  if (!generateCoordinatedMessage(motion, time, wholeBodyMsg))
+  {
+    return false;
+  }
+  std::lock_guard<std::mutex> guard(publish_mutex_);
+  m_wholebodyPub.publish(wholeBodyMsg);
+
+  // only the chains that are moved are watched, the pelvis is moved by both legs
+  std::vector<std::string> joint_names;
+  if (motion.move_chest)
+  {
+    joint_names.insert(joint_names.end(), chest_joint_names_.begin(), chest_joint_names_.end());
+  }
+  if (!motion.left_arm_joints.empty() || motion.move_left_hand)
+  {
+    joint_names.insert(joint_names.end(), left_arm_joint_names_.begin(), left_arm_joint_names_.end());
+  }
+  if (!motion.right_arm_joints.empty() || motion.move_right_hand)
+  {
+    joint_names.insert(joint_names.end(), right_arm_joint_names_.begin(), right_arm_joint_names_.end());
+  }
+  if (motion.move_pelvis || motion.move_left_foot)
+  {
+    joint_names.insert(joint_names.end(), left_leg_joint_names_.begin(), left_leg_joint_names_.end());
+  }
+  if (motion.move_pelvis || motion.move_right_foot)
+  {
+    joint_names.insert(joint_names.end(), right_leg_joint_names_.begin(), right_leg_joint_names_.end());
+  }
+  command_tracer_->recordPublish("whole_body_trajectory", wholeBodyMsg.unique_id, joint_names, start);
+  trackCommand(wholeBodyMsg.unique_id, joint_names, std::vector<double>(), time);
+  return true;
+}
+
+bool WholebodyControlInterface::generateCoordinatedMessage(const CoordinatedMotion& motion, const float time,
+                                                           ihmc_msgs::WholeBodyTrajectoryRosMessage& wholeBodyMsg)
+{
+  if ((!motion.left_arm_joints.empty() && motion.left_arm_joints.size() != left_arm_joint_names_.size()) ||
+      (!motion.right_arm_joints.empty() && motion.right_arm_joints.size() != right_arm_joint_names_.size()))
+  {
+    ROS_ERROR("Arm joint positions do not match the number of arm joints");
+    return false;
+  }
 
   initializeWholebodyMessage(wholeBodyMsg);
-  parseTrajectory(traj, wholeBodyMsg);
+  bool has_target = false;
+
+  // arms in joint space, hands in task space when the joints are not given
+  const std::vector<double>* arm_joints[] = { &motion.left_arm_joints, &motion.right_arm_joints };
+  const bool move_hand[] = { motion.move_left_hand, motion.move_right_hand };
+  const geometry_msgs::Pose* hand_pose[] = { &motion.left_hand_pose, &motion.right_hand_pose };
+  ihmc_msgs::ArmTrajectoryRosMessage* arm_msg[] = { &wholeBodyMsg.left_arm_trajectory_message,
+                                                    &wholeBodyMsg.right_arm_trajectory_message };
+  ihmc_msgs::HandTrajectoryRosMessage* hand_msg[] = { &wholeBodyMsg.left_hand_trajectory_message,
+                                                      &wholeBodyMsg.right_hand_trajectory_message };
+  const RobotSide sides[] = { LEFT, RIGHT };
+  for (int i = 0; i < 2; ++i)
+  {
+    if (!arm_joints[i]->empty())
+    {
+      armController_.setupArmMessage(sides[i], *arm_msg[i]);
+      armController_.appendTrajectoryPoint(*arm_msg[i], time, *arm_joints[i]);
+      has_target = true;
+    }
+    else if (move_hand[i])
+    {
+      ihmc_msgs::SE3TrajectoryPointRosMessage point;
+      poseToSE3TrajectoryPoint(*hand_pose[i], time, id_++, point);
+      hand_msg[i]->taskspace_trajectory_points.push_back(point);
+      setFrameInformation(motion.hand_frame_hash, hand_msg[i]->frame_information);
+      hand_msg[i]->unique_id = id_++;
+      has_target = true;
+    }
+  }
+
+  if (motion.move_chest)
+  {
+    chestController_.setupFrameAndMode(wholeBodyMsg.chest_trajectory_message);
+    chestController_.appendChestTrajectoryPoint(motion.chest_orientation, wholeBodyMsg.chest_trajectory_message, time);
+    has_target = true;
+  }
+
+  if (motion.move_pelvis)
+  {
+    ihmc_msgs::PelvisTrajectoryRosMessage& pelvis = wholeBodyMsg.pelvis_trajectory_message;
+    ihmc_msgs::SE3TrajectoryPointRosMessage point;
+    poseToSE3TrajectoryPoint(motion.pelvis_pose, time, id_++, point);
+    pelvis.taskspace_trajectory_points.push_back(point);
+    setFrameInformation(rd_->getWorldFrameHash(), pelvis.frame_information);
+    pelvis.execution_mode = ihmc_msgs::PelvisTrajectoryRosMessage::OVERRIDE;
+    pelvis.unique_id = id_++;
+    has_target = true;
+  }
+
+  const bool move_foot[] = { motion.move_left_foot, motion.move_right_foot };
+  const geometry_msgs::Pose* foot_pose[] = { &motion.left_foot_pose, &motion.right_foot_pose };
+  ihmc_msgs::FootTrajectoryRosMessage* foot_msg[] = { &wholeBodyMsg.left_foot_trajectory_message,
+                                                      &wholeBodyMsg.right_foot_trajectory_message };
+  for (int i = 0; i < 2; ++i)
+  {
+    if (move_foot[i])
+    {
+      ihmc_msgs::SE3TrajectoryPointRosMessage point;
+      poseToSE3TrajectoryPoint(*foot_pose[i], time, id_++, point);
+      foot_msg[i]->taskspace_trajectory_points.push_back(point);
+      setFrameInformation(rd_->getWorldFrameHash(), foot_msg[i]->frame_information);
+      foot_msg[i]->unique_id = id_++;
+      has_target = true;
+    }
+  }
+
+  if (!has_target)
+  {
+    ROS_WARN("Coordinated motion does not move any part of the robot");
+  }
+  return has_target;
+}
+
+bool WholebodyControlInterface::streamTrajectory(const trajectory_msgs::JointTrajectory& traj, const size_t chunk_size,
+                                                 const double lookahead)
+{
+  trajectory_msgs::JointTrajectory decimated;
+  return streamer_->start(decimate(traj, decimated), chunk_size, lookahead);
+}
+
+void WholebodyControlInterface::cancelTrajectoryStream()
+{
+  streamer_->cancel();
+}
+
+bool WholebodyControlInterface::isTrajectoryStreaming() const
+{
+  return streamer_->isStreaming();
+}
+
+long WholebodyControlInterface::publishTrajectoryChunk(const trajectory_msgs::JointTrajectory& chunk,
+                                                       const int execution_mode, const long previous_message_id)
+{
+  ihmc_msgs::WholeBodyTrajectoryRosMessage wholeBodyMsg;
+  initializeWholebodyMessage(wholeBodyMsg);
+  parseTrajectory(chunk, wholeBodyMsg);
+
+  std::lock_guard<std::mutex> guard(publish_mutex_);
+  // each part of a queued chunk is chained to the same part of the previous chunk
+  if (execution_mode == TrajectoryStreamer::OVERRIDE)
+  {
+    stream_chest_id_ = stream_left_arm_id_ = stream_right_arm_id_ = 0;
+  }
+  ihmc_msgs::ChestTrajectoryRosMessage& chest = wholeBodyMsg.chest_trajectory_message;
+  ihmc_msgs::ArmTrajectoryRosMessage& left_arm = wholeBodyMsg.left_arm_trajectory_message;
+  ihmc_msgs::ArmTrajectoryRosMessage& right_arm = wholeBodyMsg.right_arm_trajectory_message;
+  if (!chest.taskspace_trajectory_points.empty())
+  {
+    chest.execution_mode = execution_mode;
+    chest.previous_message_id = stream_chest_id_;
+    stream_chest_id_ = chest.unique_id;
+  }
+  if (left_arm.unique_id != 0)
+  {
+    left_arm.execution_mode = execution_mode;
+    left_arm.previous_message_id = stream_left_arm_id_;
+    stream_left_arm_id_ = left_arm.unique_id;
+  }
+  if (right_arm.unique_id != 0)
+  {
+    right_arm.execution_mode = execution_mode;
+    right_arm.previous_message_id = stream_right_arm_id_;
+    stream_right_arm_id_ = right_arm.unique_id;
+  }
+
   m_wholebodyPub.publish(wholeBodyMsg);
-  ros::Duration(0.1).sleep();
+
+  // queued chunks start while the robot is already moving, only the first one has a motion onset
+  const ros::Time now = ros::Time::now();
+  if (execution_mode == TrajectoryStreamer::OVERRIDE)
+  {
+    command_tracer_->recordPublish("whole_body_trajectory", wholeBodyMsg.unique_id, chunk.joint_names);
+    stream_end_ = now;
+  }
+  // a queued chunk starts when the previous one ends
+  const double delay = std::max(0.0, (stream_end_ - now).toSec());
+  const double duration = chunk.points.back().time_from_start.toSec();
+  trackCommand(wholeBodyMsg.unique_id, chunk.joint_names, chunk.points.back().positions, delay + duration,
+               execution_mode == TrajectoryStreamer::OVERRIDE);
+  stream_end_ = now + ros::Duration(delay + duration);
+  return wholeBodyMsg.unique_id;
 }
 
 void WholebodyControlInterface::initializeWholebodyMessage(ihmc_msgs::WholeBodyTrajectoryRosMessage& wholeBodyMsg)
 {
-  // Setting unique id non zero for messages to be used
-  wholeBodyMsg.unique_id = ros::Time::now().toSec();
+  // Setting unique id non zero for messages to be used, messages sent within the same second need different ids
+  wholeBodyMsg.unique_id = id_++;
 
   // setting default values for empty messages
   wholeBodyMsg.left_arm_trajectory_message.robot_side = LEFT;
@@ -87,100 +325,117 @@ void WholebodyControlInterface::initializeWholebodyMessage(ihmc_msgs::WholeBodyT
 void WholebodyControlInterface::parseTrajectory(const trajectory_msgs::JointTrajectory& traj,
                                                 ihmc_msgs::WholeBodyTrajectoryRosMessage& wholeBodyMsg)
 {
-  long chest_start = -1, l_arm_start = -1, r_arm_start = -1;
-
-  auto it = std::find(traj.joint_names.begin(), traj.joint_names.end(), chest_joint_names_.at(0));
-  if (it == traj.joint_names.end())
+  const JointLayoutPlanConstPtr plan = getJointLayoutPlan(traj.joint_names);
+  if (!plan->valid)
   {
-    // does not contain chest points
+    ROS_ERROR("Joints in the trajectory do not contain complete chest or arm chains.");
+    return;
   }
-  else
+
+  const size_t num_points = traj.points.size();
+  for (const auto& point : traj.points)
   {
-    // set the chest indices
-    chest_start = std::distance(traj.joint_names.begin(), it);
-    if (!validateJointSequenceInTrajectory(traj.joint_names, chest_joint_names_, chest_start))
+    if (point.positions.size() != traj.joint_names.size())
     {
+      ROS_ERROR("Trajectory points do not have a position for every joint.");
       return;
     }
-    chestController_.setupFrameAndMode(wholeBodyMsg.chest_trajectory_message);
   }
 
-  it = std::find(traj.joint_names.begin(), traj.joint_names.end(), left_arm_joint_names_.at(0));
-  if (it == traj.joint_names.end())
+  if (!plan->chest.empty())
   {
-    // does not contain left arm points
+    chestController_.setupFrameAndMode(wholeBodyMsg.chest_trajectory_message);
+    wholeBodyMsg.chest_trajectory_message.taskspace_trajectory_points.reserve(num_points);
   }
-  else
+  if (!plan->left_arm.empty())
   {
-    // set the left arm indices
-    l_arm_start = std::distance(traj.joint_names.begin(), it);
-    if (!validateJointSequenceInTrajectory(traj.joint_names, left_arm_joint_names_, l_arm_start))
+    armController_.setupArmMessage(RobotSide::LEFT, wholeBodyMsg.left_arm_trajectory_message);
+    for (auto& joint : wholeBodyMsg.left_arm_trajectory_message.joint_trajectory_messages)
     {
-      return;
+      joint.trajectory_points.reserve(num_points);
     }
-    armController_.setupArmMessage(RobotSide::LEFT, wholeBodyMsg.left_arm_trajectory_message);
-  }
-
-  it = std::find(traj.joint_names.begin(), traj.joint_names.end(), right_arm_joint_names_.at(0));
-  if (it == traj.joint_names.end())
-  {
-    // does not contain right arm points
   }
-  else
+  if (!plan->right_arm.empty())
   {
-    // set the right arm indices
-    r_arm_start = std::distance(traj.joint_names.begin(), it);
-    if (!validateJointSequenceInTrajectory(traj.joint_names, right_arm_joint_names_, r_arm_start))
+    armController_.setupArmMessage(RobotSide::RIGHT, wholeBodyMsg.right_arm_trajectory_message);
+    for (auto& joint : wholeBodyMsg.right_arm_trajectory_message.joint_trajectory_messages)
     {
-      return;
+      joint.trajectory_points.reserve(num_points);
     }
-    armController_.setupArmMessage(RobotSide::RIGHT, wholeBodyMsg.right_arm_trajectory_message);
   }
 
-  double traj_point_time = 0.0;
-  for (size_t i = 0; i < traj.points.size(); i++)
+  // positions of each arm are gathered into the same buffers for every point
+  std::vector<double> left_positions(plan->left_arm.size());
+  std::vector<double> right_positions(plan->right_arm.size());
+  for (const auto& point : traj.points)
   {
-    traj_point_time = traj.points.at(i).time_from_start.toSec();
+    const double traj_point_time = point.time_from_start.toSec();
 
-    // chest - move to a new function later
-    if (chest_start >= 0)
+    if (!plan->chest.empty())
     {
       geometry_msgs::Quaternion quat;
-      createChestQuaternion(chest_start, traj.points.at(i), quat);
+      createChestQuaternion(plan->chest, point, quat);
       chestController_.appendChestTrajectoryPoint(quat, wholeBodyMsg.chest_trajectory_message, traj_point_time);
     }
-    // arms
-    if (l_arm_start >= 0)
+    if (!plan->left_arm.empty())
     {
-      std::vector<double> positions;
-      positions.assign(traj.points.at(i).positions.begin() + l_arm_start,
-                       traj.points.at(i).positions.begin() + l_arm_start + left_arm_joint_names_.size());
-      armController_.appendTrajectoryPoint(wholeBodyMsg.left_arm_trajectory_message, traj_point_time, positions);
+      for (size_t j = 0; j < left_positions.size(); ++j)
+      {
+        left_positions[j] = point.positions[plan->left_arm[j]];
+      }
+      armController_.appendTrajectoryPoint(wholeBodyMsg.left_arm_trajectory_message, traj_point_time, left_positions);
     }
-
-    if (r_arm_start >= 0)
+    if (!plan->right_arm.empty())
     {
-      std::vector<double> positions;
-      positions.assign(traj.points.at(i).positions.begin() + r_arm_start,
-                       traj.points.at(i).positions.begin() + r_arm_start + right_arm_joint_names_.size());
-      armController_.appendTrajectoryPoint(wholeBodyMsg.right_arm_trajectory_message, traj_point_time, positions);
+      for (size_t j = 0; j < right_positions.size(); ++j)
+      {
+        right_positions[j] = point.positions[plan->right_arm[j]];
+      }
+      armController_.appendTrajectoryPoint(wholeBodyMsg.right_arm_trajectory_message, traj_point_time,
+                                           right_positions);
     }
   }
 }
 
-bool WholebodyControlInterface::validateJointSequenceInTrajectory(const std::vector<std::string>& traj_joint_names,
-                                                                  const std::vector<std::string>& joint_names,
-                                                                  long start)
+WholebodyControlInterface::JointLayoutPlanConstPtr
+WholebodyControlInterface::getJointLayoutPlan(const std::vector<std::string>& joint_names)
+{
+  // the stream thread parses chunks too, the plan is replaced atomically and never modified
+  JointLayoutPlanConstPtr plan = std::atomic_load(&layout_plan_);
+  if (plan && plan->joint_names == joint_names)
+  {
+    return plan;
+  }
+
+  std::shared_ptr<JointLayoutPlan> new_plan = std::make_shared<JointLayoutPlan>();
+  new_plan->joint_names = joint_names;
+  new_plan->valid = planJointColumns(joint_names, chest_joint_names_, new_plan->chest) &&
+                    planJointColumns(joint_names, left_arm_joint_names_, new_plan->left_arm) &&
+                    planJointColumns(joint_names, right_arm_joint_names_, new_plan->right_arm);
+  plan = new_plan;
+  std::atomic_store(&layout_plan_, plan);
+  return plan;
+}
+
+bool WholebodyControlInterface::planJointColumns(const std::vector<std::string>& traj_joint_names,
+                                                 const std::vector<std::string>& joint_names,
+                                                 std::vector<size_t>& columns) const
 {
-  for (auto joint_name_it = joint_names.begin(); joint_name_it != joint_names.end(); ++joint_name_it, ++start)
+  columns.clear();
+  for (const auto& joint_name : joint_names)
   {
-    if (traj_joint_names[start] != *joint_name_it)
+    auto it = std::find(traj_joint_names.begin(), traj_joint_names.end(), joint_name);
+    if (it != traj_joint_names.end())
     {
-      // joints in trajectory are not in the expected sequence.
-      ROS_ERROR("Joints in the trajectory are not in the expected sequence.");
-      return false;
+      columns.push_back(std::distance(traj_joint_names.begin(), it));
     }
   }
 
+  // a part is sent only with all of its joints, in any order in the trajectory
+  if (!columns.empty() && columns.size() != joint_names.size())
+  {
+    columns.clear();
+    return false;
+  }
   return true;
 }
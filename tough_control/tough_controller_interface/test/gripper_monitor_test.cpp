@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include "tough_controller_interface/gripper_monitor.h"
+
+namespace
+{
+const GripperMonitor::Thresholds THRESHOLDS;
+const double STILL = 0.0;
+const double FAST = 2 * THRESHOLDS.settled_velocity;
+const double NO_LOAD = 0.0;
+const double LOADED = 2 * THRESHOLDS.grasp_effort;
+
+GripperState classify(const GripperState state, const double closure, const double load, const double speed,
+                      const double grasp_closure = 0.5)
+{
+  return GripperMonitor::classify(state, grasp_closure, THRESHOLDS, closure, load, speed);
+}
+}  // namespace
+
+TEST(GripperMonitorTest, StillFingersAreOpenOrClosed)
+{
+  EXPECT_EQ(GripperState::OPEN, classify(GripperState::UNKNOWN, 0.0, NO_LOAD, STILL));
+  EXPECT_EQ(GripperState::OPEN, classify(GripperState::MOVING, THRESHOLDS.closed_position - 0.01, NO_LOAD, STILL));
+  EXPECT_EQ(GripperState::CLOSED_EMPTY, classify(GripperState::MOVING, THRESHOLDS.closed_position, NO_LOAD, STILL));
+}
+
+TEST(GripperMonitorTest, MovingFingersWithoutGraspAreMoving)
+{
+  EXPECT_EQ(GripperState::MOVING, classify(GripperState::OPEN, 0.3, NO_LOAD, FAST));
+  // a loaded finger that moves is not holding anything yet, e.g. it pushes an object
+  EXPECT_EQ(GripperState::MOVING, classify(GripperState::OPEN, 0.3, LOADED, FAST));
+}
+
+TEST(GripperMonitorTest, StillLoadedFingersAreGrasping)
+{
+  EXPECT_EQ(GripperState::GRASPED, classify(GripperState::MOVING, 0.5, LOADED, STILL));
+  EXPECT_EQ(GripperState::GRASPED, classify(GripperState::MOVING, THRESHOLDS.closed_position, LOADED, STILL));
+  EXPECT_EQ(GripperState::GRASPED, classify(GripperState::SLIPPING, 0.7, LOADED, STILL));
+}
+
+TEST(GripperMonitorTest, SqueezingKeepsTheGrasp)
+{
+  // fingers of a grasp move a little while they squeeze the object
+  const double closure = 0.5 + THRESHOLDS.slip_position / 2;
+  EXPECT_EQ(GripperState::GRASPED, classify(GripperState::GRASPED, closure, LOADED, FAST));
+  EXPECT_EQ(GripperState::SLIPPING, classify(GripperState::SLIPPING, closure, LOADED, FAST));
+  // without load they are moving
+  EXPECT_EQ(GripperState::MOVING, classify(GripperState::GRASPED, closure, NO_LOAD, FAST));
+}
+
+TEST(GripperMonitorTest, ClosingPastTheGraspIsSlipping)
+{
+  const double closure = 0.5 + 2 * THRESHOLDS.slip_position;
+  EXPECT_EQ(GripperState::SLIPPING, classify(GripperState::GRASPED, closure, LOADED, FAST));
+  EXPECT_EQ(GripperState::SLIPPING, classify(GripperState::GRASPED, closure, NO_LOAD, FAST));
+  // still fingers are not slipping, wherever they are
+  EXPECT_EQ(GripperState::GRASPED, classify(GripperState::GRASPED, closure, LOADED, STILL));
+  // the slip is measured from the closure of the grasp
+  EXPECT_EQ(GripperState::GRASPED, classify(GripperState::GRASPED, closure, LOADED, FAST, closure));
+}
+
+TEST(GripperMonitorTest, ThresholdsAreUsed)
+{
+  GripperMonitor::Thresholds thresholds;
+  thresholds.grasp_effort = 2 * LOADED;
+  thresholds.settled_velocity = 2 * FAST;
+  EXPECT_EQ(GripperState::OPEN, GripperMonitor::classify(GripperState::MOVING, 0.0, thresholds, 0.1, LOADED, FAST));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  ros::Time::init();
+  return RUN_ALL_TESTS();
+}
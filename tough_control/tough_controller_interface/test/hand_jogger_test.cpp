@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include "tough_controller_interface/hand_jogger.h"
+
+namespace
+{
+const double RATE = 50.0;
+const double HORIZON = 0.1;
+
+void sleepFor(const double seconds)
+{
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
+
+geometry_msgs::Twist makeTwist(const double linear_x, const double angular_z = 0.0)
+{
+  geometry_msgs::Twist twist;
+  twist.linear.x = linear_x;
+  twist.angular.z = angular_z;
+  return twist;
+}
+
+// a simulated hand that reaches every published setpoint immediately unless it is blocked
+class HandJoggerTest : public testing::Test
+{
+protected:
+  HandJoggerTest()
+    : available_(true)
+    , blocked_(false)
+    , published_(0)
+    , jogger_(std::bind(&HandJoggerTest::readHand, this, std::placeholders::_1),
+              std::bind(&HandJoggerTest::publishSetpoint, this, std::placeholders::_1, std::placeholders::_2,
+                        std::placeholders::_3),
+              RATE, HORIZON)
+  {
+    hand_.orientation.w = 1.0;
+  }
+
+  bool readHand(geometry_msgs::Pose& pose)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    pose = hand_;
+    return available_;
+  }
+
+  void publishSetpoint(const geometry_msgs::Pose& pose, const geometry_msgs::Twist& velocity, const double time)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    ++published_;
+    setpoint_ = pose;
+    velocity_ = velocity;
+    time_ = time;
+    if (!blocked_)
+    {
+      hand_ = pose;
+    }
+  }
+
+  int getPublished()
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return published_;
+  }
+
+  std::mutex mutex_;
+  geometry_msgs::Pose hand_;
+  bool available_;
+  bool blocked_;
+  int published_;
+  geometry_msgs::Pose setpoint_;
+  geometry_msgs::Twist velocity_;
+  double time_;
+  // declared last, it is stopped before the members used by its thread are destroyed
+  HandJogger jogger_;
+};
+}  // namespace
+
+TEST_F(HandJoggerTest, StartNeedsThePoseOfTheHand)
+{
+  available_ = false;
+  EXPECT_FALSE(jogger_.start());
+  EXPECT_FALSE(jogger_.isJogging());
+
+  available_ = true;
+  EXPECT_TRUE(jogger_.start());
+  EXPECT_TRUE(jogger_.isJogging());
+  jogger_.stop();
+  EXPECT_FALSE(jogger_.isJogging());
+}
+
+TEST_F(HandJoggerTest, NothingIsPublishedWithoutVelocity)
+{
+  ASSERT_TRUE(jogger_.start());
+  sleepFor(0.2);
+  EXPECT_EQ(0, getPublished());
+}
+
+TEST_F(HandJoggerTest, VelocityIsLimited)
+{
+  ASSERT_TRUE(jogger_.start());
+  const HandJogger::Limits limits = jogger_.getLimits();
+  jogger_.setVelocity(makeTwist(1.0, 5.0));
+
+  // the first setpoints are limited by the acceleration
+  sleepFor(0.1);
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    EXPECT_GT(published_, 0);
+    EXPECT_LT(velocity_.linear.x, limits.max_linear_speed);
+    EXPECT_DOUBLE_EQ(HORIZON, time_);
+  }
+
+  // then by the speed
+  sleepFor(0.5);
+  std::lock_guard<std::mutex> guard(mutex_);
+  EXPECT_NEAR(limits.max_linear_speed, velocity_.linear.x, 1e-9);
+  EXPECT_NEAR(limits.max_angular_speed, velocity_.angular.z, 1e-9);
+  EXPECT_GT(setpoint_.position.x, 0.0);
+  EXPECT_DOUBLE_EQ(0.0, setpoint_.position.y);
+}
+
+TEST_F(HandJoggerTest, SetpointDoesNotRunAwayFromABlockedHand)
+{
+  blocked_ = true;
+  ASSERT_TRUE(jogger_.start());
+  const HandJogger::Limits limits = jogger_.getLimits();
+  jogger_.setVelocity(makeTwist(limits.max_linear_speed));
+  sleepFor(0.8);
+
+  // the published target is the setpoint a horizon ahead
+  std::lock_guard<std::mutex> guard(mutex_);
+  EXPECT_LE(setpoint_.position.x - hand_.position.x, limits.max_linear_lead + limits.max_linear_speed * HORIZON + 1e-9);
+}
+
+TEST_F(HandJoggerTest, HandStopsWhenTheCommandTimesOut)
+{
+  HandJogger::Limits limits = jogger_.getLimits();
+  limits.command_timeout = 0.2;
+  jogger_.setLimits(limits);
+  ASSERT_TRUE(jogger_.start());
+  jogger_.setVelocity(makeTwist(0.1));
+  sleepFor(0.6);
+
+  // the hand decelerated to zero and nothing is sent while it is still
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    EXPECT_DOUBLE_EQ(0.0, velocity_.linear.x);
+  }
+  const int published = getPublished();
+  sleepFor(0.2);
+  EXPECT_EQ(published, getPublished());
+}
+
+TEST_F(HandJoggerTest, SetpointRestartsFromTheMeasuredHand)
+{
+  ASSERT_TRUE(jogger_.start());
+  // another command moved the hand while it was still
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    hand_.position.x = 2.0;
+  }
+  jogger_.setVelocity(makeTwist(0.1));
+  sleepFor(0.1);
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  EXPECT_GT(setpoint_.position.x, 2.0);
+  EXPECT_LT(setpoint_.position.x, 2.1);
+}
+
+TEST_F(HandJoggerTest, StopWhileMovingHoldsTheSetpoint)
+{
+  ASSERT_TRUE(jogger_.start());
+  jogger_.setVelocity(makeTwist(0.1));
+  sleepFor(0.2);
+  jogger_.stop();
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  EXPECT_DOUBLE_EQ(0.0, velocity_.linear.x);
+  EXPECT_GT(setpoint_.position.x, 0.0);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  ros::Time::init();
+  return RUN_ALL_TESTS();
+}
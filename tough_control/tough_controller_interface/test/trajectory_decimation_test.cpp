@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include <cmath>
+#include <functional>
+#include "tough_controller_interface/trajectory_decimation.h"
+
+namespace
+{
+const double TOLERANCE = 0.01;
+
+// waypoints of two joints following a path and its derivative, dt seconds apart
+trajectory_msgs::JointTrajectory makeTrajectory(const size_t num_points, const double dt,
+                                                const std::function<double(double)>& path,
+                                                const std::function<double(double)>& derivative)
+{
+  trajectory_msgs::JointTrajectory traj;
+  traj.joint_names = { "joint_a", "joint_b" };
+  for (size_t i = 0; i < num_points; ++i)
+  {
+    const double t = dt * (i + 1);
+    trajectory_msgs::JointTrajectoryPoint point;
+    point.positions = { path(t), -path(t) };
+    point.velocities = { derivative(t), -derivative(t) };
+    point.time_from_start = ros::Duration(t);
+    traj.points.push_back(point);
+  }
+  return traj;
+}
+
+// position of a joint at time t on the cubic Hermite segment between two waypoints
+double interpolate(const trajectory_msgs::JointTrajectoryPoint& start, const trajectory_msgs::JointTrajectoryPoint& end,
+                   const size_t joint, const double t)
+{
+  const double span = (end.time_from_start - start.time_from_start).toSec();
+  const double s = (t - start.time_from_start.toSec()) / span;
+  const double s2 = s * s, s3 = s2 * s;
+  return (2 * s3 - 3 * s2 + 1) * start.positions[joint] + (-2 * s3 + 3 * s2) * end.positions[joint] +
+         (s3 - 2 * s2 + s) * span * start.velocities[joint] + (s3 - s2) * span * end.velocities[joint];
+}
+
+bool isSamePoint(const trajectory_msgs::JointTrajectoryPoint& a, const trajectory_msgs::JointTrajectoryPoint& b)
+{
+  return a.positions == b.positions && a.velocities == b.velocities && a.time_from_start == b.time_from_start;
+}
+}  // namespace
+
+TEST(TrajectoryDecimationTest, ShortTrajectoriesAreCopied)
+{
+  trajectory_msgs::JointTrajectory traj =
+      makeTrajectory(2, 0.1, [](double t) { return t; }, [](double) { return 1.0; });
+  trajectory_msgs::JointTrajectory result;
+  EXPECT_EQ(0u, decimateTrajectory(traj, TOLERANCE, result));
+  EXPECT_EQ(traj.joint_names, result.joint_names);
+  ASSERT_EQ(2u, result.points.size());
+}
+
+TEST(TrajectoryDecimationTest, MismatchedPositionsAreCopied)
+{
+  trajectory_msgs::JointTrajectory traj =
+      makeTrajectory(10, 0.1, [](double t) { return t; }, [](double) { return 1.0; });
+  traj.points[4].positions.pop_back();
+  trajectory_msgs::JointTrajectory result;
+  EXPECT_EQ(0u, decimateTrajectory(traj, TOLERANCE, result));
+  EXPECT_EQ(10u, result.points.size());
+}
+
+TEST(TrajectoryDecimationTest, CubicPathKeepsEndpoints)
+{
+  // the Hermite segment between the endpoints is the cubic itself
+  trajectory_msgs::JointTrajectory traj = makeTrajectory(
+      50, 0.02, [](double t) { return t * t * t - t; }, [](double t) { return 3 * t * t - 1; });
+  trajectory_msgs::JointTrajectory result;
+  EXPECT_EQ(48u, decimateTrajectory(traj, TOLERANCE, result));
+  ASSERT_EQ(2u, result.points.size());
+  EXPECT_TRUE(isSamePoint(traj.points.front(), result.points.front()));
+  EXPECT_TRUE(isSamePoint(traj.points.back(), result.points.back()));
+}
+
+TEST(TrajectoryDecimationTest, RemovedWaypointsAreWithinTolerance)
+{
+  trajectory_msgs::JointTrajectory traj =
+      makeTrajectory(200, 0.01, [](double t) { return std::sin(4 * t); }, [](double t) { return 4 * std::cos(4 * t); });
+  trajectory_msgs::JointTrajectory result;
+  const size_t removed = decimateTrajectory(traj, TOLERANCE, result);
+  EXPECT_GT(removed, 0u);
+  ASSERT_EQ(traj.points.size(), result.points.size() + removed);
+
+  // every original waypoint is either kept unchanged or close to the segment between the kept waypoints around it
+  size_t segment = 0;
+  for (const trajectory_msgs::JointTrajectoryPoint& point : traj.points)
+  {
+    while (result.points[segment + 1].time_from_start < point.time_from_start)
+    {
+      ++segment;
+    }
+    const trajectory_msgs::JointTrajectoryPoint& start = result.points[segment];
+    const trajectory_msgs::JointTrajectoryPoint& end = result.points[segment + 1];
+    if (point.time_from_start == start.time_from_start || point.time_from_start == end.time_from_start)
+    {
+      EXPECT_TRUE(isSamePoint(point, point.time_from_start == start.time_from_start ? start : end));
+      continue;
+    }
+    for (size_t j = 0; j < point.positions.size(); ++j)
+    {
+      EXPECT_NEAR(point.positions[j], interpolate(start, end, j, point.time_from_start.toSec()), TOLERANCE);
+    }
+  }
+}
+
+TEST(TrajectoryDecimationTest, UntimedTrajectoryIsInterpolatedByIndex)
+{
+  // without time_from_start the velocities can not be used, a ramp is a line in waypoint index
+  trajectory_msgs::JointTrajectory traj =
+      makeTrajectory(20, 0.1, [](double t) { return t; }, [](double) { return 1.0; });
+  for (trajectory_msgs::JointTrajectoryPoint& point : traj.points)
+  {
+    point.time_from_start = ros::Duration(0.0);
+  }
+  trajectory_msgs::JointTrajectory result;
+  EXPECT_EQ(18u, decimateTrajectory(traj, TOLERANCE, result));
+
+  // the corner of a joint that turns back is kept
+  for (size_t i = 11; i < traj.points.size(); ++i)
+  {
+    traj.points[i].positions[0] = 2 * traj.points[10].positions[0] - traj.points[i].positions[0];
+  }
+  EXPECT_EQ(17u, decimateTrajectory(traj, TOLERANCE, result));
+  ASSERT_EQ(3u, result.points.size());
+  EXPECT_TRUE(isSamePoint(traj.points[10], result.points[1]));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  ros::Time::init();
+  return RUN_ALL_TESTS();
+}
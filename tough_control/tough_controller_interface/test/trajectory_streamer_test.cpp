@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "tough_controller_interface/trajectory_streamer.h"
+
+namespace
+{
+// scheduling slack of the stream thread, it checks the time every 10ms
+const double TIMING_TOLERANCE = 0.05;
+
+struct PublishedChunk
+{
+  trajectory_msgs::JointTrajectory chunk;
+  int execution_mode;
+  long previous_message_id;
+  long message_id;
+  ros::Time stamp;
+};
+
+// records the chunks and returns increasing message ids, or 0 once fail_after chunks were published
+class ChunkRecorder
+{
+public:
+  explicit ChunkRecorder(const size_t fail_after = 0) : fail_after_(fail_after), next_id_(100)
+  {
+  }
+
+  long publish(const trajectory_msgs::JointTrajectory& chunk, const int execution_mode, const long previous_message_id)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (fail_after_ > 0 && chunks_.size() >= fail_after_)
+    {
+      return 0;
+    }
+    chunks_.push_back({ chunk, execution_mode, previous_message_id, next_id_++, ros::Time::now() });
+    return chunks_.back().message_id;
+  }
+
+  std::vector<PublishedChunk> getChunks() const
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return chunks_;
+  }
+
+private:
+  size_t fail_after_;
+  long next_id_;
+  std::vector<PublishedChunk> chunks_;
+  mutable std::mutex mutex_;
+};
+
+// one joint, points every 0.1 seconds
+trajectory_msgs::JointTrajectory makeTrajectory(const size_t num_points)
+{
+  trajectory_msgs::JointTrajectory traj;
+  traj.joint_names = { "joint" };
+  for (size_t i = 0; i < num_points; ++i)
+  {
+    trajectory_msgs::JointTrajectoryPoint point;
+    point.positions = { static_cast<double>(i) };
+    point.time_from_start = ros::Duration(0.1 * (i + 1));
+    traj.points.push_back(point);
+  }
+  return traj;
+}
+
+void waitForStream(const TrajectoryStreamer& streamer, const double timeout)
+{
+  const ros::WallTime deadline = ros::WallTime::now() + ros::WallDuration(timeout);
+  while (streamer.isStreaming() && ros::WallTime::now() < deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+}
+
+TrajectoryStreamer::ChunkPublisher bindRecorder(ChunkRecorder& recorder)
+{
+  return std::bind(&ChunkRecorder::publish, &recorder, std::placeholders::_1, std::placeholders::_2,
+                   std::placeholders::_3);
+}
+}  // namespace
+
+TEST(TrajectoryStreamerTest, RejectsEmptyTrajectory)
+{
+  ChunkRecorder recorder;
+  TrajectoryStreamer streamer(bindRecorder(recorder));
+  EXPECT_FALSE(streamer.start(makeTrajectory(0), 3));
+  EXPECT_FALSE(streamer.start(makeTrajectory(5), 0));
+  EXPECT_TRUE(recorder.getChunks().empty());
+}
+
+TEST(TrajectoryStreamerTest, ChunksAreChainedAndTimedRelativeToThePreviousChunk)
+{
+  ChunkRecorder recorder;
+  TrajectoryStreamer streamer(bindRecorder(recorder));
+  const double lookahead = 0.1;
+  const ros::Time start_time = ros::Time::now();
+  ASSERT_TRUE(streamer.start(makeTrajectory(10), 3, lookahead));
+
+  // the first chunk is published before start returns
+  ASSERT_EQ(1u, recorder.getChunks().size());
+  waitForStream(streamer, 5.0);
+  EXPECT_FALSE(streamer.isStreaming());
+
+  const std::vector<PublishedChunk> chunks = recorder.getChunks();
+  ASSERT_EQ(4u, chunks.size());
+  EXPECT_EQ(TrajectoryStreamer::OVERRIDE, chunks[0].execution_mode);
+  EXPECT_EQ(0, chunks[0].previous_message_id);
+  const size_t sizes[4] = { 3, 3, 3, 1 };
+  for (size_t i = 0; i < chunks.size(); ++i)
+  {
+    ASSERT_EQ(sizes[i], chunks[i].chunk.points.size());
+    EXPECT_EQ("joint", chunks[i].chunk.joint_names.front());
+    EXPECT_DOUBLE_EQ(3.0 * i, chunks[i].chunk.points.front().positions.front());
+    // times of every chunk start from the end of the previous one
+    for (size_t j = 0; j < sizes[i]; ++j)
+    {
+      EXPECT_NEAR(0.1 * (j + 1), chunks[i].chunk.points[j].time_from_start.toSec(), 1e-9);
+    }
+    if (i == 0)
+    {
+      continue;
+    }
+    EXPECT_EQ(TrajectoryStreamer::QUEUE, chunks[i].execution_mode);
+    EXPECT_EQ(chunks[i - 1].message_id, chunks[i].previous_message_id);
+
+    // published lookahead seconds before the previous chunk ends
+    const double due = 0.3 * i - lookahead;
+    const double published = (chunks[i].stamp - start_time).toSec();
+    EXPECT_GE(published, due);
+    EXPECT_LT(published, due + TIMING_TOLERANCE);
+  }
+}
+
+TEST(TrajectoryStreamerTest, CancelDropsRemainingChunks)
+{
+  ChunkRecorder recorder;
+  TrajectoryStreamer streamer(bindRecorder(recorder));
+  ASSERT_TRUE(streamer.start(makeTrajectory(10), 3, 0.0));
+  EXPECT_TRUE(streamer.isStreaming());
+
+  // the second chunk is due after 0.3 seconds
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  streamer.cancel();
+  EXPECT_FALSE(streamer.isStreaming());
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_EQ(1u, recorder.getChunks().size());
+}
+
+TEST(TrajectoryStreamerTest, CancelFromSeveralThreads)
+{
+  ChunkRecorder recorder;
+  TrajectoryStreamer streamer(bindRecorder(recorder));
+  ASSERT_TRUE(streamer.start(makeTrajectory(10), 3, 0.0));
+
+  // e.g. a sensor callback stops the arm while the user sends a new command
+  std::thread other(&TrajectoryStreamer::cancel, &streamer);
+  streamer.cancel();
+  other.join();
+  EXPECT_FALSE(streamer.isStreaming());
+  EXPECT_EQ(1u, recorder.getChunks().size());
+}
+
+TEST(TrajectoryStreamerTest, RestartReplacesRunningStream)
+{
+  ChunkRecorder recorder;
+  TrajectoryStreamer streamer(bindRecorder(recorder));
+  ASSERT_TRUE(streamer.start(makeTrajectory(10), 3, 0.0));
+  ASSERT_TRUE(streamer.start(makeTrajectory(4), 2, 0.1));
+  waitForStream(streamer, 5.0);
+
+  // the second stream starts over with an override, the first one is not continued
+  const std::vector<PublishedChunk> chunks = recorder.getChunks();
+  ASSERT_EQ(3u, chunks.size());
+  EXPECT_EQ(TrajectoryStreamer::OVERRIDE, chunks[1].execution_mode);
+  EXPECT_EQ(TrajectoryStreamer::QUEUE, chunks[2].execution_mode);
+  EXPECT_EQ(chunks[1].message_id, chunks[2].previous_message_id);
+}
+
+TEST(TrajectoryStreamerTest, PublishFailureStopsStream)
+{
+  ChunkRecorder recorder(2);
+  TrajectoryStreamer streamer(bindRecorder(recorder));
+  ASSERT_TRUE(streamer.start(makeTrajectory(10), 3, 0.3));
+  waitForStream(streamer, 5.0);
+  EXPECT_FALSE(streamer.isStreaming());
+  EXPECT_EQ(2u, recorder.getChunks().size());
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  // the stream stops when ros::ok() is false, the node has to be started
+  ros::init(argc, argv, "trajectory_streamer_test");
+  ros::NodeHandle nh;
+  return RUN_ALL_TESTS();
+}
@@ -20,6 +20,7 @@
 
 // standard libraries
 #include <mutex>
+#include <set>
 
 // rviz
 #include "rviz/visualization_manager.h"
@@ -103,9 +104,12 @@ private:
   void getGripperState();
   void getCoMPosition();
   void getClickedPoint(const geometry_msgs::PointStamped::Ptr msg);
+  bool getJogVelocity(const int key, geometry_msgs::Twist& velocity);
+  geometry_msgs::Twist getHeldJogVelocity();
 
 private Q_SLOTS:
   void keyPressEvent(QKeyEvent* event);
+  void keyReleaseEvent(QKeyEvent* event);
 
   void setCurrentTool(int btnID);
   void updateDisplay(int tabID);
@@ -217,6 +221,9 @@ private:
   RobotStateInformer* currentState_;
   geometry_msgs::Pose* clickedPoint_;
   bool moveArmCommand_;
+  // jog keys that are held down and the hand they jog, chosen when the first key is pressed
+  std::set<int> pressedJogKeys_;
+  RobotSide jogSide_;
 
   std::mutex mtx_;
   std::map<std::string, QLabel*> jointLabelMap_;
@@ -252,6 +259,7 @@ private:
 
   bool flipImage_;
   QLabel* status_label_;
+  QLabel* gripper_state_label_;
   enum ARM_JOINTS
   {
     SHOULDER_PITCH = 0,
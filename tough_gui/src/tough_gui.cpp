@@ -52,6 +52,7 @@ ToughGUI::~ToughGUI()
   delete manager_;
   delete renderPanel_;
   delete status_label_;
+  delete gripper_state_label_;
   delete chestController_;
   delete pelvisHeightController_;
   delete armJointController_;
@@ -184,6 +185,8 @@ void ToughGUI::initActionsConnections()
    */
   status_label_ = new QLabel("");
   statusBar()->addPermanentWidget(status_label_, 1);
+  gripper_state_label_ = new QLabel("");
+  statusBar()->addPermanentWidget(gripper_state_label_);
   connect(manager_, SIGNAL(statusUpdate(const QString&)), status_label_, SLOT(setText(const QString&)));
 
   /**
@@ -625,6 +628,11 @@ void ToughGUI::getNeckState()
 
 void ToughGUI::getGripperState()
 {
+  QString text;
+  text.sprintf("Left gripper: %s  Right gripper: %s",
+               GripperMonitor::getStateName(gripperController_->getGripperState(LEFT)).c_str(),
+               GripperMonitor::getStateName(gripperController_->getGripperState(RIGHT)).c_str());
+  gripper_state_label_->setText(text);
 }
 
 void ToughGUI::getCoMPosition()
@@ -866,9 +874,91 @@ void ToughGUI::keyPressEvent(QKeyEvent* event)
       ROS_INFO("key S pressed");
       break;
     default:
-      QWidget::keyPressEvent(event);
+    {
+      // arrow and page keys jog the hand selected for nudging while they are held, held keys add up
+      geometry_msgs::Twist velocity;
+      if (!getJogVelocity(event->key(), velocity))
+      {
+        QWidget::keyPressEvent(event);
+        break;
+      }
+      if (pressedJogKeys_.empty())
+      {
+        jogSide_ = ui->radioNudgeSideLeft->isChecked() ? LEFT : RIGHT;
+      }
+      pressedJogKeys_.insert(event->key());
+      // the jog is started again after a timeout, it does nothing while jogging
+      armJointController_->startHandJog(jogSide_);
+      armJointController_->jogHand(jogSide_, getHeldJogVelocity());
       break;
+    }
+  }
+}
+
+void ToughGUI::keyReleaseEvent(QKeyEvent* event)
+{
+  geometry_msgs::Twist velocity;
+  if (event->isAutoRepeat() || !getJogVelocity(event->key(), velocity))
+  {
+    QWidget::keyReleaseEvent(event);
+    return;
+  }
+  if (pressedJogKeys_.erase(event->key()) == 0)
+  {
+    return;
+  }
+  if (!pressedJogKeys_.empty())
+  {
+    armJointController_->jogHand(jogSide_, getHeldJogVelocity());
+    return;
+  }
+  // the hand is sent to its setpoint and the loop does not keep running after the last key is released
+  armJointController_->stopHandJog(jogSide_);
+}
+
+geometry_msgs::Twist ToughGUI::getHeldJogVelocity()
+{
+  geometry_msgs::Twist held;
+  for (int key : pressedJogKeys_)
+  {
+    geometry_msgs::Twist velocity;
+    getJogVelocity(key, velocity);
+    held.linear.x += velocity.linear.x;
+    held.linear.y += velocity.linear.y;
+    held.linear.z += velocity.linear.z;
+  }
+  return held;
+}
+
+bool ToughGUI::getJogVelocity(const int key, geometry_msgs::Twist& velocity)
+{
+  // in the pelvis frame of the jog setpoints. Unlike the nudge buttons (pelvis ZUP) it tilts with the pelvis.
+  const double JOG_SPEED = 0.1;
+  velocity = geometry_msgs::Twist();
+  switch (key)
+  {
+    case Qt::Key_Up:
+      velocity.linear.x = JOG_SPEED;
+      break;
+    case Qt::Key_Down:
+      velocity.linear.x = -JOG_SPEED;
+      break;
+    case Qt::Key_Left:
+      velocity.linear.y = JOG_SPEED;
+      break;
+    case Qt::Key_Right:
+      velocity.linear.y = -JOG_SPEED;
+      break;
+    case Qt::Key_PageUp:
+      velocity.linear.z = JOG_SPEED;
+      break;
+    case Qt::Key_PageDown:
+      velocity.linear.z = -JOG_SPEED;
+      break;
+    default:
+      return false;
   }
+  return true;
 }
 
 void ToughGUI::liveVideoCallback(const sensor_msgs::ImageConstPtr& msg)
@@ -227,6 +227,13 @@ bool TaskspacePlanner::updateKDLChains()
     { "", rd_->getLeftEEFrame() }
   };
 
+  // pelvis to palm chains include the chest joints. Robots without traits use the joint counts of the description
+  const RobotConstants constants = getRobotConstants(rd_->getRobotType());
+  const size_t num_arm_chain_joints =
+      constants.is_known ? constants.num_chest_joints + constants.num_arm_joints :
+                           rd_->getJointChainNames(JointChain::CHEST).size() +
+                               rd_->getJointChainNames(JointChain::RIGHT_ARM).size();
+
   bool valid;
   for (size_t i = 0; i < planning_groups_.size(); i++)
   {
@@ -240,7 +247,7 @@ bool TaskspacePlanner::updateKDLChains()
     // get the KDL chain for current planning group and set its upper and lower joint limits
     KDL::Chain* chain = new KDL::Chain();
     valid = ik_solvers_[planning_group]->getKDLChain(*chain);
-    if (chain->getNrOfJoints() == 10)
+    if (chain->getNrOfJoints() == num_arm_chain_joints)
     {
       // i = 0 and i = 2 are 10 DOF chains. (i + 1) are 7 DOF chains of the same side as i. In the following line we set
       // base_frame_EE_pair.at(i + 1).first as the 3rd element in 10 DOF chain to get the 7 DOF chain. This is required
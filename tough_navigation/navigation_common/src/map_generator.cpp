@@ -89,23 +89,32 @@ MapGenerator::~MapGenerator()
 
 void MapGenerator::resetMap(const std_msgs::Empty& msg)
 {
-  std::fill(occGrid_.data.begin(), occGrid_.data.end(), OCCUPIED);
-  visitedOccGrid_ = occGrid_;
-
-  mtx.lock();
+  std::vector<geometry_msgs::Point> points;
   for (float x = -0.5f; x < 0.5f; x += MAP_RESOLUTION / 10)
   {
     for (float y = -0.5f; y < 0.5f; y += MAP_RESOLUTION / 10)
     {
-      geometry_msgs::Pose pelvisPose;
-      pelvisPose.position.x = x;
-      pelvisPose.position.y = y;
-      pelvisPose.orientation.w = 1.0f;
-      currentState_->transformPose(pelvisPose, pelvisPose, rd_->getPelvisFrame(), TOUGH_COMMON_NAMES::WORLD_TF);
-      occGrid_.data.at(getIndex(pelvisPose.position.x, pelvisPose.position.y)) = FREE;
-      visitedOccGrid_.data.at(getIndex(pelvisPose.position.x, pelvisPose.position.y)) = FREE;
+      geometry_msgs::Point point;
+      point.x = x;
+      point.y = y;
+      points.push_back(point);
     }
   }
+  // all the points are in the same frame, look up the transform only once
+  if (!currentState_->transformPoints(points, points, rd_->getPelvisFrame(), TOUGH_COMMON_NAMES::WORLD_TF))
+  {
+    ROS_WARN("Pose of the robot is not available, map is not reset");
+    return;
+  }
+
+  std::fill(occGrid_.data.begin(), occGrid_.data.end(), OCCUPIED);
+  visitedOccGrid_ = occGrid_;
+  mtx.lock();
+  for (const auto& point : points)
+  {
+    occGrid_.data.at(getIndex(point.x, point.y)) = FREE;
+    visitedOccGrid_.data.at(getIndex(point.x, point.y)) = FREE;
+  }
   mtx.unlock();
   pointsToBlock_.data.clear();
   mapPub_.publish(occGrid_);
@@ -114,19 +123,28 @@ void MapGenerator::resetMap(const std_msgs::Empty& msg)
 
 void MapGenerator::clearCurrentPoseCB(const std_msgs::Empty& msg)
 {
-  mtx.lock();
+  std::vector<geometry_msgs::Point> offsets, points;
   for (float x = -0.2f; x < 0.2f; x += MAP_RESOLUTION / 10)
   {
     for (float y = -0.2f; y < 0.2f; y += MAP_RESOLUTION / 10)
     {
-      geometry_msgs::Pose pelvisPose;
-      pelvisPose.position.x = x;
-      pelvisPose.position.y = y;
-      pelvisPose.orientation.w = 1.0f;
-      currentState_->transformPose(pelvisPose, pelvisPose, rd_->getPelvisFrame(), TOUGH_COMMON_NAMES::WORLD_TF);
-      occGrid_.data.at(getIndex(pelvisPose.position.x + x, pelvisPose.position.y + y)) = FREE;
+      geometry_msgs::Point point;
+      point.x = x;
+      point.y = y;
+      offsets.push_back(point);
     }
   }
+  if (!currentState_->transformPoints(offsets, points, rd_->getPelvisFrame(), TOUGH_COMMON_NAMES::WORLD_TF))
+  {
+    ROS_WARN("Pose of the robot is not available, current pose is not cleared");
+    return;
+  }
+
+  mtx.lock();
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    occGrid_.data.at(getIndex(points[i].x + offsets[i].x, points[i].y + offsets[i].y)) = FREE;
+  }
   mtx.unlock();
   mapPub_.publish(occGrid_);
 }
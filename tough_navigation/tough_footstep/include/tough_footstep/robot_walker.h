@@ -19,6 +19,9 @@
 #include <tough_common/robot_state.h>
 #include "tough_common/robot_description.h"
 #include "tough_common/tough_common_names.h"
+#include "tough_common/command_tracer.h"
+#include <atomic>
+#include <mutex>
 
 /**
  * @brief The RobotWalker class This class handles all the locomotion commands to the robot.
@@ -26,7 +29,7 @@
 class RobotWalker
 {
 public:
-  static int id;
+  static std::atomic<int> id;
 
   /**
    * @brief RobotWalker::RobotWalker This class handles all the locomotion commands.
@@ -268,7 +271,10 @@ private:
   const float FOOT_SEPARATION = 0.33;                      // it should be moved to robot description
   const float FOOT_ROT_ERR_THRESHOLD = 5 * M_PI / 180.0f;  // 5 degrees
   double transfer_time_, swing_time_, swing_height_;
-  int execution_mode_, step_counter_, step_status_;
+  int execution_mode_, step_status_;
+  // updated by the footstep status callback and read by waitForSteps
+  std::atomic<int> step_counter_;
+  std::mutex cb_time_mutex_;
 
   ros::NodeHandle nh_;
   ros::Time cbTime_;
@@ -276,8 +282,11 @@ private:
   ros::Subscriber footstep_status_;
   ros::ServiceClient footstep_client_;
   std_msgs::String right_foot_frame_, left_foot_frame_;
+  // unique id of the last footstep list sent, the next started step acknowledges it
+  std::atomic<long> last_list_id_{ 0 };
 
   void footstepStatusCB(const ihmc_msgs::FootstepStatusRosMessage& msg);
+  void publishFootstepList(const ihmc_msgs::FootstepDataListRosMessage& list);
   void waitForSteps(const int numSteps);
 
   // /**
@@ -298,6 +307,7 @@ private:
     msg.execution_mode = execution_mode_;
 
     msg.unique_id = RobotWalker::id++;
+    CommandTracer::getCommandTracer()->recordConstruction("footsteps", msg.unique_id);
   }
 
   inline void initializeFootTrajectoryRosMessage(RobotSide side, ihmc_msgs::FootTrajectoryRosMessage& foot)
@@ -3,10 +3,10 @@
 #include <iostream>
 #include <ros/ros.h>
 
-int RobotWalker::id = 1;
+std::atomic<int> RobotWalker::id(1);
 
 RobotWalker::RobotWalker(ros::NodeHandle nh, double InTransferTime, double InSwingTime, int InMode, double swingHeight)
-  : nh_(nh)
+  : step_counter_(0), nh_(nh)
 {
   using namespace TOUGH_COMMON_NAMES;
   current_state_ = RobotStateInformer::getRobotStateInformer(nh_);
@@ -32,7 +32,6 @@ RobotWalker::RobotWalker(ros::NodeHandle nh, double InTransferTime, double InSwi
   swing_height_ = swingHeight;
 
   ros::Duration(0.5).sleep();
-  step_counter_ = 0;
 
   right_foot_frame_.data = rd_->getRightFootFrameName();
   left_foot_frame_.data = rd_->getLeftFootFrameName();
@@ -40,6 +39,7 @@ RobotWalker::RobotWalker(ros::NodeHandle nh, double InTransferTime, double InSwi
   /* This timer is used for waiting till the steps are executed. When the robot starts walking, the timer is reset and
    * at every step it resets. If the timer crosses 5 seconds without any steps, there could be some hardware error.
    */
+  std::lock_guard<std::mutex> guard(cb_time_mutex_);
   cbTime_ = ros::Time::now();
 }
 
@@ -60,11 +60,26 @@ void RobotWalker::footstepStatusCB(const ihmc_msgs::FootstepStatusRosMessage& ms
   {
     step_counter_++;
   }
+  else if (msg.status == ihmc_msgs::FootstepStatusRosMessage::STARTED)
+  {
+    CommandTracer::getCommandTracer()->recordAcknowledgement("footsteps", last_list_id_);
+  }
 
   // reset the timer
-  cbTime_ = ros::Time::now();
+  {
+    std::lock_guard<std::mutex> guard(cb_time_mutex_);
+    cbTime_ = ros::Time::now();
+  }
 
-  return;
+  // wake up waitForSteps
+  current_state_->notifyStateUpdate();
+}
+
+void RobotWalker::publishFootstepList(const ihmc_msgs::FootstepDataListRosMessage& list)
+{
+  last_list_id_ = list.unique_id;
+  this->footsteps_pub_.publish(list);
+  CommandTracer::getCommandTracer()->recordPublish("footsteps", list.unique_id);
 }
 
 // calls the footstep planner to plan path and walks to a 2D goal.
@@ -74,12 +89,11 @@ bool RobotWalker::walkToGoal(const geometry_msgs::Pose2D& goal, bool waitForStep
   initializeFootstepDataListRosMessage(list);
   if (this->getFootstep(goal, list))
   {
-    this->footsteps_pub_.publish(list);
+    publishFootstepList(list);
     RobotWalker::id++;
 
     if (waitForSteps)
     {
-      cbTime_ = ros::Time::now();
       this->waitForSteps(list.footstep_data_list.size());
     }
     return true;
@@ -94,12 +108,11 @@ void RobotWalker::stepAtPose(const geometry_msgs::Pose& goal, const RobotSide si
   initializeFootstepDataListRosMessage(list);
   list.footstep_data_list.push_back(*getOffsetStep(side, goal));
 
-  this->footsteps_pub_.publish(list);
+  publishFootstepList(list);
   RobotWalker::id++;
 
   if (waitForSteps)
   {
-    cbTime_ = ros::Time::now();
     this->waitForSteps(list.footstep_data_list.size());
   }
   return;
@@ -214,11 +227,10 @@ bool RobotWalker::walkLocalPreComputedSteps(const std::vector<float>& xOffset, c
 
 bool RobotWalker::walkGivenSteps(const ihmc_msgs::FootstepDataListRosMessage& list, const bool waitForSteps)
 {
-  this->footsteps_pub_.publish(list);
+  publishFootstepList(list);
   RobotWalker::id++;
   if (waitForSteps)
   {
-    cbTime_ = ros::Time::now();
     this->waitForSteps(list.footstep_data_list.size());
   }
   return true;
@@ -583,17 +595,23 @@ bool RobotWalker::climbStair(const std::vector<float>& xOffset, const std::vecto
 // wait till all the steps are taken
 void RobotWalker::waitForSteps(const int numSteps)
 {
-  while (step_counter_ < numSteps && ros::ok())
+  // wakes up as soon as the footstep status arrives instead of polling. The wait stops if no status is received for 5
+  // seconds. This is the case when the robot stopped walking due to external conditions(it fell down, there's an
+  // obstacle, etc)
   {
-    ros::spinOnce();
-    if ((ros::Time::now() - cbTime_) > ros::Duration(5))
-    {
-      // This is the case when the robot stopped walking due to external conditions(it fell down, there's an obstacle,
-      // etc)
-      break;
-    }
-    ros::Duration(0.1).sleep();
+    std::lock_guard<std::mutex> guard(cb_time_mutex_);
+    cbTime_ = ros::Time::now();
   }
+  current_state_->waitForCondition(
+      [this, numSteps]() {
+        if (step_counter_ >= numSteps)
+        {
+          return true;
+        }
+        std::lock_guard<std::mutex> guard(cb_time_mutex_);
+        return (ros::Time::now() - cbTime_) > ros::Duration(5);
+      },
+      ros::DURATION_MAX);
 
   // reset back the step counter
   step_counter_ = 0;
@@ -9,6 +9,7 @@
 #include <tf/tf.h>
 #include <geometry_msgs/PoseStamped.h>
 #include <mutex>
+#include <condition_variable>
 
 namespace tough_perception
 {
@@ -24,6 +25,8 @@ private:
     std::vector<fiducial_msgs::FiducialTransform> detected_markers;
 
     std::mutex marker_mutex;
+    std::condition_variable marker_condition;
+    unsigned long marker_update_count = 0;
 
     void fiducialCallback(const fiducial_msgs::FiducialTransformArrayConstPtr msg);
     geometry_msgs::PoseStampedPtr createPoseMessages(fiducial_msgs::FiducialTransform &object_);
@@ -12,14 +12,17 @@ broadcastTF(false)
 
 void ArucoDetector::fiducialCallback(const fiducial_msgs::FiducialTransformArrayConstPtr msg)
 {
-    std::lock_guard<std::mutex> lock(marker_mutex);
-    detected_markers.clear();
+    {
+        std::lock_guard<std::mutex> lock(marker_mutex);
+        detected_markers.clear();
 
-    for (auto msg_: msg->transforms)
-    {   
-        detected_markers.push_back(msg_);
+        for (auto msg_: msg->transforms)
+        {   
+            detected_markers.push_back(msg_);
+        }
+        marker_update_count++;
     }
-
+    marker_condition.notify_all();
 }
 
 geometry_msgs::PoseStampedPtr 
@@ -54,10 +57,20 @@ void ArucoDetector::setTopic(std::string topic)
 
 void ArucoDetector::getDetectedObjects(std::map<std::string, geometry_msgs::PoseStampedPtr> &detected_objects)
 {
-    ros::spinOnce();
-    ros::Duration(1).sleep();
+    // wait upto 1 second for the next detection, returns as soon as it arrives
+    ros::Time deadline = ros::Time::now() + ros::Duration(1);
+    std::unique_lock<std::mutex> lock(marker_mutex);
+    unsigned long update_count = marker_update_count;
+    while (marker_update_count == update_count && ros::Time::now() < deadline && ros::ok())
+    {
+        // callbacks are processed here when the node does not have a spinner thread
+        lock.unlock();
+        ros::spinOnce();
+        lock.lock();
+        marker_condition.wait_for(lock, std::chrono::milliseconds(10),
+                                  [&]() { return marker_update_count != update_count; });
+    }
 
-    std::lock_guard<std::mutex> lock(marker_mutex);
     for (auto marker_:detected_markers)
     {
         detected_objects[std::to_string(marker_.fiducial_id)] = createPoseMessages(marker_);